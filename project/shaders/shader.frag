@@ -29,8 +29,10 @@ void main()
 
     //outAlbedoAO = vec4(albedoColor, aoValue);
     outAlbedo = vec4(albedoColor,1);
-    vec3 tangentSpaceNormal = texture(sampler2D(textures[nonuniformEXT(pushConstants.normalMapIndex)], texSampler), fragTexCoord).rgb;
-    tangentSpaceNormal = tangentSpaceNormal * 2.0 - 1.0;
+    // Only xy is read so BC5 normal maps (no blue channel) and uncompressed ones decode the same way
+    vec3 tangentSpaceNormal;
+    tangentSpaceNormal.xy = texture(sampler2D(textures[nonuniformEXT(pushConstants.normalMapIndex)], texSampler), fragTexCoord).rg * 2.0 - 1.0;
+    tangentSpaceNormal.z = sqrt(max(1.0 - dot(tangentSpaceNormal.xy, tangentSpaceNormal.xy), 0.0));
     vec3 worldSpaceNormal = normalize(fragTBN * tangentSpaceNormal);
 
     outNormal = normalize(vec4(worldSpaceNormal * 0.5 + 0.5, 1.0));
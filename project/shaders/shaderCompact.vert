@@ -0,0 +1,53 @@
+#version 450
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 modelMatrix;
+    uint albedoMapIndex;
+    uint aoMapIndex;
+    uint normalMapIndex;
+    uint metallicRoughnessMapIndex; 
+
+} pushConstants;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 sceneMatrix;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// CompactVertex layout, see Model.h
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec2 inOctNormal;
+layout(location = 3) in uint inPackedTangent;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out mat3 fragTBN;
+
+vec3 OctDecode(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.x += direction.x >= 0.0 ? -fold : fold;
+    direction.y += direction.y >= 0.0 ? -fold : fold;
+    return normalize(direction);
+}
+
+void main() 
+{
+    gl_Position = ubo.proj * ubo.view * ubo.sceneMatrix * pushConstants.modelMatrix * vec4(inPosition, 1.0);
+    fragColor = vec3(1.0);
+    fragTexCoord = inTexCoord;
+
+    vec2 octTangent = vec2(inPackedTangent & 0x7FFFu, (inPackedTangent >> 15) & 0x7FFFu) / 32767.0 * 2.0 - 1.0;
+    float handedness = (inPackedTangent & 0x80000000u) != 0u ? -1.0 : 1.0;
+
+    mat3 normalMatrix = mat3(ubo.sceneMatrix * pushConstants.modelMatrix);
+    vec3 N = normalize(normalMatrix * OctDecode(inOctNormal));
+    vec3 T = normalize(normalMatrix * OctDecode(octTangent));
+    vec3 B = cross(N, T) * handedness;
+
+    fragTBN = mat3(T, B, N);
+}
@@ -11,14 +11,24 @@ GG::BlitPass::BlitPass(): m_Image(nullptr)
 	m_Pipeline = new Pipeline();
 }
 
-void GG::BlitPass::CreateImage(VkExtent2D swapChainExtent, Device* device)
+void GG::BlitPass::CreateImage(VkExtent2D swapChainExtent, Device* device, TransientImagePool& transientImages)
 {
+	// HDR lighting output, written by the lighting pass and read by the tone mapping blit
+	TransientImageDesc desc{};
+	desc.Width = swapChainExtent.width;
+	desc.Height = swapChainExtent.height;
+	desc.Format = VK_FORMAT_R16G16B16A16_SFLOAT;
+	desc.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	desc.Samples = device->GetMssaSamples();
+	desc.FirstPass = FramePass::Lighting;
+	desc.LastPass = FramePass::Blit;
+
 	m_Image = new Image();
-	m_Image->CreateImage(swapChainExtent.width, swapChainExtent.height, 1, device->GetMssaSamples(),
-		VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, device->GetVulkanDevice(), device->GetVulkanPhysicalDevice());
+	transientImages.Declare(*m_Image, desc, device->GetVulkanDevice());
+}
 
+void GG::BlitPass::CreateImageView(Device* device) const
+{
 	m_Image->CreateImageView(VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, 1, device->GetVulkanDevice());
 }
 
@@ -4,6 +4,7 @@
 
 #include "GGDescriptorManager.h"
 #include "GGPipeLine.h"
+#include "GGTransientImagePool.h"
 
 namespace GG
 {
@@ -16,7 +17,9 @@ namespace GG
 		BlitPass();
 		~BlitPass() = default;
 
-		void CreateImage(VkExtent2D swapChainExtent, Device* device);
+		// Memory is bound by transientImages.Build, the view can only be created after that
+		void CreateImage(VkExtent2D swapChainExtent, Device* device, TransientImagePool& transientImages);
+		void CreateImageView(Device* device) const;
 		void CreateDescriptorSets(Device* device, DescriptorManager* descriptorManager, int maxFramesInFlight);
 		static void CreateDescriptorPool(Device* device, DescriptorManager* descriptorManager,int maxFramesInFlight);
 		static void CreateDescriptorSetLayout(Device* device, DescriptorManager* descriptorManager);
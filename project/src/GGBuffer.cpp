@@ -1,17 +1,18 @@
 #include "GGBuffer.h"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <iostream>
 #include <stdexcept>
 
 #include "GGCamera.h"
-#include "GGCommandManager.h"
-#include "GGVkHelperFunctions.h"
 #include "Scene.h"
 #include "Time.h"
 
 using namespace GG;
-void Buffer::CreateBuffer(const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory) const
+void Buffer::CreateBuffer(const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocation& bufferMemory,
+	const MemoryCategory category) const
 {
 	VkBufferCreateInfo bufferInfo{};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -23,87 +24,25 @@ void Buffer::CreateBuffer(const VkDeviceSize size, const VkBufferUsageFlags usag
 		throw std::runtime_error("failed to create buffer!");
 	}
 
-	VkMemoryRequirements memRequirements;
-	vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
-
-	VkMemoryAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = GG::VkHelperFunctions::FindMemoryType(memRequirements.memoryTypeBits, properties, m_PhysicalDevice);
-
-	if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-		throw std::runtime_error("failed to allocate buffer memory!");
-	}
-
-	vkBindBufferMemory(m_Device, buffer, bufferMemory, 0);
+	bufferMemory = m_pAllocator->AllocateBufferMemory(buffer, properties, category);
 }
 
-void Buffer::CopyBuffer(const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkDeviceSize size, const VkQueue graphicsQueue,const CommandManager* commandManager) const
+void Buffer::DestroyBuffer(const VkBuffer buffer, const MemoryAllocation& bufferMemory) const
 {
-	VkCommandBuffer commandBuffer = commandManager->BeginSingleTimeCommands(m_Device);
-
-	VkBufferCopy copyRegion{};
-	copyRegion.size = size;
-	vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-	commandManager->EndSingleTimeCommands(graphicsQueue, commandBuffer,m_Device);
+	vkDestroyBuffer(m_Device, buffer, nullptr);
+	m_pAllocator->Free(bufferMemory);
 }
 
 //---------------------- Uniform Buffer ---------------------------------
 
-void Buffer::CreateUniformBuffers(Scene* scene) {
-	// Matrix UBO
-	VkDeviceSize matrixBufferSize = sizeof(UniformBufferObject);
-	m_UniformBuffers.resize(m_MaxFramesInFlight);
-	m_UniformBuffersMemory.resize(m_MaxFramesInFlight);
-	m_UniformBuffersMapped.resize(m_MaxFramesInFlight);
-
-	// PointLights SSBO
-	VkDeviceSize pointLightsBufferSize = sizeof(PointLight) * scene->GetPointLights().size();
-	m_PointLightsBuffers.resize(m_MaxFramesInFlight);
-	m_PointLightsBuffersMemory.resize(m_MaxFramesInFlight);
-	m_PointLightsBuffersMapped.resize(m_MaxFramesInFlight);
-
-	// PointLights SSBO
-	VkDeviceSize dirLightsBufferSize = sizeof(DirectionalLight) * scene->GetDirectionalLights().size();
-	m_DirectionalLightsBuffers.resize(m_MaxFramesInFlight);
-	m_DirectionalLightsBuffersMemory.resize(m_MaxFramesInFlight);
-	m_DirectionalLightsBuffersMapped.resize(m_MaxFramesInFlight);
-
-	for (size_t i = 0; i < m_MaxFramesInFlight; i++) {
-		// Create matrix UBO
-		CreateBuffer(
-			matrixBufferSize,
-			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			m_UniformBuffers[i],
-			m_UniformBuffersMemory[i]
-		);
-		vkMapMemory(m_Device, m_UniformBuffersMemory[i], 0, matrixBufferSize, 0, &m_UniformBuffersMapped[i]);
-
-		// Create Point lights Ssbo
-		CreateBuffer(
-			pointLightsBufferSize,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			m_PointLightsBuffers[i],
-			m_PointLightsBuffersMemory[i]
-		);
-		vkMapMemory(m_Device, m_PointLightsBuffersMemory[i], 0, pointLightsBufferSize, 0, &m_PointLightsBuffersMapped[i]);
-
-		// Create Directional lights Ssbo
-		CreateBuffer(
-			dirLightsBufferSize,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			m_DirectionalLightsBuffers[i],
-			m_DirectionalLightsBuffersMemory[i]
-		);
-		vkMapMemory(m_Device, m_DirectionalLightsBuffersMemory[i], 0, dirLightsBufferSize, 0, &m_DirectionalLightsBuffersMapped[i]);
-	}
+void Buffer::CreateUniformBuffers(DeletionQueue& deletionQueue) {
+	m_FrameAllocator.Create(this, m_PhysicalDevice, deletionQueue, m_MaxFramesInFlight, m_FrameAllocatorCapacity, m_FrameDynamicRange);
+	m_LightingFrameData.resize(m_MaxFramesInFlight);
 }
 
-void Buffer::UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent, Scene* scene) const {
+void Buffer::UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent, Scene* scene) {
+	m_FrameAllocator.BeginFrame(currentImage);
+
 	// --- Update Matrices ---
 	UniformBufferObject ubo{};
 	ubo.view = (scene->GetCamera().GetViewMatrix());
@@ -112,15 +51,55 @@ void Buffer::UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExte
 	ubo.sceneMatrix = scene->GetSceneMatrix();
 	ubo.viewPos = scene->GetCamera().GetPosition(); 
 
-	memcpy(m_UniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+	// First allocation of the frame, always fits the initial capacity
+	const FrameAllocation uboAllocation = m_FrameAllocator.AllocateUniform(sizeof(ubo));
+	memcpy(uboAllocation.pData, &ubo, sizeof(ubo));
+
 	// --- Update Lights ---
-	auto pointLights = scene->GetPointLights();
+	// Each light array is bound through a dynamic descriptor, its range grows with the light count up to the device limit
+	const auto& pointLights = scene->GetPointLights();
+	const auto& dirLights = scene->GetDirectionalLights();
+	const VkDeviceSize dynamicRange = m_FrameAllocator.ReserveDynamicRange(
+		std::max(pointLights.size() * sizeof(PointLight), dirLights.size() * sizeof(DirectionalLight)));
+	size_t pointLightCount = std::min<size_t>(pointLights.size(), dynamicRange / sizeof(PointLight));
+	size_t dirLightCount = std::min<size_t>(dirLights.size(), dynamicRange / sizeof(DirectionalLight));
+
+	if ((pointLightCount < pointLights.size() || dirLightCount < dirLights.size()) && !m_HasWarnedLightOverflow)
+	{
+		std::cerr << "WARNING: only " << pointLightCount << " point and " << dirLightCount << " directional lights fit the device's "
+			<< dynamicRange / 1024 << " KB storage buffer range, the rest are skipped\n";
+		m_HasWarnedLightOverflow = true;
+	}
 
-	memcpy(m_PointLightsBuffersMapped[currentImage], pointLights.data(), pointLights.size() * sizeof(PointLight));
+	// Written right away, a later allocation may move the frame to a bigger buffer
+	const FrameAllocation pointLightAllocation = m_FrameAllocator.AllocateStorage(pointLightCount * sizeof(PointLight));
+	if (pointLightAllocation.IsValid())
+	{
+		memcpy(pointLightAllocation.pData, pointLights.data(), pointLightAllocation.Size);
+	}
+	const FrameAllocation dirLightAllocation = m_FrameAllocator.AllocateStorage(dirLightCount * sizeof(DirectionalLight));
+	if (dirLightAllocation.IsValid())
+	{
+		memcpy(dirLightAllocation.pData, dirLights.data(), dirLightAllocation.Size);
+	}
 
-	auto dirLights = scene->GetDirectionalLights();
+	// Past the allocator's largest size the frame is drawn without those lights instead of failing
+	if (!pointLightAllocation.IsValid() || !dirLightAllocation.IsValid())
+	{
+		if (!m_HasWarnedFrameAllocatorFull)
+		{
+			std::cerr << "WARNING: frame allocator is full at " << m_FrameAllocator.GetCapacity() / 1024 << " KB, lights are skipped\n";
+			m_HasWarnedFrameAllocatorFull = true;
+		}
+		if (!pointLightAllocation.IsValid()) pointLightCount = 0;
+		if (!dirLightAllocation.IsValid()) dirLightCount = 0;
+	}
 
-	memcpy(m_DirectionalLightsBuffersMapped[currentImage], dirLights.data(), dirLights.size() * sizeof(DirectionalLight));
+	LightingFrameData& lightingData = m_LightingFrameData[currentImage];
+	lightingData.PointLightOffset = pointLightAllocation.Offset;
+	lightingData.DirectionalLightOffset = dirLightAllocation.Offset;
+	lightingData.PointLightCount = static_cast<uint32_t>(pointLightCount);
+	lightingData.DirectionalLightCount = static_cast<uint32_t>(dirLightCount);
 }
 
 
@@ -128,27 +107,5 @@ void Buffer::UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExte
 
 
 void Buffer::DestroyBuffer() const {
-	for (size_t i = 0; i < m_MaxFramesInFlight; i++) 
-	{
-		if (m_UniformBuffersMapped[i]) 
-		{
-			vkUnmapMemory(m_Device, m_UniformBuffersMemory[i]);
-		}
-		vkDestroyBuffer(m_Device, m_UniformBuffers[i], nullptr);
-		vkFreeMemory(m_Device, m_UniformBuffersMemory[i], nullptr);
-
-		if (m_PointLightsBuffersMapped[i]) 
-		{
-			vkUnmapMemory(m_Device, m_PointLightsBuffersMemory[i]);
-		}
-		vkDestroyBuffer(m_Device, m_PointLightsBuffers[i], nullptr);
-		vkFreeMemory(m_Device, m_PointLightsBuffersMemory[i], nullptr);
-
-		if (m_DirectionalLightsBuffersMapped[i]) 
-		{
-			vkUnmapMemory(m_Device, m_DirectionalLightsBuffersMemory[i]);
-		}
-		vkDestroyBuffer(m_Device, m_DirectionalLightsBuffers[i], nullptr);
-		vkFreeMemory(m_Device, m_DirectionalLightsBuffersMemory[i], nullptr);
-	}
+	m_FrameAllocator.Destroy();
 }
@@ -7,6 +7,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/hash.hpp>
 
+#include "GGFrameAllocator.h"
+#include "GGMemoryAllocator.h"
 #include "Scene.h"
 
 struct alignas(16) UniformBufferObject
@@ -19,47 +21,58 @@ struct alignas(16) UniformBufferObject
 
 namespace GG
 {
-	class CommandManager;
+	class DeletionQueue;
+
+	// Where this frame's lights were written in the frame allocator, read by the lighting pass
+	struct LightingFrameData
+	{
+		uint32_t PointLightOffset = 0;
+		uint32_t DirectionalLightOffset = 0;
+		uint32_t PointLightCount = 0;
+		uint32_t DirectionalLightCount = 0;
+	};
 
 	class Buffer
 	{
 	public:
-		Buffer(const VkDevice& device, const VkPhysicalDevice& physicalDevice, int maxFramesInFlight):
-		m_Device(device), m_PhysicalDevice(physicalDevice), m_MaxFramesInFlight(maxFramesInFlight){}
+		Buffer(const VkDevice& device, const VkPhysicalDevice& physicalDevice, MemoryAllocator& allocator, int maxFramesInFlight):
+		m_Device(device), m_PhysicalDevice(physicalDevice), m_pAllocator(&allocator), m_MaxFramesInFlight(maxFramesInFlight){}
 
+		// Host visible allocations come back persistently mapped through MemoryAllocation::pMapped, category is what the
+		// memory is accounted to in the allocator's budget
 		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-			VkDeviceMemory& bufferMemory) const;
-
-		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkQueue graphicsQueue,  const CommandManager* commandManager) const;
+			MemoryAllocation& bufferMemory, MemoryCategory category) const;
+		void DestroyBuffer(VkBuffer buffer, const MemoryAllocation& bufferMemory) const;
 
 		//---------------------- Uniform Buffer ---------------------------------
-		void CreateUniformBuffers(Scene* scene);
-		void UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent, Scene* scene) const;
+		void CreateUniformBuffers(DeletionQueue& deletionQueue);
+		void UpdateUniformBuffer(uint32_t currentImage, VkExtent2D swapChainExtent, Scene* scene);
 		//---------------------- No Uniform Buffer ------------------------------
 
 		void DestroyBuffer() const;
 
-		std::vector<VkBuffer>& GetUniformBuffers() { return m_UniformBuffers; }
-		std::vector<VkBuffer>& GetPointLightBuffers() { return m_PointLightsBuffers; }
-		std::vector<VkBuffer>& GetDirLightBuffers() { return m_DirectionalLightsBuffers; }
-	private:
-
+		// The camera UBO is the first allocation of every frame, so the plain uniform descriptors can stay at offset 0
+		VkBuffer GetFrameBuffer(uint32_t frameIndex) const { return m_FrameAllocator.GetBuffer(frameIndex); }
+		VkDeviceSize GetFrameDynamicRange(uint32_t frameIndex) const { return m_FrameAllocator.GetDynamicRange(frameIndex); }
+		// Changes when UpdateUniformBuffer moved the frame to a bigger buffer, its descriptor sets then need rewriting
+		uint64_t GetFrameBufferVersion(uint32_t frameIndex) const { return m_FrameAllocator.GetVersion(frameIndex); }
+		const LightingFrameData& GetLightingFrameData(uint32_t frameIndex) const { return m_LightingFrameData[frameIndex]; }
 
-		std::vector<VkBuffer> m_UniformBuffers;
-		std::vector<VkDeviceMemory> m_UniformBuffersMemory;
-		std::vector<void*> m_UniformBuffersMapped;
-
-		std::vector<VkBuffer> m_PointLightsBuffers;
-		std::vector<VkDeviceMemory> m_PointLightsBuffersMemory;
-		std::vector<void*> m_PointLightsBuffersMapped;
+		MemoryAllocator& GetMemoryAllocator() const { return *m_pAllocator; }
+	private:
+		// Starting sizes, both grow when a frame needs more
+		static constexpr VkDeviceSize m_FrameAllocatorCapacity = 1024 * 1024;
+		static constexpr VkDeviceSize m_FrameDynamicRange = 64 * 1024;
 
-		std::vector<VkBuffer> m_DirectionalLightsBuffers;
-		std::vector<VkDeviceMemory> m_DirectionalLightsBuffersMemory;
-		std::vector<void*> m_DirectionalLightsBuffersMapped;
+		FrameAllocator m_FrameAllocator;
+		std::vector<LightingFrameData> m_LightingFrameData;
+		bool m_HasWarnedLightOverflow = false;
+		bool m_HasWarnedFrameAllocatorFull = false;
 
 		const int m_MaxFramesInFlight;
 
 		VkDevice m_Device;
 		VkPhysicalDevice m_PhysicalDevice;
+		MemoryAllocator* m_pAllocator;
 	};
 }
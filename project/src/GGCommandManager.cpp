@@ -44,7 +44,7 @@ void CommandManager::CreateCommandBuffers(const VkDevice& device, const int maxF
 }
 
 void CommandManager::RecordCommandBuffer(uint32_t imageIndex, SwapChain* swapChain, int currentFrame, GBuffer& gBuffer, BlitPass& blitPass,
-	PipelinesForCommandBuffer pipelines, Scene* scene, DescriptorManager* descriptorManager)
+	PipelinesForCommandBuffer pipelines, Scene* scene, DescriptorManager* descriptorManager, const LightingFrameData& lightingData)
 {
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -183,8 +183,8 @@ void CommandManager::RecordCommandBuffer(uint32_t imageIndex, SwapChain* swapCha
 	};
 
 	lightAmountsPushConstants lightPushConstant;
-	lightPushConstant.amountOfPointLights = scene->GetPointLights().size();
-	lightPushConstant.amountOfDirLights = scene->GetDirectionalLights().size();
+	lightPushConstant.amountOfPointLights = lightingData.PointLightCount;
+	lightPushConstant.amountOfDirLights = lightingData.DirectionalLightCount;
 
 	vkCmdPushConstants(
 		m_CommandBuffers[currentFrame],
@@ -195,7 +195,8 @@ void CommandManager::RecordCommandBuffer(uint32_t imageIndex, SwapChain* swapCha
 		&lightPushConstant
 	);
 
-	uint32_t dynamicOffsets[2] = { 0, 0 };
+	// In binding order: point lights (3), then directional lights (6)
+	uint32_t dynamicOffsets[2] = { lightingData.PointLightOffset, lightingData.DirectionalLightOffset };
 
 	// Transition depth to read-only
 	TransitionImgContext depthToReadOnly{
@@ -230,6 +231,12 @@ void CommandManager::RecordCommandBuffer(uint32_t imageIndex, SwapChain* swapCha
 		TransitionImage(*image, gbufferToReadOnly, currentFrame);
 	}
 
+	// The lighting output is a transient image, its old contents are discarded. Waiting on fragment shaders orders
+	// the write after the last read of whatever shared its memory before
+	TransitionImgContext lightingOutputToColorAttach = optimalColorDraw;
+	lightingOutputToColorAttach.srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	TransitionImage(*blitPass.GetImage(), lightingOutputToColorAttach, currentFrame);
+
 	VkRenderingAttachmentInfo lightingColorAttachment{};
 	lightingColorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
 	lightingColorAttachment.imageView = blitPass.GetImage()->GetImageView();
@@ -341,8 +348,19 @@ void CommandManager::DrawScene(SwapChain* swapChain, const std::vector<VkDescrip
 	vkCmdBindDescriptorSets(m_CommandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetPipelineLayout(), 0, 1,
 		&descriptorSets[currentFrame], 0, nullptr);
 
+	// Every mesh lives in the scene geometry pool, so the buffers are bound once for the whole pass
+	scene->GetGeometryPool().Bind(m_CommandBuffers[currentFrame]);
+
 	for (auto& mesh : scene->GetMeshes())
 	{
+		const GG::GeometryAllocation& geometry = mesh.GetGeometryAllocation();
+		if (!geometry.IsValid()) continue;
+		// Still uploading, added by an incremental load
+		if (mesh.GetUploadTicket() > scene->GetReadyUploadTicket()) continue;
+
+		// Scene::Update already picked the LOD and culled, an empty range list means nothing of the mesh is visible
+		if (mesh.GetVisibleRanges().empty()) continue;
+
 		PushConstants pushConstants{};
 		pushConstants.ModelMatrix = mesh.GetModelMatrix();
 		pushConstants.AlbedoTexIndex = mesh.GetMaterialIndices().albedoTexIdx;
@@ -359,51 +377,13 @@ void CommandManager::DrawScene(SwapChain* swapChain, const std::vector<VkDescrip
 			&pushConstants
 		);
 
-		VkBuffer vertexBuffers[] = { mesh.GetVertexBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-
-		vkCmdBindVertexBuffers(m_CommandBuffers[currentFrame], 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(m_CommandBuffers[currentFrame], mesh.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
-
-		vkCmdDrawIndexed(m_CommandBuffers[currentFrame], static_cast<uint32_t>(mesh.GetIndices().size()), 1, 0, 0, 0);
+		for (const GG::IndexRange& range : mesh.GetVisibleRanges())
+		{
+			vkCmdDrawIndexed(m_CommandBuffers[currentFrame], range.IndexCount, 1, geometry.FirstIndex + range.FirstIndex, static_cast<int32_t>(geometry.VertexOffset), 0);
+		}
 	}
 }
 
-VkCommandBuffer CommandManager::BeginSingleTimeCommands(VkDevice device) const
-{
-	VkCommandBufferAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocInfo.commandPool = m_CommandPool;
-	allocInfo.commandBufferCount = 1;
-
-	VkCommandBuffer commandBuffer;
-	vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-	VkCommandBufferBeginInfo beginInfo{};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-	vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-	return commandBuffer;
-}
-
-void CommandManager::EndSingleTimeCommands(const VkQueue& graphicsQueue, const VkCommandBuffer& commandBuffer , const VkDevice& device) const
-{
-	vkEndCommandBuffer(commandBuffer);
-
-	VkSubmitInfo submitInfo{};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffer;
-
-	vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-	vkQueueWaitIdle(graphicsQueue);
-
-	vkFreeCommandBuffers(device, m_CommandPool, 1, &commandBuffer);
-}
-
 void CommandManager::TransitionImage(Image& image, TransitionImgContext context,int currentFrame) const
 {
 	VkImageMemoryBarrier barrier{};
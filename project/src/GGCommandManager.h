@@ -14,6 +14,7 @@ namespace GG
 	class DescriptorManager;
 	class Pipeline;
 	class SwapChain;
+	struct LightingFrameData;
 }
 
 class Scene;
@@ -44,12 +45,10 @@ namespace GG
 		void CreateCommandPool(const VkDevice& device, const VkPhysicalDevice& physicalDevice, const VkSurfaceKHR& surface);
 		void CreateCommandBuffers(const VkDevice& device, const int maxFramesInFlight);
 		void RecordCommandBuffer(uint32_t imageIndex, SwapChain* swapChain, int currentFrame, GBuffer& gBuffer, BlitPass& blitPass,
-			PipelinesForCommandBuffer pipelines,Scene* scene, DescriptorManager* descriptorManager);
+			PipelinesForCommandBuffer pipelines,Scene* scene, DescriptorManager* descriptorManager, const LightingFrameData& lightingData);
 
 		void DrawScene(SwapChain* swapChain, const std::vector<VkDescriptorSet>& descriptorSets, int currentFrame, Pipeline* pipeline, Scene* scene) const;
 
-		VkCommandBuffer BeginSingleTimeCommands(VkDevice device) const;
-		void EndSingleTimeCommands(const VkQueue& graphicsQueue, const VkCommandBuffer& commandBuffer, const VkDevice& device) const;
 		void TransitionImage(Image& image, TransitionImgContext context, int currentFrame) const;
 		void TransitionImage(VkImage image, TransitionImgContext context, int currentFrame);
 
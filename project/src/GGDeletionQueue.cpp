@@ -0,0 +1,92 @@
+#include "GGDeletionQueue.h"
+
+#include <vector>
+
+using namespace GG;
+
+void DeletionQueue::Initialize(VkDevice device, MemoryAllocator& allocator, uint32_t frameDelay)
+{
+	m_Device = device;
+	m_pAllocator = &allocator;
+	m_FrameDelay = frameDelay;
+}
+
+void DeletionQueue::BeginFrame()
+{
+	std::vector<std::function<void()>> expired;
+	{
+		std::lock_guard lock(m_Mutex);
+		++m_Frame;
+		while (!m_Entries.empty() && m_Entries.front().Frame + m_FrameDelay <= m_Frame)
+		{
+			expired.push_back(std::move(m_Entries.front().Destroy));
+			m_Entries.pop_front();
+		}
+	}
+
+	// Outside the lock, destroying may retire something else
+	for (const auto& destroy : expired)
+	{
+		destroy();
+	}
+}
+
+void DeletionQueue::Flush()
+{
+	std::deque<Entry> entries;
+	{
+		std::lock_guard lock(m_Mutex);
+		entries.swap(m_Entries);
+	}
+
+	for (const Entry& entry : entries)
+	{
+		entry.Destroy();
+	}
+}
+
+void DeletionQueue::RetireBuffer(VkBuffer buffer, const MemoryAllocation& memory)
+{
+	Retire([this, buffer, memory]
+	{
+		vkDestroyBuffer(m_Device, buffer, nullptr);
+		m_pAllocator->Free(memory);
+	});
+}
+
+void DeletionQueue::RetireImage(const Image& image)
+{
+	Retire([this, image] { image.DestroyImg(m_Device); });
+}
+
+void DeletionQueue::RetireImageView(VkImageView imageView)
+{
+	Retire([this, imageView] { vkDestroyImageView(m_Device, imageView, nullptr); });
+}
+
+void DeletionQueue::RetirePipeline(VkPipeline pipeline)
+{
+	Retire([this, pipeline] { vkDestroyPipeline(m_Device, pipeline, nullptr); });
+}
+
+void DeletionQueue::RetirePipelineLayout(VkPipelineLayout pipelineLayout)
+{
+	Retire([this, pipelineLayout] { vkDestroyPipelineLayout(m_Device, pipelineLayout, nullptr); });
+}
+
+void DeletionQueue::RetireDescriptorSet(VkDescriptorPool pool, VkDescriptorSet descriptorSet)
+{
+	Retire([this, pool, descriptorSet] { vkFreeDescriptorSets(m_Device, pool, 1, &descriptorSet); });
+}
+
+void DeletionQueue::Retire(std::function<void()> destroy)
+{
+	std::lock_guard lock(m_Mutex);
+	m_Entries.push_back({ m_Frame, std::move(destroy) });
+}
+
+size_t DeletionQueue::GetPendingCount() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_Entries.size();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vulkan/vulkan_core.h>
+
+#include "GGImage.h"
+#include "GGMemoryAllocator.h"
+
+namespace GG
+{
+	// Destroys resources once the GPU is done with them instead of waiting for the device to go idle. A resource retired
+	// during frame N is destroyed in BeginFrame of frame N + frameDelay, by then the fence of every frame that could
+	// still use it has been waited on
+	class DeletionQueue
+	{
+	public:
+		DeletionQueue() = default;
+		DeletionQueue(const DeletionQueue&) = delete;
+		DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+		// frameDelay has to cover every frame in flight plus the frame recording when the resource is retired
+		void Initialize(VkDevice device, MemoryAllocator& allocator, uint32_t frameDelay);
+		// Called once a frame after waiting on the frame's fence
+		void BeginFrame();
+		// Destroys everything still queued, only once the device is idle
+		void Flush();
+
+		void RetireBuffer(VkBuffer buffer, const MemoryAllocation& memory);
+		void RetireImage(const Image& image);
+		void RetireImageView(VkImageView imageView);
+		void RetirePipeline(VkPipeline pipeline);
+		void RetirePipelineLayout(VkPipelineLayout pipelineLayout);
+		// The pool must have been created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+		void RetireDescriptorSet(VkDescriptorPool pool, VkDescriptorSet descriptorSet);
+		// Anything else, e.g. a range of a sub-allocator that frames in flight may still read
+		void Retire(std::function<void()> destroy);
+
+		uint64_t GetFrame() const { return m_Frame; }
+		size_t GetPendingCount() const;
+
+	private:
+		struct Entry
+		{
+			uint64_t Frame;
+			std::function<void()> Destroy;
+		};
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		MemoryAllocator* m_pAllocator = nullptr;
+		uint32_t m_FrameDelay = 1;
+		uint64_t m_Frame = 0;
+
+		std::deque<Entry> m_Entries; // In retirement order, so the expired ones are always at the front
+		mutable std::mutex m_Mutex;
+	};
+}
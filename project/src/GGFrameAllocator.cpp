@@ -0,0 +1,126 @@
+#include "GGFrameAllocator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "GGBuffer.h"
+#include "GGDeletionQueue.h"
+
+using namespace GG;
+
+void FrameAllocator::Create(const Buffer* pBuffer, VkPhysicalDevice physicalDevice, DeletionQueue& deletionQueue, int maxFramesInFlight,
+	VkDeviceSize capacity, VkDeviceSize dynamicRange)
+{
+	m_pBuffer = pBuffer;
+	m_pDeletionQueue = &deletionQueue;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	m_UniformAlignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 16);
+	m_StorageAlignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 16);
+	m_MaxDynamicRange = properties.limits.maxStorageBufferRange;
+
+	m_Capacity = capacity;
+	m_DynamicRange = std::min(dynamicRange, m_MaxDynamicRange);
+
+	m_Frames.resize(maxFramesInFlight);
+	for (uint32_t i = 0; i < m_Frames.size(); ++i)
+	{
+		m_CurrentFrame = i;
+		RecreateFrameBuffer(m_Frames[i]);
+	}
+	m_CurrentFrame = 0;
+}
+
+void FrameAllocator::Destroy() const
+{
+	for (const Frame& frame : m_Frames)
+	{
+		m_pBuffer->DestroyBuffer(frame.Buffer, frame.Memory);
+	}
+}
+
+void FrameAllocator::BeginFrame(uint32_t frameIndex)
+{
+	m_CurrentFrame = frameIndex;
+	m_Head = 0;
+
+	Frame& frame = m_Frames[frameIndex];
+	if (frame.Capacity < m_Capacity || frame.DynamicRange < m_DynamicRange)
+	{
+		RecreateFrameBuffer(frame);
+	}
+}
+
+FrameAllocation FrameAllocator::AllocateUniform(VkDeviceSize size)
+{
+	return Allocate(size, m_UniformAlignment);
+}
+
+FrameAllocation FrameAllocator::AllocateStorage(VkDeviceSize size)
+{
+	return Allocate(size, m_StorageAlignment);
+}
+
+VkDeviceSize FrameAllocator::ReserveDynamicRange(VkDeviceSize size)
+{
+	Frame& frame = m_Frames[m_CurrentFrame];
+	if (size <= frame.DynamicRange) return frame.DynamicRange;
+
+	VkDeviceSize dynamicRange = std::max<VkDeviceSize>(m_DynamicRange, 1);
+	while (dynamicRange < size) dynamicRange *= 2;
+	m_DynamicRange = std::min(dynamicRange, m_MaxDynamicRange);
+
+	if (m_DynamicRange > frame.DynamicRange)
+	{
+		RecreateFrameBuffer(frame);
+	}
+	return frame.DynamicRange;
+}
+
+FrameAllocation FrameAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	const VkDeviceSize offset = (m_Head + alignment - 1) / alignment * alignment;
+	Frame& frame = m_Frames[m_CurrentFrame];
+	if (offset + size > frame.Capacity)
+	{
+		VkDeviceSize capacity = m_Capacity;
+		while (capacity < offset + size) capacity *= 2;
+		if (capacity > m_MaxCapacity) return {};
+
+		m_Capacity = capacity;
+		RecreateFrameBuffer(frame);
+	}
+
+	m_Head = offset + size;
+	m_PeakUsage = std::max(m_PeakUsage, m_Head);
+
+	FrameAllocation allocation;
+	allocation.Buffer = frame.Buffer;
+	allocation.Offset = static_cast<uint32_t>(offset);
+	allocation.Size = size;
+	allocation.pData = static_cast<uint8_t*>(frame.Memory.pMapped) + offset;
+	return allocation;
+}
+
+void FrameAllocator::RecreateFrameBuffer(Frame& frame)
+{
+	const Frame oldFrame = frame;
+
+	// The buffer runs the dynamic range past the ring, so a descriptor window starting at any allocation stays inside it
+	m_pBuffer->CreateBuffer(m_Capacity + m_DynamicRange, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, frame.Buffer, frame.Memory, MemoryCategory::Uniforms);
+	frame.Capacity = m_Capacity;
+	frame.DynamicRange = m_DynamicRange;
+	++frame.Version;
+
+	if (oldFrame.Buffer == VK_NULL_HANDLE) return;
+
+	// Whatever this frame allocated before growing still has to reach the GPU at the same offsets
+	memcpy(frame.Memory.pMapped, oldFrame.Memory.pMapped, m_Head);
+	m_pDeletionQueue->RetireBuffer(oldFrame.Buffer, oldFrame.Memory);
+
+	std::cout << "[FrameAllocator] frame " << m_CurrentFrame << " grew to " << frame.Capacity / 1024 << " KB, "
+		<< frame.DynamicRange / 1024 << " KB dynamic range\n";
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMemoryAllocator.h"
+
+namespace GG
+{
+	class Buffer;
+	class DeletionQueue;
+
+	struct FrameAllocation
+	{
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		uint32_t Offset = 0; // Dynamic descriptor offsets are 32 bit
+		VkDeviceSize Size = 0;
+		void* pData = nullptr;
+
+		bool IsValid() const { return pData != nullptr; }
+	};
+
+	// One persistently mapped buffer per frame in flight, handed out linearly and rewound when that frame comes around
+	// again. The frame's fence has been waited on by then, so nothing the GPU still reads gets overwritten.
+	// A frame that runs out of room gets a buffer twice the size, the old one goes through the deletion queue and the
+	// frame's version changes so its descriptor sets get rewritten. The other frames catch up in their BeginFrame
+	class FrameAllocator
+	{
+	public:
+		void Create(const Buffer* pBuffer, VkPhysicalDevice physicalDevice, DeletionQueue& deletionQueue, int maxFramesInFlight,
+			VkDeviceSize capacity, VkDeviceSize dynamicRange);
+		void Destroy() const;
+
+		void BeginFrame(uint32_t frameIndex);
+		// Growing moves the frame to a new buffer, so fill in an allocation before making the next one.
+		// Invalid only once the ring would have to grow past m_MaxCapacity
+		FrameAllocation AllocateUniform(VkDeviceSize size);
+		FrameAllocation AllocateStorage(VkDeviceSize size);
+		// Widens the dynamic descriptor range of this frame to at least size, up to the device's storage buffer range.
+		// Returns the range the frame ends up with
+		VkDeviceSize ReserveDynamicRange(VkDeviceSize size);
+
+		VkBuffer GetBuffer(uint32_t frameIndex) const { return m_Frames[frameIndex].Buffer; }
+		VkDeviceSize GetCapacity() const { return m_Capacity; }
+		// Range of every dynamic descriptor that points into the frame's buffer, an allocation bound through one can't be larger
+		VkDeviceSize GetDynamicRange(uint32_t frameIndex) const { return m_Frames[frameIndex].DynamicRange; }
+		// Changes whenever the frame moved to a new buffer
+		uint64_t GetVersion(uint32_t frameIndex) const { return m_Frames[frameIndex].Version; }
+		VkDeviceSize GetPeakUsage() const { return m_PeakUsage; }
+
+	private:
+		FrameAllocation Allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+		struct Frame
+		{
+			VkBuffer Buffer = VK_NULL_HANDLE;
+			MemoryAllocation Memory;
+			VkDeviceSize Capacity = 0;
+			VkDeviceSize DynamicRange = 0;
+			uint64_t Version = 0;
+		};
+
+		// Moves the current frame to a buffer of m_Capacity and m_DynamicRange, keeping what it wrote so far
+		void RecreateFrameBuffer(Frame& frame);
+
+		static constexpr VkDeviceSize m_MaxCapacity = 64 * 1024 * 1024;
+
+		const Buffer* m_pBuffer = nullptr;
+		DeletionQueue* m_pDeletionQueue = nullptr;
+		std::vector<Frame> m_Frames;
+		uint32_t m_CurrentFrame = 0;
+
+		// What every frame's buffer grows to, a frame smaller than this is recreated in its BeginFrame
+		VkDeviceSize m_Capacity = 0;
+		VkDeviceSize m_DynamicRange = 0;
+		VkDeviceSize m_MaxDynamicRange = 0;
+		VkDeviceSize m_Head = 0;
+		VkDeviceSize m_PeakUsage = 0;
+
+		VkDeviceSize m_UniformAlignment = 256;
+		VkDeviceSize m_StorageAlignment = 256;
+	};
+}
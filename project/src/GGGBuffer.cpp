@@ -12,27 +12,29 @@ GG::GBuffer::GBuffer(): m_AlbedoImage(), m_NormalMapImage(), m_MettalicRoughness
 	m_Pipeline = new Pipeline();
 }
 
-void GG::GBuffer::CreateImages(VkExtent2D swapChainExtent, Device* device)
+void GG::GBuffer::CreateImages(VkExtent2D swapChainExtent, Device* device, TransientImagePool& transientImages)
 {
-	m_AlbedoImage.CreateImage(swapChainExtent.width, swapChainExtent.height, 1, device->GetMssaSamples(),
-		VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, device->GetVulkanDevice(), device->GetVulkanPhysicalDevice());
+	// Written by the G-buffer pass and last read by the lighting pass
+	TransientImageDesc desc{};
+	desc.Width = swapChainExtent.width;
+	desc.Height = swapChainExtent.height;
+	desc.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	desc.Samples = device->GetMssaSamples();
+	desc.FirstPass = FramePass::GBuffer;
+	desc.LastPass = FramePass::Lighting;
+
+	desc.Format = VK_FORMAT_R8G8B8A8_SRGB;
+	transientImages.Declare(m_AlbedoImage, desc, device->GetVulkanDevice());
+
+	desc.Format = VK_FORMAT_R8G8B8A8_UNORM;
+	transientImages.Declare(m_NormalMapImage, desc, device->GetVulkanDevice());
+	transientImages.Declare(m_MettalicRoughnessImage, desc, device->GetVulkanDevice());
+}
 
+void GG::GBuffer::CreateImageViews(Device* device)
+{
 	m_AlbedoImage.CreateImageView(VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, 1, device->GetVulkanDevice());
-
-	m_NormalMapImage.CreateImage(swapChainExtent.width, swapChainExtent.height, 1, device->GetMssaSamples(),
-		VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, device->GetVulkanDevice(), device->GetVulkanPhysicalDevice());
-
 	m_NormalMapImage.CreateImageView(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, 1, device->GetVulkanDevice());
-
-	m_MettalicRoughnessImage.CreateImage(swapChainExtent.width, swapChainExtent.height, 1, device->GetMssaSamples(),
-		VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, device->GetVulkanDevice(), device->GetVulkanPhysicalDevice());
-
 	m_MettalicRoughnessImage.CreateImageView(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, 1, device->GetVulkanDevice());
 }
 
@@ -51,11 +53,14 @@ GG::Image& GG::GBuffer::GetMettalicRoughnessGGImage()
 	return m_MettalicRoughnessImage;
 }
 
-void GG::GBuffer::CreatePipeline(Device* device, DescriptorManager* descriptorManager)
+void GG::GBuffer::CreatePipeline(Device* device, DescriptorManager* descriptorManager, VertexFormat vertexFormat)
 {
 	PipelineContext graphicsPipelineContext{};
+	graphicsPipelineContext.SetVertexFormat(vertexFormat);
 
-	GG::Shader vertShader{ "shaders/shader.vert.spv" , device->GetVulkanDevice() };
+	// Same outputs as shader.vert, decodes the quantized CompactVertex attributes
+	const char* vertShaderPath = vertexFormat == VertexFormat::Compact ? "shaders/shaderCompact.vert.spv" : "shaders/shader.vert.spv";
+	GG::Shader vertShader{ vertShaderPath , device->GetVulkanDevice() };
 	GG::Shader fragShader{ "shaders/shader.frag.spv" , device->GetVulkanDevice() };
 
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
@@ -115,7 +120,7 @@ void GG::GBuffer::CreateDescriptorSets(Scene* currentScene, Device* device, Desc
 	for (size_t i = 0; i < maxFramesInFlight; i++)
 	{
 		auto& bufferInfo = descriptorSetsContext.BufferInfos[i];
-		bufferInfo.buffer = buffer->GetUniformBuffers()[i];
+		bufferInfo.buffer = buffer->GetFrameBuffer(static_cast<uint32_t>(i));
 		bufferInfo.offset = 0;
 		bufferInfo.range = sizeof(UniformBufferObject);
 
@@ -154,7 +159,8 @@ void GG::GBuffer::CreateDescriptorSets(Scene* currentScene, Device* device, Desc
 		descriptorSetsContext.AddDescriptorSetWrites(imagesDescriptor);
 	}
 
-	std::vector<uint32_t> descriptorCounts(maxFramesInFlight, descriptorSetsContext.VariableCount);
+	// Slots past the current textures stay unwritten until an incremental load adds textures
+	std::vector<uint32_t> descriptorCounts(maxFramesInFlight, currentScene->GetTextureSlotCapacity());
 
 	VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
 	variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
@@ -177,6 +183,36 @@ void GG::GBuffer::CreateDescriptorSets(Scene* currentScene, Device* device, Desc
 	descriptorSetsContext.AllocateInfo = allocInfo;
 	descriptorSetsContext.DescriptorSetLayout = descriptorManager->GetDescriptorSetLayout(1);
 	descriptorManager->CreateDescriptorSets(std::move(descriptorSetsContext), maxFramesInFlight, device->GetVulkanDevice());
+
+	m_TextureDescriptorVersions.assign(maxFramesInFlight, currentScene->GetTextureResidencyVersion());
+}
+
+void GG::GBuffer::UpdateTextureDescriptors(Scene* currentScene, Device* device, DescriptorManager* descriptorManager, uint32_t currentFrame)
+{
+	const uint64_t residencyVersion = currentScene->GetTextureResidencyVersion();
+	if (m_TextureDescriptorVersions[currentFrame] == residencyVersion) return;
+
+	// The whole array is rewritten, it is one descriptor per texture and only changes while textures stream in
+	const std::vector<VkImageView> imageViews = currentScene->GetImageViews();
+	std::vector<VkDescriptorImageInfo> imageInfos(imageViews.size());
+	for (size_t i = 0; i < imageViews.size(); ++i)
+	{
+		imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfos[i].imageView = imageViews[i];
+		imageInfos[i].sampler = device->GetTextureSampler();
+	}
+
+	VkWriteDescriptorSet imagesDescriptor{};
+	imagesDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	imagesDescriptor.dstSet = descriptorManager->GetDescriptorSets(1)[currentFrame];
+	imagesDescriptor.dstBinding = 2;
+	imagesDescriptor.dstArrayElement = 0;
+	imagesDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	imagesDescriptor.descriptorCount = static_cast<uint32_t>(imageInfos.size());
+	imagesDescriptor.pImageInfo = imageInfos.data();
+
+	vkUpdateDescriptorSets(device->GetVulkanDevice(), 1, &imagesDescriptor, 0, nullptr);
+	m_TextureDescriptorVersions[currentFrame] = residencyVersion;
 }
 
 void GG::GBuffer::CreateDescriptorSetLayout(Device* device, DescriptorManager* descriptorManager)
@@ -1,6 +1,7 @@
 #pragma once
 #include "GGImage.h"
 #include "GGPipeLine.h"
+#include "GGTransientImagePool.h"
 
 class Scene;
 
@@ -15,14 +16,18 @@ namespace GG
 	public:
 		GBuffer();
 
-		void CreateImages(VkExtent2D swapChainExtent, Device* device);
+		// Memory is bound by transientImages.Build, the views can only be created after that
+		void CreateImages(VkExtent2D swapChainExtent, Device* device, TransientImagePool& transientImages);
+		void CreateImageViews(Device* device);
 
 		Image& GetAlbedoGGImage();
 		Image& GetNormalMapGGImage();
 		Image& GetMettalicRoughnessGGImage();
 
-		void CreatePipeline(Device* device, DescriptorManager* descriptorManager);
+		void CreatePipeline(Device* device, DescriptorManager* descriptorManager, VertexFormat vertexFormat);
 		void CreateDescriptorSets(Scene* currentScene, Device* device, DescriptorManager* descriptorManager, Buffer* buffer, int maxFramesInFlight);
+		// Rewrites the frame's texture array when the scene's resident textures changed, the frame's fence has to be waited on first
+		void UpdateTextureDescriptors(Scene* currentScene, Device* device, DescriptorManager* descriptorManager, uint32_t currentFrame);
 		void CreateDescriptorSetLayout(Device* device, DescriptorManager* descriptorManager);
 		void CreateDescriptorPool(Device* device, DescriptorManager* descriptorManager, int maxFramesInFlight);
 
@@ -35,5 +40,7 @@ namespace GG
 		Image m_AlbedoImage;
 		Image m_NormalMapImage;
 		Image m_MettalicRoughnessImage;
+		// Scene::GetTextureResidencyVersion each frame's descriptor set was last written with
+		std::vector<uint64_t> m_TextureDescriptorVersions;
 	};
 }
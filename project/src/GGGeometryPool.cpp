@@ -0,0 +1,146 @@
+#include "GGGeometryPool.h"
+
+#include <algorithm>
+
+#include "GGBuffer.h"
+
+using namespace GG;
+
+void RangeAllocator::Reset(uint32_t capacity)
+{
+	m_Capacity = capacity;
+	m_Used = 0;
+	m_FreeRanges.clear();
+
+	if (capacity > 0)
+	{
+		m_FreeRanges.push_back({ 0, capacity });
+	}
+}
+
+std::optional<uint32_t> RangeAllocator::Allocate(uint32_t size)
+{
+	if (size == 0) return std::nullopt;
+
+	for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it)
+	{
+		if (it->Size < size) continue;
+
+		const uint32_t offset = it->Offset;
+		it->Offset += size;
+		it->Size -= size;
+
+		if (it->Size == 0)
+		{
+			m_FreeRanges.erase(it);
+		}
+
+		m_Used += size;
+		return offset;
+	}
+
+	return std::nullopt;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+	if (size == 0) return;
+
+	auto next = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), offset,
+		[](const Range& range, uint32_t value) { return range.Offset < value; });
+
+	const bool mergesWithPrevious = next != m_FreeRanges.begin() && std::prev(next)->Offset + std::prev(next)->Size == offset;
+	const bool mergesWithNext = next != m_FreeRanges.end() && offset + size == next->Offset;
+
+	if (mergesWithPrevious && mergesWithNext)
+	{
+		std::prev(next)->Size += size + next->Size;
+		m_FreeRanges.erase(next);
+	}
+	else if (mergesWithPrevious)
+	{
+		std::prev(next)->Size += size;
+	}
+	else if (mergesWithNext)
+	{
+		next->Offset = offset;
+		next->Size += size;
+	}
+	else
+	{
+		m_FreeRanges.insert(next, { offset, size });
+	}
+
+	m_Used -= size;
+}
+
+uint32_t RangeAllocator::GetLargestFreeRange() const
+{
+	uint32_t largest = 0;
+	for (const auto& range : m_FreeRanges)
+	{
+		largest = std::max(largest, range.Size);
+	}
+	return largest;
+}
+
+void GeometryPool::Create(const Buffer* pBuffer, VertexFormat vertexFormat, uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	m_pBuffer = pBuffer;
+	m_VertexFormat = vertexFormat;
+	m_VertexStride = GG::GetVertexStride(vertexFormat);
+	m_VertexAllocator.Reset(vertexCapacity);
+	m_IndexAllocator.Reset(indexCapacity);
+
+	pBuffer->CreateBuffer(static_cast<VkDeviceSize>(vertexCapacity) * m_VertexStride, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VertexBuffer, m_VertexBufferMemory, MemoryCategory::Geometry);
+
+	pBuffer->CreateBuffer(static_cast<VkDeviceSize>(indexCapacity) * sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_IndexBuffer, m_IndexBufferMemory, MemoryCategory::Geometry);
+}
+
+void GeometryPool::Destroy() const
+{
+	if (!m_pBuffer) return;
+
+	m_pBuffer->DestroyBuffer(m_IndexBuffer, m_IndexBufferMemory);
+	m_pBuffer->DestroyBuffer(m_VertexBuffer, m_VertexBufferMemory);
+}
+
+GeometryAllocation GeometryPool::Allocate(uint32_t vertexCount, uint32_t indexCount)
+{
+	// Nothing to draw or no room left, hand out an invalid allocation instead of failing
+	if (vertexCount == 0 || indexCount == 0) return {};
+
+	const std::optional<uint32_t> vertexOffset = m_VertexAllocator.Allocate(vertexCount);
+	if (!vertexOffset) return {};
+
+	const std::optional<uint32_t> firstIndex = m_IndexAllocator.Allocate(indexCount);
+	if (!firstIndex)
+	{
+		m_VertexAllocator.Free(*vertexOffset, vertexCount);
+		return {};
+	}
+
+	GeometryAllocation allocation{};
+	allocation.VertexOffset = *vertexOffset;
+	allocation.VertexCount = vertexCount;
+	allocation.FirstIndex = *firstIndex;
+	allocation.IndexCount = indexCount;
+	return allocation;
+}
+
+void GeometryPool::Free(const GeometryAllocation& allocation)
+{
+	if (!allocation.IsValid()) return;
+
+	m_VertexAllocator.Free(allocation.VertexOffset, allocation.VertexCount);
+	m_IndexAllocator.Free(allocation.FirstIndex, allocation.IndexCount);
+}
+
+void GeometryPool::Bind(VkCommandBuffer commandBuffer) const
+{
+	const VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_VertexBuffer, &offset);
+	vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMemoryAllocator.h"
+#include "GGVertexFormat.h"
+
+namespace GG
+{
+	class Buffer;
+
+	// Offsets and counts are in elements: vertices for the vertex pool, indices for the index pool
+	struct GeometryAllocation
+	{
+		uint32_t VertexOffset = 0;
+		uint32_t VertexCount = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+
+		bool IsValid() const { return VertexCount > 0 && IndexCount > 0; }
+	};
+
+	// First fit free list over [0, capacity), neighbouring free ranges are merged on Free
+	class RangeAllocator
+	{
+	public:
+		void Reset(uint32_t capacity);
+		std::optional<uint32_t> Allocate(uint32_t size);
+		void Free(uint32_t offset, uint32_t size);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+		uint32_t GetFreeRangeCount() const { return static_cast<uint32_t>(m_FreeRanges.size()); }
+		uint32_t GetLargestFreeRange() const;
+
+	private:
+		struct Range
+		{
+			uint32_t Offset;
+			uint32_t Size;
+		};
+
+		std::vector<Range> m_FreeRanges; // Sorted by offset
+		uint32_t m_Capacity = 0;
+		uint32_t m_Used = 0;
+	};
+
+	// One device local vertex buffer and one index buffer shared by every mesh in the scene
+	class GeometryPool
+	{
+	public:
+		void Create(const Buffer* pBuffer, VertexFormat vertexFormat, uint32_t vertexCapacity, uint32_t indexCapacity);
+		void Destroy() const;
+
+		// Invalid allocation for an empty mesh or when either pool has no free range big enough
+		GeometryAllocation Allocate(uint32_t vertexCount, uint32_t indexCount);
+		void Free(const GeometryAllocation& allocation);
+
+		void Bind(VkCommandBuffer commandBuffer) const;
+
+		VkBuffer GetVertexBuffer() const { return m_VertexBuffer; }
+		VkBuffer GetIndexBuffer() const { return m_IndexBuffer; }
+		uint32_t GetVertexStride() const { return m_VertexStride; }
+		VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+
+		VkDeviceSize GetVertexByteOffset(const GeometryAllocation& allocation) const { return static_cast<VkDeviceSize>(allocation.VertexOffset) * m_VertexStride; }
+		VkDeviceSize GetIndexByteOffset(const GeometryAllocation& allocation) const { return static_cast<VkDeviceSize>(allocation.FirstIndex) * sizeof(uint32_t); }
+
+		const RangeAllocator& GetVertexAllocator() const { return m_VertexAllocator; }
+		const RangeAllocator& GetIndexAllocator() const { return m_IndexAllocator; }
+
+	private:
+		VertexFormat m_VertexFormat = VertexFormat::Full;
+		uint32_t m_VertexStride = 0;
+
+		RangeAllocator m_VertexAllocator;
+		RangeAllocator m_IndexAllocator;
+
+		const Buffer* m_pBuffer = nullptr;
+
+		VkBuffer m_VertexBuffer				= VK_NULL_HANDLE;
+		MemoryAllocation m_VertexBufferMemory;
+
+		VkBuffer m_IndexBuffer				= VK_NULL_HANDLE;
+		MemoryAllocation m_IndexBufferMemory;
+	};
+}
@@ -0,0 +1,150 @@
+#include "GGHalfFloat.h"
+
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX2__)
+#define GG_HALF_FLOAT_F16C 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GG_HALF_FLOAT_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GG_HALF_FLOAT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace GG;
+
+namespace
+{
+#if defined(GG_HALF_FLOAT_F16C)
+	// The hardware conversion rounds to nearest even and keeps denormals, only NaN payloads are replaced to match the scalar path
+	void ConvertEight(const float* source, uint16_t* target)
+	{
+		const __m256 values = _mm256_loadu_ps(source);
+		const __m128i halves = _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+		const __m256i nanMask32 = _mm256_castps_si256(_mm256_cmp_ps(values, values, _CMP_UNORD_Q));
+		const __m128i nanMask = _mm_packs_epi32(_mm256_castsi256_si128(nanMask32), _mm256_extractf128_si256(nanMask32, 1));
+		const __m128i quietNan = _mm_or_si128(_mm_and_si128(halves, _mm_set1_epi16(static_cast<short>(0x8000))), _mm_set1_epi16(0x7E00));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_or_si128(_mm_andnot_si128(nanMask, halves), _mm_and_si128(nanMask, quietNan)));
+	}
+#elif defined(GG_HALF_FLOAT_NEON)
+	void ConvertFour(const float* source, uint16_t* target)
+	{
+		const float32x4_t values = vld1q_f32(source);
+		const uint16x4_t halves = vreinterpret_u16_f16(vcvt_f16_f32(values));
+
+		const uint16x4_t nanMask = vmvn_u16(vmovn_u32(vceqq_f32(values, values)));
+		const uint16x4_t quietNan = vorr_u16(vand_u16(halves, vdup_n_u16(0x8000)), vdup_n_u16(0x7E00));
+
+		vst1_u16(target, vbsl_u16(nanMask, quietNan, halves));
+	}
+#elif defined(GG_HALF_FLOAT_SSE2)
+	// Branchless version of the scalar conversion, denormals are rounded by adding 0.5 so the FPU does the round to nearest even
+	__m128i ConvertFour(const float* source)
+	{
+		const __m128i bits = _mm_castps_si128(_mm_loadu_ps(source));
+		const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(0x80000000)));
+		const __m128i absBits = _mm_xor_si128(bits, sign);
+
+		const __m128i denormalMagic = _mm_set1_epi32(0x3F000000);
+		const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absBits), _mm_castsi128_ps(denormalMagic))), denormalMagic);
+
+		const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(1));
+		const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(absBits, _mm_set1_epi32(static_cast<int>(0xC8000FFF))), mantissaOdd), 13);
+
+		const __m128i isDenormal = _mm_cmplt_epi32(absBits, _mm_set1_epi32(0x38800000));
+		const __m128i isInfinity = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x477FEFFF));
+		const __m128i isNan = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x7F800000));
+
+		__m128i half = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+		half = _mm_or_si128(_mm_andnot_si128(isInfinity, half), _mm_and_si128(isInfinity, _mm_set1_epi32(0x7C00)));
+		half = _mm_or_si128(_mm_andnot_si128(isNan, half), _mm_and_si128(isNan, _mm_set1_epi32(0x7E00)));
+		half = _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+
+		// Sign extend from 16 bits so the saturating pack keeps the bits as they are
+		return _mm_srai_epi32(_mm_slli_epi32(half, 16), 16);
+	}
+#endif
+}
+
+uint16_t GG::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t absBits = bits & 0x7FFFFFFF;
+
+	// Infinity and NaN, NaN keeps a quiet payload bit
+	if (absBits >= 0x7F800000) return static_cast<uint16_t>(sign | (absBits > 0x7F800000 ? 0x7E00 : 0x7C00));
+
+	// Everything from 65520 upwards rounds to infinity
+	if (absBits >= 0x477FF000) return static_cast<uint16_t>(sign | 0x7C00);
+
+	// Below the smallest normal half (2^-14) the result is denormal
+	if (absBits < 0x38800000)
+	{
+		// Below half of the smallest denormal (2^-25) rounds to zero
+		if (absBits < 0x33000000) return static_cast<uint16_t>(sign);
+
+		const uint32_t exponent = absBits >> 23;
+		const uint32_t mantissa = (absBits & 0x007FFFFF) | 0x00800000;
+		const uint32_t shift = 126 - exponent;
+
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	// Rebias the exponent from 127 to 15, a mantissa carry correctly bumps the exponent
+	uint32_t half = (absBits - 0x38000000) >> 13;
+	const uint32_t remainder = absBits & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+
+	return static_cast<uint16_t>(sign | half);
+}
+
+void GG::FloatToHalf(const float* source, uint16_t* target, size_t count)
+{
+	size_t i = 0;
+#if defined(GG_HALF_FLOAT_F16C)
+	for (; i + 8 <= count; i += 8)
+	{
+		ConvertEight(source + i, target + i);
+	}
+#elif defined(GG_HALF_FLOAT_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		ConvertFour(source + i, target + i);
+	}
+#elif defined(GG_HALF_FLOAT_SSE2)
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i halves = _mm_packs_epi32(ConvertFour(source + i), ConvertFour(source + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), halves);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		target[i] = FloatToHalf(source[i]);
+	}
+}
+
+const char* GG::GetHalfFloatInstructionSet()
+{
+#if defined(GG_HALF_FLOAT_F16C)
+	return "F16C";
+#elif defined(GG_HALF_FLOAT_NEON)
+	return "NEON";
+#elif defined(GG_HALF_FLOAT_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace GG
+{
+	// IEEE 754 binary16 conversion with round to nearest even, keeps denormals, infinities and NaN
+	uint16_t FloatToHalf(float value);
+
+	// Same result as converting every value on its own, count values from source are written to target
+	void FloatToHalf(const float* source, uint16_t* target, size_t count);
+
+	// "F16C", "NEON", "SSE2" or "scalar", whichever the batch conversion was built with
+	const char* GetHalfFloatInstructionSet();
+}
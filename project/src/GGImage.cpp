@@ -7,8 +7,20 @@
 using namespace GG;
 
 void Image::CreateImage(const uint32_t width, const uint32_t height, const uint32_t mipLevels, const VkSampleCountFlagBits numSamples, const VkFormat format,
-	const VkImageTiling tiling, const VkImageUsageFlags usage, const VkMemoryPropertyFlags properties, const VkDevice& device, const VkPhysicalDevice& physicalDevice)
+	const VkImageTiling tiling, const VkImageUsageFlags usage, const VkMemoryPropertyFlags properties, MemoryAllocator& allocator,
+	const MemoryCategory category)
 {
+	CreateUnboundImage(width, height, mipLevels, numSamples, format, tiling, usage, allocator.GetDevice());
+
+	m_pAllocator = &allocator;
+	m_ImageMemory = allocator.AllocateImageMemory(m_Image, tiling, usage, properties, category);
+}
+
+void Image::CreateUnboundImage(const uint32_t width, const uint32_t height, const uint32_t mipLevels, const VkSampleCountFlagBits numSamples, const VkFormat format,
+	const VkImageTiling tiling, const VkImageUsageFlags usage, const VkDevice device)
+{
+	m_pAllocator = nullptr;
+
 	VkImageCreateInfo imageInfo{};
 	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 	imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -31,20 +43,12 @@ void Image::CreateImage(const uint32_t width, const uint32_t height, const uint3
 	if (vkCreateImage(device, &imageInfo, nullptr, &m_Image) != VK_SUCCESS) {
 		throw std::runtime_error("failed to create image!");
 	}
+}
 
-	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(device, m_Image, &memRequirements);
-
-	VkMemoryAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = VkHelperFunctions::FindMemoryType(memRequirements.memoryTypeBits, properties, physicalDevice);
-
-	if (vkAllocateMemory(device, &allocInfo, nullptr, &m_ImageMemory) != VK_SUCCESS) {
-		throw std::runtime_error("failed to allocate image memory!");
-	}
-
-	vkBindImageMemory(device, m_Image, m_ImageMemory, 0);
+void Image::BindAliasedMemory(const VkDevice device, const MemoryAllocation& memory)
+{
+	m_ImageMemory = memory;
+	vkBindImageMemory(device, m_Image, memory.Memory, memory.Offset);
 }
 
 
@@ -71,5 +75,8 @@ void Image::DestroyImg(const VkDevice& device) const
 {
 	vkDestroyImageView(device, m_ImageView, nullptr);
 	vkDestroyImage(device, m_Image, nullptr);
-	vkFreeMemory(device, m_ImageMemory, nullptr);
+	if (m_pAllocator)
+	{
+		m_pAllocator->Free(m_ImageMemory);
+	}
 }
@@ -1,13 +1,20 @@
 #pragma once
 #include <vulkan/vulkan_core.h>
 
+#include "GGMemoryAllocator.h"
+
 namespace GG
 {
 	class Image
 	{
 	public:
+		// Attachments get a dedicated allocation, everything else is sub-allocated from the allocator's blocks
 		void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling,
-			VkImageUsageFlags usage, VkMemoryPropertyFlags properties, const VkDevice& device, const VkPhysicalDevice& physicalDevice);
+			VkImageUsageFlags usage, VkMemoryPropertyFlags properties, MemoryAllocator& allocator, MemoryCategory category);
+		void CreateUnboundImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling,
+			VkImageUsageFlags usage, VkDevice device);
+		// Memory shared with other images, owned and freed by whoever allocated it
+		void BindAliasedMemory(VkDevice device, const MemoryAllocation& memory);
 
 		void CreateImageView(VkFormat format,VkImageAspectFlags aspectFlags,uint32_t mipLevels, const VkDevice& device);
 
@@ -21,9 +28,10 @@ namespace GG
 		void DestroyImg(const VkDevice& device) const;
 
 	private:
-		VkImage m_Image;
-		VkDeviceMemory m_ImageMemory;
-		VkImageView m_ImageView;
+		VkImage m_Image = VK_NULL_HANDLE;
+		MemoryAllocation m_ImageMemory;
+		MemoryAllocator* m_pAllocator = nullptr; // nullptr while unbound or aliased
+		VkImageView m_ImageView = VK_NULL_HANDLE;
 		VkFormat m_Format;
 
 		VkImageLayout m_currentLayout;
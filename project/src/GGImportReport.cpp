@@ -0,0 +1,240 @@
+#include "GGImportReport.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "GGHalfFloat.h"
+#include "GGMipmaps.h"
+#include "GGSwizzle.h"
+
+using namespace GG;
+
+namespace
+{
+	// Keys are written in a fixed order with a fixed float precision, so unchanged values diff as unchanged lines
+	class JsonWriter
+	{
+	public:
+		explicit JsonWriter(std::ostream& stream) : m_Stream(stream)
+		{
+			m_Stream << std::fixed << std::setprecision(3);
+		}
+
+		void BeginObject(const char* key = nullptr) { Open(key, '{'); }
+		void EndObject() { Close('}'); }
+		void BeginArray(const char* key) { Open(key, '['); }
+		void EndArray() { Close(']'); }
+
+		void Value(const char* key, const std::string& value)
+		{
+			Key(key);
+			WriteString(value);
+		}
+		void Value(const char* key, const char* value) { Value(key, std::string(value)); }
+		void Value(const char* key, bool value)
+		{
+			Key(key);
+			m_Stream << (value ? "true" : "false");
+		}
+		void Value(const char* key, uint64_t value)
+		{
+			Key(key);
+			m_Stream << value;
+		}
+		void Value(const char* key, uint32_t value) { Value(key, static_cast<uint64_t>(value)); }
+		void Value(const char* key, float value)
+		{
+			Key(key);
+			m_Stream << value;
+		}
+
+	private:
+		void Open(const char* key, char bracket)
+		{
+			if (key)
+			{
+				Key(key);
+			}
+			else
+			{
+				Separate();
+			}
+			m_Stream << bracket;
+			m_IsFirst = true;
+			++m_Depth;
+		}
+
+		void Close(char bracket)
+		{
+			--m_Depth;
+			if (!m_IsFirst)
+			{
+				Indent();
+			}
+			m_Stream << bracket;
+			m_IsFirst = false;
+		}
+
+		void Separate()
+		{
+			if (m_Depth == 0) return;
+			if (!m_IsFirst)
+			{
+				m_Stream << ',';
+			}
+			Indent();
+			m_IsFirst = false;
+		}
+
+		void Indent()
+		{
+			m_Stream << '\n' << std::string(m_Depth * 2, ' ');
+		}
+
+		void Key(const char* key)
+		{
+			Separate();
+			WriteString(key);
+			m_Stream << ": ";
+		}
+
+		void WriteString(const std::string& value)
+		{
+			m_Stream << '"';
+			for (const char c : value)
+			{
+				switch (c)
+				{
+				case '"': m_Stream << "\\\""; break;
+				case '\\': m_Stream << "\\\\"; break;
+				case '\n': m_Stream << "\\n"; break;
+				case '\r': m_Stream << "\\r"; break;
+				case '\t': m_Stream << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						m_Stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+					}
+					else
+					{
+						m_Stream << c;
+					}
+				}
+			}
+			m_Stream << '"';
+		}
+
+		std::ostream& m_Stream;
+		uint32_t m_Depth = 0;
+		bool m_IsFirst = true;
+	};
+
+	void WritePhases(JsonWriter& json, const FileImportPhases& phases)
+	{
+		json.BeginObject("phasesMs");
+		json.Value("meshCacheLoad", phases.MeshCacheLoadMs);
+		json.Value("parse", phases.ParseMs);
+		json.Value("postProcess", phases.PostProcessMs);
+		json.Value("convert", phases.ConvertMs);
+		json.Value("deduplicate", phases.DeduplicateMs);
+		json.Value("optimize", phases.OptimizeMs);
+		json.Value("meshlets", phases.MeshletMs);
+		json.Value("lods", phases.LodMs);
+		json.Value("meshCacheWrite", phases.MeshCacheWriteMs);
+		json.EndObject();
+	}
+}
+
+bool ImportReport::Write(const std::string& path) const
+{
+	std::ostringstream stream;
+	JsonWriter json(stream);
+
+	json.BeginObject();
+	json.Value("version", 1u);
+
+	json.BeginObject("instructionSets");
+	json.Value("mipFilters", GetMipFilterInstructionSet());
+	json.Value("halfFloat", GetHalfFloatInstructionSet());
+	json.Value("swizzle", GetSwizzleInstructionSet());
+	json.EndObject();
+
+	json.BeginArray("files");
+	for (const FileImportRecord& file : m_Files)
+	{
+		json.BeginObject();
+		json.Value("path", file.FilePath);
+		json.Value("meshCacheHit", file.IsMeshCacheHit);
+		json.Value("bytesRead", file.BytesRead);
+		json.Value("meshes", file.MeshCount);
+		json.Value("vertices", file.VertexCount);
+		json.Value("indices", file.IndexCount);
+		json.Value("geometryBytes", file.GeometryBytes);
+		json.Value("textures", file.TextureCount);
+		json.Value("totalMs", file.TotalMs);
+		WritePhases(json, file.Phases);
+		json.EndObject();
+	}
+	json.EndArray();
+
+	json.BeginObject("meshUpload");
+	json.Value("vertexFormat", m_MeshUpload.VertexFormat);
+	json.Value("batched", m_MeshUpload.IsBatched);
+	json.Value("meshes", m_MeshUpload.MeshCount);
+	json.Value("vertexBytes", m_MeshUpload.VertexBytes);
+	json.Value("indexBytes", m_MeshUpload.IndexBytes);
+	json.Value("poolBytes", m_MeshUpload.PoolBytes);
+	json.Value("uploadMs", m_MeshUpload.UploadMs);
+	json.EndObject();
+
+	uint64_t decodedBytes = 0;
+	uint64_t uploadedBytes = 0;
+	for (const TextureRecord& texture : m_TextureLoad.Textures)
+	{
+		decodedBytes += texture.DecodedBytes;
+		uploadedBytes += texture.UploadedBytes;
+	}
+
+	json.BeginObject("textureLoad");
+	json.Value("threads", m_TextureLoad.ThreadCount);
+	json.Value("decodeSumMs", m_TextureLoad.DecodeSumMs);
+	json.Value("decodeWallMs", m_TextureLoad.DecodeWallMs);
+	json.Value("totalMs", m_TextureLoad.TotalMs);
+	json.Value("decodedBytes", decodedBytes);
+	json.Value("uploadedBytes", uploadedBytes);
+	json.BeginArray("textures");
+	for (const TextureRecord& texture : m_TextureLoad.Textures)
+	{
+		json.BeginObject();
+		json.Value("key", texture.Key);
+		json.Value("width", texture.Width);
+		json.Value("height", texture.Height);
+		json.Value("mipLevels", texture.MipLevels);
+		json.Value("firstMip", texture.FirstMip);
+		json.Value("format", texture.Format);
+		json.Value("cacheHit", texture.IsCacheHit);
+		json.Value("sourceBytes", texture.SourceBytes);
+		json.Value("decodedBytes", texture.DecodedBytes);
+		json.Value("uploadedBytes", texture.UploadedBytes);
+		json.BeginObject("phasesMs");
+		json.Value("decode", texture.DecodeMs);
+		json.Value("mipGeneration", texture.MipGenerationMs);
+		json.Value("compress", texture.CompressMs);
+		json.Value("upload", texture.UploadMs);
+		json.EndObject();
+		json.EndObject();
+	}
+	json.EndArray();
+	json.EndObject();
+
+	json.EndObject();
+	stream << '\n';
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	const std::string text = stream.str();
+	file.write(text.data(), static_cast<std::streamsize>(text.size()));
+	return static_cast<bool>(file);
+}
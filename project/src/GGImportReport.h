@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GG
+{
+	// Time spent in every phase of importing one file, per mesh phases are summed over the file's meshes
+	struct FileImportPhases
+	{
+		float MeshCacheLoadMs = 0.f;
+		float ParseMs = 0.f;            // Assimp reading the file
+		float PostProcessMs = 0.f;      // Assimp post processing steps
+		float ConvertMs = 0.f;          // aiMesh to Mesh and material lookups, includes decoding embedded textures
+		float DeduplicateMs = 0.f;
+		float OptimizeMs = 0.f;
+		float MeshletMs = 0.f;
+		float LodMs = 0.f;
+		float MeshCacheWriteMs = 0.f;
+	};
+
+	struct FileImportRecord
+	{
+		std::string FilePath;
+		bool IsMeshCacheHit = false;
+		uint64_t BytesRead = 0;         // The model file on a cold load, the cache file on a warm one
+		uint32_t MeshCount = 0;
+		uint64_t VertexCount = 0;
+		uint64_t IndexCount = 0;        // Of LOD 0 and every coarser LOD
+		uint64_t GeometryBytes = 0;     // CPU side Vertex and index data the import produced
+		uint32_t TextureCount = 0;      // Referenced by the file, default textures excluded
+		float TotalMs = 0.f;
+		FileImportPhases Phases;
+	};
+
+	struct TextureRecord
+	{
+		std::string Key;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t MipLevels = 0;
+		uint32_t FirstMip = 0;          // First uploaded mip, above 0 when the residency budget held finer mips back
+		const char* Format = "";
+		bool IsCacheHit = false;
+		uint64_t SourceBytes = 0;       // Size of the image file, 0 for textures created from memory
+		uint64_t DecodedBytes = 0;      // Every level as stored for the upload
+		uint64_t UploadedBytes = 0;
+		float DecodeMs = 0.f;           // Includes the mip generation and compression below
+		float MipGenerationMs = 0.f;
+		float CompressMs = 0.f;
+		float UploadMs = 0.f;           // Staging copy, transfer and layout transitions
+	};
+
+	struct TextureLoadRecord
+	{
+		uint32_t ThreadCount = 0;       // 0 when every texture decoded on the main thread
+		float DecodeSumMs = 0.f;
+		float DecodeWallMs = 0.f;
+		float TotalMs = 0.f;            // From CreateImages until the last texture was resident
+		std::vector<TextureRecord> Textures;
+	};
+
+	struct MeshUploadRecord
+	{
+		std::string VertexFormat;
+		bool IsBatched = false;
+		uint32_t MeshCount = 0;
+		uint64_t VertexBytes = 0;       // In the GPU vertex format
+		uint64_t IndexBytes = 0;
+		uint64_t PoolBytes = 0;         // Vertex and index pool size including headroom
+		float UploadMs = 0.f;
+	};
+
+	// Collects the load timings of a scene and writes them as JSON, so reports of two builds can be diffed
+	class ImportReport
+	{
+	public:
+		void AddFile(FileImportRecord record) { m_Files.push_back(std::move(record)); }
+		void SetTextureLoad(TextureLoadRecord record) { m_TextureLoad = std::move(record); }
+		void SetMeshUpload(MeshUploadRecord record) { m_MeshUpload = std::move(record); }
+
+		// Replaces the file at path, returns false when it could not be written
+		bool Write(const std::string& path) const;
+
+	private:
+		std::vector<FileImportRecord> m_Files;
+		TextureLoadRecord m_TextureLoad;
+		MeshUploadRecord m_MeshUpload;
+	};
+}
@@ -0,0 +1,105 @@
+#include "GGMappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace GG;
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_FileHandle = file;
+	m_MappingHandle = mapping;
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat {};
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (view == MAP_FAILED)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	m_FileDescriptor = fileDescriptor;
+	m_Data = static_cast<const uint8_t*>(view);
+	m_Size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_Data) UnmapViewOfFile(m_Data);
+	if (m_MappingHandle) CloseHandle(m_MappingHandle);
+	if (m_FileHandle) CloseHandle(m_FileHandle);
+
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+	if (m_FileDescriptor >= 0) close(m_FileDescriptor);
+
+	m_FileDescriptor = -1;
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
@@ -0,0 +1,589 @@
+#include "GGMemoryAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <stdexcept>
+
+#include "GGVkHelperFunctions.h"
+
+using namespace GG;
+
+namespace
+{
+	VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Without VK_EXT_memory_budget the rest of the system is unknown, stay clear of the whole heap like the driver would
+	constexpr VkDeviceSize GetFallbackBudget(VkDeviceSize heapSize)
+	{
+		return heapSize / 10 * 8;
+	}
+}
+
+const char* GG::GetMemoryCategoryName(const MemoryCategory category)
+{
+	switch (category)
+	{
+	case MemoryCategory::Geometry: return "geometry";
+	case MemoryCategory::Textures: return "textures";
+	case MemoryCategory::GBuffer: return "gbuffer";
+	case MemoryCategory::Uniforms: return "uniforms";
+	case MemoryCategory::Staging: return "staging";
+	default: return "unknown";
+	}
+}
+
+MemoryBlock::MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t poolIndex, void* pMapped):
+	m_Memory(memory), m_Size(size), m_MemoryTypeIndex(memoryTypeIndex), m_PoolIndex(poolIndex), m_pMapped(pMapped)
+{
+	for (auto& lists : m_FreeLists)
+	{
+		std::fill(std::begin(lists), std::end(lists), m_InvalidNode);
+	}
+
+	Node node{};
+	node.Size = size;
+	m_Nodes.push_back(node);
+	InsertFree(0);
+}
+
+void MemoryBlock::GetListIndex(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	if (size < (VkDeviceSize(1) << m_SmallSizeLog2))
+	{
+		firstLevel = 0;
+		secondLevel = static_cast<uint32_t>(size >> (m_SmallSizeLog2 - m_SecondLevelLog2));
+		return;
+	}
+
+	const uint32_t log2 = 63 - static_cast<uint32_t>(std::countl_zero(size));
+	firstLevel = log2 - m_SmallSizeLog2 + 1;
+	secondLevel = static_cast<uint32_t>(size >> (log2 - m_SecondLevelLog2)) & (m_SecondLevelCount - 1);
+}
+
+uint32_t MemoryBlock::FindFree(VkDeviceSize size, VkDeviceSize alignment) const
+{
+	// Start at the list above the one size falls in, every range there is at least size bytes
+	const uint32_t stepLog2 = size < (VkDeviceSize(1) << m_SmallSizeLog2)
+		? m_SmallSizeLog2 - m_SecondLevelLog2
+		: 63 - static_cast<uint32_t>(std::countl_zero(size)) - m_SecondLevelLog2;
+
+	uint32_t firstLevel, secondLevel;
+	GetListIndex(size + (VkDeviceSize(1) << stepLog2) - 1, firstLevel, secondLevel);
+
+	while (firstLevel < m_FirstLevelCount)
+	{
+		uint32_t secondLevelMap = secondLevel < m_SecondLevelCount ? m_SecondLevelBitmaps[firstLevel] & (~0u << secondLevel) : 0;
+		if (secondLevelMap == 0)
+		{
+			const uint64_t firstLevelMap = firstLevel + 1 < 64 ? m_FirstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+			if (firstLevelMap == 0) return m_InvalidNode;
+
+			firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+			secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+		}
+		secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+
+		// Large alignments can still push the range end past the node, those nodes are skipped
+		for (uint32_t node = m_FreeLists[firstLevel][secondLevel]; node != m_InvalidNode; node = m_Nodes[node].NextFree)
+		{
+			const Node& candidate = m_Nodes[node];
+			if (AlignUp(candidate.Offset, alignment) + size <= candidate.Offset + candidate.Size) return node;
+		}
+
+		++secondLevel;
+	}
+
+	return m_InvalidNode;
+}
+
+void MemoryBlock::InsertFree(uint32_t node)
+{
+	uint32_t firstLevel, secondLevel;
+	GetListIndex(m_Nodes[node].Size, firstLevel, secondLevel);
+
+	const uint32_t head = m_FreeLists[firstLevel][secondLevel];
+	m_Nodes[node].IsFree = true;
+	m_Nodes[node].PrevFree = m_InvalidNode;
+	m_Nodes[node].NextFree = head;
+	if (head != m_InvalidNode)
+	{
+		m_Nodes[head].PrevFree = node;
+	}
+
+	m_FreeLists[firstLevel][secondLevel] = node;
+	m_SecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	m_FirstLevelBitmap |= 1ull << firstLevel;
+}
+
+void MemoryBlock::RemoveFree(uint32_t node)
+{
+	Node& removed = m_Nodes[node];
+	if (removed.PrevFree != m_InvalidNode)
+	{
+		m_Nodes[removed.PrevFree].NextFree = removed.NextFree;
+	}
+	else
+	{
+		uint32_t firstLevel, secondLevel;
+		GetListIndex(removed.Size, firstLevel, secondLevel);
+
+		m_FreeLists[firstLevel][secondLevel] = removed.NextFree;
+		if (removed.NextFree == m_InvalidNode)
+		{
+			m_SecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+			if (m_SecondLevelBitmaps[firstLevel] == 0)
+			{
+				m_FirstLevelBitmap &= ~(1ull << firstLevel);
+			}
+		}
+	}
+
+	if (removed.NextFree != m_InvalidNode)
+	{
+		m_Nodes[removed.NextFree].PrevFree = removed.PrevFree;
+	}
+
+	removed.IsFree = false;
+	removed.PrevFree = m_InvalidNode;
+	removed.NextFree = m_InvalidNode;
+}
+
+// Cuts node down to size bytes and returns a new node for the remainder, neither is in a free list afterwards
+uint32_t MemoryBlock::Split(uint32_t node, VkDeviceSize size)
+{
+	uint32_t remainder;
+	if (!m_UnusedNodes.empty())
+	{
+		remainder = m_UnusedNodes.back();
+		m_UnusedNodes.pop_back();
+	}
+	else
+	{
+		remainder = static_cast<uint32_t>(m_Nodes.size());
+		m_Nodes.emplace_back();
+	}
+
+	Node& first = m_Nodes[node];
+	Node& second = m_Nodes[remainder];
+	second = Node{};
+	second.Offset = first.Offset + size;
+	second.Size = first.Size - size;
+	second.PrevPhysical = node;
+	second.NextPhysical = first.NextPhysical;
+
+	if (first.NextPhysical != m_InvalidNode)
+	{
+		m_Nodes[first.NextPhysical].PrevPhysical = remainder;
+	}
+	first.NextPhysical = remainder;
+	first.Size = size;
+
+	return remainder;
+}
+
+void MemoryBlock::MergeWithNext(uint32_t node)
+{
+	const uint32_t next = m_Nodes[node].NextPhysical;
+	Node& merged = m_Nodes[node];
+
+	merged.Size += m_Nodes[next].Size;
+	merged.NextPhysical = m_Nodes[next].NextPhysical;
+	if (merged.NextPhysical != m_InvalidNode)
+	{
+		m_Nodes[merged.NextPhysical].PrevPhysical = node;
+	}
+
+	m_Nodes[next] = Node{};
+	m_UnusedNodes.push_back(next);
+}
+
+bool MemoryBlock::Allocate(VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& allocation)
+{
+	uint32_t node = FindFree(size, alignment);
+	if (node == m_InvalidNode) return false;
+
+	RemoveFree(node);
+
+	// The alignment gap in front stays free and merges back when a neighbour is freed
+	const VkDeviceSize padding = AlignUp(m_Nodes[node].Offset, alignment) - m_Nodes[node].Offset;
+	if (padding > 0)
+	{
+		const uint32_t gap = node;
+		node = Split(gap, padding);
+		InsertFree(gap);
+	}
+
+	if (m_Nodes[node].Size - size >= m_MinSplitSize)
+	{
+		InsertFree(Split(node, size));
+	}
+
+	m_Nodes[node].RequestedSize = size;
+
+	++m_AllocationCount;
+	m_UsedBytes += size;
+	m_AllocatedBytes += m_Nodes[node].Size;
+
+	allocation.Memory = m_Memory;
+	allocation.Offset = m_Nodes[node].Offset;
+	allocation.Size = size;
+	allocation.pMapped = m_pMapped ? static_cast<uint8_t*>(m_pMapped) + allocation.Offset : nullptr;
+	allocation.pBlock = this;
+	allocation.Node = node;
+	allocation.MemoryTypeIndex = m_MemoryTypeIndex;
+	return true;
+}
+
+void MemoryBlock::Free(uint32_t node)
+{
+	--m_AllocationCount;
+	m_UsedBytes -= m_Nodes[node].RequestedSize;
+	m_AllocatedBytes -= m_Nodes[node].Size;
+	m_Nodes[node].RequestedSize = 0;
+
+	const uint32_t next = m_Nodes[node].NextPhysical;
+	if (next != m_InvalidNode && m_Nodes[next].IsFree)
+	{
+		RemoveFree(next);
+		MergeWithNext(node);
+	}
+
+	const uint32_t previous = m_Nodes[node].PrevPhysical;
+	if (previous != m_InvalidNode && m_Nodes[previous].IsFree)
+	{
+		RemoveFree(previous);
+		MergeWithNext(previous);
+		node = previous;
+	}
+
+	InsertFree(node);
+}
+
+void MemoryBlock::AddStats(MemoryAllocatorStats& stats) const
+{
+	++stats.BlockCount;
+	stats.BlockBytes += m_Size;
+	stats.AllocationCount += m_AllocationCount;
+	stats.UsedBytes += m_UsedBytes;
+	stats.WastedBytes += m_AllocatedBytes - m_UsedBytes;
+	stats.FreeBytes += m_Size - m_AllocatedBytes;
+
+	for (uint32_t node = 0; node != m_InvalidNode; node = m_Nodes[node].NextPhysical)
+	{
+		if (!m_Nodes[node].IsFree) continue;
+
+		++stats.FreeRangeCount;
+		stats.LargestFreeRange = std::max(stats.LargestFreeRange, m_Nodes[node].Size);
+	}
+}
+
+void MemoryAllocator::Initialize(VkDevice device, VkPhysicalDevice physicalDevice, bool isMemoryBudgetEnabled)
+{
+	m_Device = device;
+	m_PhysicalDevice = physicalDevice;
+	m_IsMemoryBudgetEnabled = isMemoryBudgetEnabled;
+
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	m_BufferImageGranularity = properties.limits.bufferImageGranularity;
+	m_MaxDeviceMemoryCount = properties.limits.maxMemoryAllocationCount;
+
+	UpdateBudget();
+}
+
+void MemoryAllocator::Destroy()
+{
+	std::lock_guard lock(m_Mutex);
+
+	uint32_t liveAllocations = m_DedicatedCount;
+	for (auto& pool : m_Pools)
+	{
+		for (const auto& block : pool)
+		{
+			MemoryAllocatorStats stats{};
+			block->AddStats(stats);
+			liveAllocations += stats.AllocationCount;
+
+			FreeDeviceMemory(block->GetMemory(), block->GetSize(), block->GetMemoryTypeIndex(), block->GetMapped());
+		}
+		pool.clear();
+	}
+
+	if (liveAllocations > 0)
+	{
+		std::cerr << "WARNING: " << liveAllocations << " device memory allocations were not freed before the allocator was destroyed\n";
+	}
+}
+
+MemoryAllocation MemoryAllocator::AllocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryCategory category)
+{
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(m_Device, buffer, &requirements);
+
+	const MemoryAllocation allocation = Allocate(requirements, properties, category, true, false, VK_NULL_HANDLE, buffer);
+	vkBindBufferMemory(m_Device, buffer, allocation.Memory, allocation.Offset);
+	return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateImageMemory(VkImage image, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+	MemoryCategory category)
+{
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(m_Device, image, &requirements);
+
+	if ((usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) && HasMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+	{
+		properties = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+	}
+
+	const bool isRenderTarget = usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	const MemoryAllocation allocation = Allocate(requirements, properties, category, tiling == VK_IMAGE_TILING_LINEAR, isRenderTarget, image, VK_NULL_HANDLE);
+	vkBindImageMemory(m_Device, image, allocation.Memory, allocation.Offset);
+	return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category)
+{
+	return Allocate(requirements, properties, category, false, true, VK_NULL_HANDLE, VK_NULL_HANDLE);
+}
+
+bool MemoryAllocator::HasMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags properties) const
+{
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		if ((memoryTypeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties) return true;
+	}
+	return false;
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category,
+	bool isLinear, bool isDedicated, VkImage dedicatedImage, VkBuffer dedicatedBuffer)
+{
+	const uint32_t memoryTypeIndex = VkHelperFunctions::FindMemoryType(requirements.memoryTypeBits, properties, m_PhysicalDevice);
+	const VkDeviceSize blockSize = GetBlockSize(memoryTypeIndex);
+
+	std::lock_guard lock(m_Mutex);
+
+	m_CategoryBytes[static_cast<size_t>(category)] += requirements.size;
+
+	MemoryAllocation allocation{};
+	allocation.Category = category;
+	if (isDedicated || requirements.size > blockSize / 2)
+	{
+		VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+		dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedInfo.image = dedicatedImage;
+		dedicatedInfo.buffer = dedicatedBuffer;
+
+		const bool isBoundToOne = dedicatedImage != VK_NULL_HANDLE || dedicatedBuffer != VK_NULL_HANDLE;
+		allocation.Memory = AllocateDeviceMemory(requirements.size, memoryTypeIndex, isBoundToOne ? &dedicatedInfo : nullptr, allocation.pMapped);
+		allocation.Size = requirements.size;
+		allocation.MemoryTypeIndex = memoryTypeIndex;
+
+		++m_DedicatedCount;
+		m_DedicatedBytes += requirements.size;
+		return allocation;
+	}
+
+	// Without a granularity restriction buffers and optimal images can share blocks
+	const bool isLinearPool = isLinear || m_BufferImageGranularity <= 1;
+	const uint32_t poolIndex = memoryTypeIndex * 2 + (isLinearPool ? 0 : 1);
+	auto& pool = m_Pools[poolIndex];
+
+	for (const auto& block : pool)
+	{
+		if (block->Allocate(requirements.size, requirements.alignment, allocation)) return allocation;
+	}
+
+	void* pMapped = nullptr;
+	const VkDeviceMemory memory = AllocateDeviceMemory(blockSize, memoryTypeIndex, nullptr, pMapped);
+	pool.push_back(std::make_unique<MemoryBlock>(memory, blockSize, memoryTypeIndex, poolIndex, pMapped));
+
+	if (!pool.back()->Allocate(requirements.size, requirements.alignment, allocation))
+	{
+		throw std::runtime_error("failed to sub-allocate from a new memory block!");
+	}
+	return allocation;
+}
+
+void MemoryAllocator::Free(const MemoryAllocation& allocation)
+{
+	if (!allocation.IsValid()) return;
+
+	std::lock_guard lock(m_Mutex);
+
+	m_CategoryBytes[static_cast<size_t>(allocation.Category)] -= allocation.Size;
+
+	if (allocation.IsDedicated())
+	{
+		FreeDeviceMemory(allocation.Memory, allocation.Size, allocation.MemoryTypeIndex, allocation.pMapped);
+		--m_DedicatedCount;
+		m_DedicatedBytes -= allocation.Size;
+		return;
+	}
+
+	MemoryBlock* pBlock = allocation.pBlock;
+	pBlock->Free(allocation.Node);
+	if (!pBlock->IsEmpty()) return;
+
+	// Keep one empty block per pool around so a resource that is recreated every frame does not hit vkAllocateMemory
+	auto& pool = m_Pools[pBlock->GetPoolIndex()];
+	const bool hasOtherEmptyBlock = std::any_of(pool.begin(), pool.end(),
+		[pBlock](const std::unique_ptr<MemoryBlock>& block) { return block.get() != pBlock && block->IsEmpty(); });
+	if (!hasOtherEmptyBlock) return;
+
+	FreeDeviceMemory(pBlock->GetMemory(), pBlock->GetSize(), pBlock->GetMemoryTypeIndex(), pBlock->GetMapped());
+	std::erase_if(pool, [pBlock](const std::unique_ptr<MemoryBlock>& block) { return block.get() == pBlock; });
+}
+
+MemoryAllocatorStats MemoryAllocator::GetStats() const
+{
+	std::lock_guard lock(m_Mutex);
+
+	MemoryAllocatorStats stats{};
+	for (const auto& pool : m_Pools)
+	{
+		for (const auto& block : pool)
+		{
+			block->AddStats(stats);
+		}
+	}
+
+	stats.DedicatedCount = m_DedicatedCount;
+	stats.DedicatedBytes = m_DedicatedBytes;
+	stats.AllocationCount += m_DedicatedCount;
+	stats.DeviceMemoryCount = stats.BlockCount + m_DedicatedCount;
+	stats.MaxDeviceMemoryCount = m_MaxDeviceMemoryCount;
+	return stats;
+}
+
+void MemoryAllocator::UpdateBudget()
+{
+	if (m_IsMemoryBudgetEnabled)
+	{
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+		budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+		memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memoryProperties.pNext = &budgetProperties;
+		vkGetPhysicalDeviceMemoryProperties2(m_PhysicalDevice, &memoryProperties);
+
+		std::lock_guard lock(m_Mutex);
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryHeapCount; ++i)
+		{
+			m_DriverUsage[i] = budgetProperties.heapUsage[i];
+			m_DriverBudget[i] = budgetProperties.heapBudget[i];
+			m_HeapBytesAtQuery[i] = m_HeapBytes[i];
+		}
+	}
+
+	if (!m_BudgetCallback) return;
+
+	const MemoryBudget budget = GetBudget();
+	for (uint32_t i = 0; i < budget.HeapCount; ++i)
+	{
+		const MemoryHeapBudget& heap = budget.Heaps[i];
+		const bool isOverThreshold = static_cast<float>(heap.Usage) > static_cast<float>(heap.Budget) * m_BudgetThreshold;
+		if (isOverThreshold == m_IsOverThreshold[i]) continue;
+
+		m_IsOverThreshold[i] = isOverThreshold;
+		m_BudgetCallback(i, heap, isOverThreshold);
+	}
+}
+
+MemoryBudget MemoryAllocator::GetBudget() const
+{
+	std::lock_guard lock(m_Mutex);
+
+	MemoryBudget budget{};
+	budget.HeapCount = m_MemoryProperties.memoryHeapCount;
+	budget.IsReportedByDriver = m_IsMemoryBudgetEnabled;
+	std::copy(std::begin(m_CategoryBytes), std::end(m_CategoryBytes), budget.CategoryBytes);
+
+	for (uint32_t i = 0; i < budget.HeapCount; ++i)
+	{
+		MemoryHeapBudget& heap = budget.Heaps[i];
+		heap.Size = m_MemoryProperties.memoryHeaps[i].size;
+		heap.IsDeviceLocal = m_MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+		heap.AllocatorBytes = m_HeapBytes[i];
+
+		if (!m_IsMemoryBudgetEnabled)
+		{
+			heap.Usage = m_HeapBytes[i];
+			heap.Budget = GetFallbackBudget(heap.Size);
+			continue;
+		}
+
+		if (m_HeapBytes[i] >= m_HeapBytesAtQuery[i])
+		{
+			heap.Usage = m_DriverUsage[i] + (m_HeapBytes[i] - m_HeapBytesAtQuery[i]);
+		}
+		else
+		{
+			const VkDeviceSize freedSinceQuery = m_HeapBytesAtQuery[i] - m_HeapBytes[i];
+			heap.Usage = m_DriverUsage[i] > freedSinceQuery ? m_DriverUsage[i] - freedSinceQuery : 0;
+		}
+		heap.Budget = m_DriverBudget[i];
+	}
+
+	return budget;
+}
+
+void MemoryAllocator::SetBudgetCallback(float threshold, BudgetCallback callback)
+{
+	m_BudgetThreshold = threshold;
+	m_BudgetCallback = std::move(callback);
+	std::fill(std::begin(m_IsOverThreshold), std::end(m_IsOverThreshold), false);
+}
+
+VkDeviceMemory MemoryAllocator::AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, const void* pNext, void*& pMapped)
+{
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.pNext = pNext;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+	VkDeviceMemory memory;
+	if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate device memory!");
+	}
+	m_HeapBytes[m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += size;
+
+	pMapped = nullptr;
+	if (m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		if (vkMapMemory(m_Device, memory, 0, VK_WHOLE_SIZE, 0, &pMapped) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to map device memory!");
+		}
+	}
+
+	return memory;
+}
+
+void MemoryAllocator::FreeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, void* pMapped)
+{
+	m_HeapBytes[m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] -= size;
+
+	if (pMapped)
+	{
+		vkUnmapMemory(m_Device, memory);
+	}
+	vkFreeMemory(m_Device, memory, nullptr);
+}
+
+VkDeviceSize MemoryAllocator::GetBlockSize(uint32_t memoryTypeIndex) const
+{
+	// Small heaps such as the host visible device local window get smaller blocks so one block can't claim most of it
+	const uint32_t heapIndex = m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+	return std::min(m_PreferredBlockSize, m_MemoryProperties.memoryHeaps[heapIndex].size / 8);
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace GG
+{
+	class MemoryBlock;
+
+	// Which subsystem an allocation belongs to, for the per subsystem totals of MemoryBudget
+	enum class MemoryCategory : uint8_t
+	{
+		Geometry,
+		Textures,
+		GBuffer,    // The G-buffer and every other per frame render target
+		Uniforms,
+		Staging,
+		Count
+	};
+
+	const char* GetMemoryCategoryName(MemoryCategory category);
+
+	// A range inside a shared VkDeviceMemory block, or a whole VkDeviceMemory for dedicated allocations
+	struct MemoryAllocation
+	{
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		VkDeviceSize Offset = 0;
+		VkDeviceSize Size = 0;
+		void* pMapped = nullptr; // Points at Offset when the memory is host visible, blocks stay mapped for their lifetime
+
+		MemoryBlock* pBlock = nullptr; // nullptr for dedicated allocations
+		uint32_t Node = 0;
+		uint32_t MemoryTypeIndex = 0;
+		MemoryCategory Category = MemoryCategory::Count;
+
+		bool IsValid() const { return Memory != VK_NULL_HANDLE; }
+		bool IsDedicated() const { return IsValid() && pBlock == nullptr; }
+	};
+
+	struct MemoryAllocatorStats
+	{
+		uint32_t BlockCount = 0;
+		uint32_t DedicatedCount = 0;
+		uint32_t AllocationCount = 0;
+		uint32_t DeviceMemoryCount = 0;
+		uint32_t MaxDeviceMemoryCount = 0;
+
+		VkDeviceSize BlockBytes = 0;
+		VkDeviceSize DedicatedBytes = 0;
+		VkDeviceSize UsedBytes = 0;
+		VkDeviceSize WastedBytes = 0; // Tails too small to split off, kept inside their allocation
+		VkDeviceSize FreeBytes = 0;
+		VkDeviceSize LargestFreeRange = 0;
+		uint32_t FreeRangeCount = 0;
+
+		// 0 when the free space of every block is one range, approaches 1 as it splits into many small ranges
+		float GetFragmentation() const { return FreeBytes > 0 ? 1.f - static_cast<float>(LargestFreeRange) / static_cast<float>(FreeBytes) : 0.f; }
+	};
+
+	struct MemoryHeapBudget
+	{
+		VkDeviceSize Usage = 0;             // Whole process, from VK_EXT_memory_budget when available, otherwise only this allocator
+		VkDeviceSize Budget = 0;            // What the driver lets the process use before it starts paging
+		VkDeviceSize Size = 0;
+		VkDeviceSize AllocatorBytes = 0;    // VkDeviceMemory owned by this allocator, blocks count in full
+		bool IsDeviceLocal = false;
+
+		float GetUsageRatio() const { return Budget > 0 ? static_cast<float>(Usage) / static_cast<float>(Budget) : 0.f; }
+	};
+
+	struct MemoryBudget
+	{
+		MemoryHeapBudget Heaps[VK_MAX_MEMORY_HEAPS];
+		uint32_t HeapCount = 0;
+		VkDeviceSize CategoryBytes[static_cast<size_t>(MemoryCategory::Count)]{}; // Requested bytes of live allocations
+		bool IsReportedByDriver = false;
+	};
+
+	// Two level segregated fit (TLSF) allocator over one VkDeviceMemory: a free range of at least the requested size
+	// is found with two bitmap scans, neighbouring free ranges are merged on Free
+	class MemoryBlock
+	{
+	public:
+		MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t poolIndex, void* pMapped);
+
+		bool Allocate(VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation& allocation);
+		void Free(uint32_t node);
+
+		VkDeviceMemory GetMemory() const { return m_Memory; }
+		VkDeviceSize GetSize() const { return m_Size; }
+		uint32_t GetPoolIndex() const { return m_PoolIndex; }
+		uint32_t GetMemoryTypeIndex() const { return m_MemoryTypeIndex; }
+		void* GetMapped() const { return m_pMapped; }
+		bool IsEmpty() const { return m_AllocationCount == 0; }
+
+		void AddStats(MemoryAllocatorStats& stats) const;
+
+	private:
+		static constexpr uint32_t m_InvalidNode = UINT32_MAX;
+		static constexpr uint32_t m_SecondLevelLog2 = 3;
+		static constexpr uint32_t m_SecondLevelCount = 1u << m_SecondLevelLog2;
+		static constexpr uint32_t m_SmallSizeLog2 = 8; // Sizes below 256 bytes share first level 0 in 32 byte steps
+		static constexpr uint32_t m_FirstLevelCount = 64 - m_SmallSizeLog2 + 1;
+		static constexpr VkDeviceSize m_MinSplitSize = 256;
+
+		struct Node
+		{
+			VkDeviceSize Offset = 0;
+			VkDeviceSize Size = 0;
+			VkDeviceSize RequestedSize = 0;
+			uint32_t PrevPhysical = m_InvalidNode;
+			uint32_t NextPhysical = m_InvalidNode;
+			uint32_t PrevFree = m_InvalidNode;
+			uint32_t NextFree = m_InvalidNode;
+			bool IsFree = false;
+		};
+
+		static void GetListIndex(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+		uint32_t FindFree(VkDeviceSize size, VkDeviceSize alignment) const;
+		void InsertFree(uint32_t node);
+		void RemoveFree(uint32_t node);
+		uint32_t Split(uint32_t node, VkDeviceSize size);
+		void MergeWithNext(uint32_t node);
+
+		std::vector<Node> m_Nodes; // Node 0 always starts at offset 0
+		std::vector<uint32_t> m_UnusedNodes;
+
+		uint64_t m_FirstLevelBitmap = 0;
+		uint32_t m_SecondLevelBitmaps[m_FirstLevelCount]{};
+		uint32_t m_FreeLists[m_FirstLevelCount][m_SecondLevelCount];
+
+		VkDeviceMemory m_Memory;
+		VkDeviceSize m_Size;
+		uint32_t m_MemoryTypeIndex;
+		uint32_t m_PoolIndex;
+		void* m_pMapped;
+
+		uint32_t m_AllocationCount = 0;
+		VkDeviceSize m_UsedBytes = 0;
+		VkDeviceSize m_AllocatedBytes = 0;
+	};
+
+	// Sub-allocates buffers and images from large blocks per memory type instead of one vkAllocateMemory per resource
+	class MemoryAllocator
+	{
+	public:
+		MemoryAllocator() = default;
+		MemoryAllocator(const MemoryAllocator&) = delete;
+		MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+		// Called when a heap's usage crosses the threshold in either direction
+		using BudgetCallback = std::function<void(uint32_t heapIndex, const MemoryHeapBudget& heap, bool isOverThreshold)>;
+
+		void Initialize(VkDevice device, VkPhysicalDevice physicalDevice, bool isMemoryBudgetEnabled);
+		void Destroy();
+
+		// Allocates and binds memory, render targets and resources larger than half a block get a dedicated VkDeviceMemory.
+		// Transient attachments use lazily allocated memory when the device has a matching type
+		MemoryAllocation AllocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryCategory category);
+		MemoryAllocation AllocateImageMemory(VkImage image, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+			MemoryCategory category);
+		// A standalone VkDeviceMemory that the caller binds itself, e.g. to alias several images
+		MemoryAllocation AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category);
+		void Free(const MemoryAllocation& allocation);
+
+		bool HasMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags properties) const;
+
+		MemoryAllocatorStats GetStats() const;
+
+		// Queries the driver's budget and fires the callback for heaps that crossed the threshold since the last call.
+		// Meant to be called once a frame, the callback runs on the calling thread outside the allocator's lock
+		void UpdateBudget();
+		// Driver numbers from the last UpdateBudget, corrected by what this allocator allocated and freed since
+		MemoryBudget GetBudget() const;
+		// threshold is a fraction of each heap's budget
+		void SetBudgetCallback(float threshold, BudgetCallback callback);
+
+		VkDevice GetDevice() const { return m_Device; }
+		VkPhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }
+
+	private:
+		MemoryAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryCategory category,
+			bool isLinear, bool isDedicated, VkImage dedicatedImage, VkBuffer dedicatedBuffer);
+		VkDeviceMemory AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, const void* pNext, void*& pMapped);
+		void FreeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, void* pMapped);
+		VkDeviceSize GetBlockSize(uint32_t memoryTypeIndex) const;
+
+		static constexpr VkDeviceSize m_PreferredBlockSize = 64ull * 1024 * 1024;
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+		VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+		VkDeviceSize m_BufferImageGranularity = 1;
+		uint32_t m_MaxDeviceMemoryCount = 0;
+
+		// Two pools per memory type: linear resources (buffers, linear images) and optimal tiling images, so that
+		// bufferImageGranularity never has to be honoured between neighbours inside a block
+		std::vector<std::unique_ptr<MemoryBlock>> m_Pools[VK_MAX_MEMORY_TYPES * 2];
+
+		uint32_t m_DedicatedCount = 0;
+		VkDeviceSize m_DedicatedBytes = 0;
+
+		// Budget tracking, the driver's usage only changes on UpdateBudget so allocations in between are added on top
+		bool m_IsMemoryBudgetEnabled = false;
+		VkDeviceSize m_HeapBytes[VK_MAX_MEMORY_HEAPS]{};
+		VkDeviceSize m_HeapBytesAtQuery[VK_MAX_MEMORY_HEAPS]{};
+		VkDeviceSize m_DriverUsage[VK_MAX_MEMORY_HEAPS]{};
+		VkDeviceSize m_DriverBudget[VK_MAX_MEMORY_HEAPS]{};
+		VkDeviceSize m_CategoryBytes[static_cast<size_t>(MemoryCategory::Count)]{};
+
+		float m_BudgetThreshold = 0.9f;
+		BudgetCallback m_BudgetCallback;
+		bool m_IsOverThreshold[VK_MAX_MEMORY_HEAPS]{};
+
+		mutable std::mutex m_Mutex;
+	};
+}
@@ -0,0 +1,366 @@
+#include "GGMeshCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+using namespace GG;
+
+namespace
+{
+	struct MeshCacheHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint64_t SourceHash;
+		uint64_t SourceSize;
+		uint32_t ImportFlags;
+		uint32_t VertexStride;
+		uint32_t MeshCount;
+		uint32_t TextureCount;
+		float ColdLoadMs;
+		uint32_t DependencyCount;
+		uint64_t MeshTableOffset;
+		uint64_t TextureTableOffset;
+		uint64_t DependencyTableOffset;
+	};
+
+	struct MeshCacheEntry
+	{
+		uint64_t VertexOffset;
+		uint64_t IndexOffset;
+		uint64_t MeshletOffset;
+		uint64_t LodOffset;
+		uint32_t VertexCount;
+		uint32_t IndexCount;
+		uint32_t MeshletCount;
+		uint32_t LodCount;
+		float BoundingSphere[4];
+		uint32_t MaterialIndices[4];
+		float ModelMatrix[16];
+		float UvDensity;
+		uint32_t Padding;
+	};
+
+	struct TextureCacheEntry
+	{
+		uint64_t KeyOffset;
+		uint64_t DataOffset;
+		uint64_t DataSize;
+		uint32_t KeyLength;
+		uint32_t Format;
+		uint32_t IsEmbedded;
+		uint32_t EmbeddedWidth;
+		uint32_t EmbeddedHeight;
+		uint32_t Padding;
+	};
+
+	struct DependencyCacheEntry
+	{
+		uint64_t PathOffset;
+		uint64_t Hash;
+		uint64_t Size;
+		uint32_t PathLength;
+		uint32_t Padding;
+	};
+
+	constexpr char CacheMagic[4] = { 'G', 'G', 'M', 'C' };
+	constexpr size_t BlobAlignment = 16;
+
+	// FNV-1a over 64 bit words, the tail is folded in byte by byte
+	uint64_t HashBytes(const uint8_t* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		size_t i = 0;
+
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, data + i, sizeof(word));
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+
+		for (; i < size; ++i)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	bool HashFile(const std::string& path, uint64_t& hash, uint64_t& size)
+	{
+		MappedFile file;
+		if (!file.Open(path)) return false;
+
+		hash = HashBytes(file.GetData(), file.GetSize());
+		size = file.GetSize();
+		return true;
+	}
+
+	bool IsRangeValid(uint64_t offset, uint64_t size, size_t fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+}
+
+MeshCache::MeshCache(const std::string& sourcePath, uint32_t importFlags)
+	: m_SourcePath(sourcePath), m_CachePath(sourcePath + ".ggmesh"), m_ImportFlags(importFlags)
+{
+}
+
+bool MeshCache::HashSourceFile()
+{
+	if (m_IsSourceHashed) return true;
+
+	m_IsSourceHashed = HashFile(m_SourcePath, m_SourceHash, m_SourceSize);
+	return m_IsSourceHashed;
+}
+
+bool MeshCache::Load()
+{
+	m_Meshes.clear();
+	m_Textures.clear();
+
+	if (!HashSourceFile() || !m_MappedFile.Open(m_CachePath))
+	{
+		return false;
+	}
+
+	const uint8_t* data = m_MappedFile.GetData();
+	const size_t fileSize = m_MappedFile.GetSize();
+
+	MeshCacheHeader header{};
+	if (fileSize < sizeof(header))
+	{
+		m_MappedFile.Close();
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+
+	if (memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.Version != m_Version || header.VertexStride != sizeof(Vertex) ||
+		header.ImportFlags != m_ImportFlags || header.SourceHash != m_SourceHash || header.SourceSize != m_SourceSize)
+	{
+		std::cout << "[MeshCache] " << m_CachePath << " is stale, re-importing " << m_SourcePath << "\n";
+		m_MappedFile.Close();
+		return false;
+	}
+
+	if (!IsRangeValid(header.MeshTableOffset, static_cast<uint64_t>(header.MeshCount) * sizeof(MeshCacheEntry), fileSize) ||
+		!IsRangeValid(header.TextureTableOffset, static_cast<uint64_t>(header.TextureCount) * sizeof(TextureCacheEntry), fileSize) ||
+		!IsRangeValid(header.DependencyTableOffset, static_cast<uint64_t>(header.DependencyCount) * sizeof(DependencyCacheEntry), fileSize))
+	{
+		std::cerr << "WARNING: Corrupt mesh cache: " << m_CachePath << "\n";
+		m_MappedFile.Close();
+		return false;
+	}
+
+	// An edited or deleted glTF buffer or material library has to invalidate the cache just like the source itself
+	m_DependencyPaths.clear();
+	for (uint32_t i = 0; i < header.DependencyCount; ++i)
+	{
+		DependencyCacheEntry entry;
+		memcpy(&entry, data + header.DependencyTableOffset + i * sizeof(DependencyCacheEntry), sizeof(entry));
+
+		if (!IsRangeValid(entry.PathOffset, entry.PathLength, fileSize))
+		{
+			std::cerr << "WARNING: Corrupt mesh cache: " << m_CachePath << "\n";
+			m_DependencyPaths.clear();
+			m_MappedFile.Close();
+			return false;
+		}
+
+		const std::string& path = m_DependencyPaths.emplace_back(reinterpret_cast<const char*>(data + entry.PathOffset), entry.PathLength);
+		uint64_t hash = 0;
+		uint64_t size = 0;
+		if (!HashFile(path, hash, size) || hash != entry.Hash || size != entry.Size)
+		{
+			std::cout << "[MeshCache] " << m_CachePath << " is stale (" << path << " changed), re-importing " << m_SourcePath << "\n";
+			m_DependencyPaths.clear();
+			m_MappedFile.Close();
+			return false;
+		}
+	}
+
+	m_Meshes.reserve(header.MeshCount);
+	for (uint32_t i = 0; i < header.MeshCount; ++i)
+	{
+		MeshCacheEntry entry;
+		memcpy(&entry, data + header.MeshTableOffset + i * sizeof(MeshCacheEntry), sizeof(entry));
+
+		if (!IsRangeValid(entry.VertexOffset, static_cast<uint64_t>(entry.VertexCount) * sizeof(Vertex), fileSize) ||
+			!IsRangeValid(entry.IndexOffset, static_cast<uint64_t>(entry.IndexCount) * sizeof(uint32_t), fileSize) ||
+			!IsRangeValid(entry.MeshletOffset, static_cast<uint64_t>(entry.MeshletCount) * sizeof(Meshlet), fileSize) ||
+			!IsRangeValid(entry.LodOffset, static_cast<uint64_t>(entry.LodCount) * sizeof(MeshLod), fileSize))
+		{
+			std::cerr << "WARNING: Corrupt mesh cache: " << m_CachePath << "\n";
+			m_Meshes.clear();
+			m_MappedFile.Close();
+			return false;
+		}
+
+		CachedMesh& mesh = m_Meshes.emplace_back();
+		mesh.Vertices = { reinterpret_cast<const Vertex*>(data + entry.VertexOffset), entry.VertexCount };
+		mesh.Indices = { reinterpret_cast<const uint32_t*>(data + entry.IndexOffset), entry.IndexCount };
+		mesh.Meshlets = { reinterpret_cast<const Meshlet*>(data + entry.MeshletOffset), entry.MeshletCount };
+		mesh.Lods = { reinterpret_cast<const MeshLod*>(data + entry.LodOffset), entry.LodCount };
+		memcpy(&mesh.BoundingSphere[0], entry.BoundingSphere, sizeof(entry.BoundingSphere));
+		mesh.UvDensity = entry.UvDensity;
+		mesh.MaterialIndices.albedoTexIdx = entry.MaterialIndices[0];
+		mesh.MaterialIndices.normalTexIdx = entry.MaterialIndices[1];
+		mesh.MaterialIndices.metallicRoughnessTexIdx = entry.MaterialIndices[2];
+		mesh.MaterialIndices.aoTexIdx = entry.MaterialIndices[3];
+		memcpy(&mesh.ModelMatrix[0][0], entry.ModelMatrix, sizeof(entry.ModelMatrix));
+	}
+
+	m_Textures.reserve(header.TextureCount);
+	for (uint32_t i = 0; i < header.TextureCount; ++i)
+	{
+		TextureCacheEntry entry;
+		memcpy(&entry, data + header.TextureTableOffset + i * sizeof(TextureCacheEntry), sizeof(entry));
+
+		if (!IsRangeValid(entry.KeyOffset, entry.KeyLength, fileSize) || !IsRangeValid(entry.DataOffset, entry.DataSize, fileSize))
+		{
+			std::cerr << "WARNING: Corrupt mesh cache: " << m_CachePath << "\n";
+			m_Meshes.clear();
+			m_Textures.clear();
+			m_MappedFile.Close();
+			return false;
+		}
+
+		CachedTexture& texture = m_Textures.emplace_back();
+		texture.Key.assign(reinterpret_cast<const char*>(data + entry.KeyOffset), entry.KeyLength);
+		texture.Format = static_cast<VkFormat>(entry.Format);
+		texture.IsEmbedded = entry.IsEmbedded != 0;
+		texture.EmbeddedWidth = entry.EmbeddedWidth;
+		texture.EmbeddedHeight = entry.EmbeddedHeight;
+		texture.EmbeddedData = { data + entry.DataOffset, static_cast<size_t>(entry.DataSize) };
+	}
+
+	m_ColdLoadMs = header.ColdLoadMs;
+	return true;
+}
+
+bool MeshCache::Write(const std::vector<CachedMesh>& meshes, const std::vector<CachedTexture>& textures, float coldLoadMs)
+{
+	if (!HashSourceFile())
+	{
+		return false;
+	}
+
+	std::vector<DependencyCacheEntry> dependencyEntries(m_DependencyPaths.size());
+	for (size_t i = 0; i < m_DependencyPaths.size(); ++i)
+	{
+		if (!HashFile(m_DependencyPaths[i], dependencyEntries[i].Hash, dependencyEntries[i].Size))
+		{
+			std::cerr << "WARNING: Mesh cache dependency vanished during the import: " << m_DependencyPaths[i] << "\n";
+			return false;
+		}
+	}
+
+	std::vector<uint8_t> fileData(sizeof(MeshCacheHeader));
+
+	auto append = [&fileData](const void* source, size_t bytes) -> uint64_t
+	{
+		fileData.resize((fileData.size() + BlobAlignment - 1) & ~(BlobAlignment - 1));
+		const uint64_t offset = fileData.size();
+		if (bytes > 0)
+		{
+			fileData.resize(fileData.size() + bytes);
+			memcpy(fileData.data() + offset, source, bytes);
+		}
+		return offset;
+	};
+
+	std::vector<MeshCacheEntry> meshEntries(meshes.size());
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		const CachedMesh& mesh = meshes[i];
+		MeshCacheEntry& entry = meshEntries[i];
+
+		entry.VertexOffset = append(mesh.Vertices.data(), mesh.Vertices.size_bytes());
+		entry.IndexOffset = append(mesh.Indices.data(), mesh.Indices.size_bytes());
+		entry.MeshletOffset = append(mesh.Meshlets.data(), mesh.Meshlets.size_bytes());
+		entry.LodOffset = append(mesh.Lods.data(), mesh.Lods.size_bytes());
+		entry.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+		entry.IndexCount = static_cast<uint32_t>(mesh.Indices.size());
+		entry.MeshletCount = static_cast<uint32_t>(mesh.Meshlets.size());
+		entry.LodCount = static_cast<uint32_t>(mesh.Lods.size());
+		memcpy(entry.BoundingSphere, &mesh.BoundingSphere[0], sizeof(entry.BoundingSphere));
+		entry.UvDensity = mesh.UvDensity;
+		entry.Padding = 0;
+		entry.MaterialIndices[0] = mesh.MaterialIndices.albedoTexIdx;
+		entry.MaterialIndices[1] = mesh.MaterialIndices.normalTexIdx;
+		entry.MaterialIndices[2] = mesh.MaterialIndices.metallicRoughnessTexIdx;
+		entry.MaterialIndices[3] = mesh.MaterialIndices.aoTexIdx;
+		memcpy(entry.ModelMatrix, &mesh.ModelMatrix[0][0], sizeof(entry.ModelMatrix));
+	}
+
+	std::vector<TextureCacheEntry> textureEntries(textures.size());
+	for (size_t i = 0; i < textures.size(); ++i)
+	{
+		const CachedTexture& texture = textures[i];
+		TextureCacheEntry& entry = textureEntries[i];
+
+		entry.KeyOffset = append(texture.Key.data(), texture.Key.size());
+		entry.KeyLength = static_cast<uint32_t>(texture.Key.size());
+		entry.DataOffset = append(texture.EmbeddedData.data(), texture.EmbeddedData.size());
+		entry.DataSize = texture.EmbeddedData.size();
+		entry.Format = static_cast<uint32_t>(texture.Format);
+		entry.IsEmbedded = texture.IsEmbedded ? 1 : 0;
+		entry.EmbeddedWidth = texture.EmbeddedWidth;
+		entry.EmbeddedHeight = texture.EmbeddedHeight;
+		entry.Padding = 0;
+	}
+
+	for (size_t i = 0; i < m_DependencyPaths.size(); ++i)
+	{
+		DependencyCacheEntry& entry = dependencyEntries[i];
+		entry.PathOffset = append(m_DependencyPaths[i].data(), m_DependencyPaths[i].size());
+		entry.PathLength = static_cast<uint32_t>(m_DependencyPaths[i].size());
+		entry.Padding = 0;
+	}
+
+	MeshCacheHeader header{};
+	memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = m_Version;
+	header.SourceHash = m_SourceHash;
+	header.SourceSize = m_SourceSize;
+	header.ImportFlags = m_ImportFlags;
+	header.VertexStride = sizeof(Vertex);
+	header.MeshCount = static_cast<uint32_t>(meshes.size());
+	header.TextureCount = static_cast<uint32_t>(textures.size());
+	header.ColdLoadMs = coldLoadMs;
+	header.DependencyCount = static_cast<uint32_t>(dependencyEntries.size());
+	header.MeshTableOffset = append(meshEntries.data(), meshEntries.size() * sizeof(MeshCacheEntry));
+	header.TextureTableOffset = append(textureEntries.data(), textureEntries.size() * sizeof(TextureCacheEntry));
+	header.DependencyTableOffset = append(dependencyEntries.data(), dependencyEntries.size() * sizeof(DependencyCacheEntry));
+	memcpy(fileData.data(), &header, sizeof(header));
+
+	// Write to a temporary file first so a crash never leaves a half written cache behind
+	m_MappedFile.Close();
+	const std::string tempPath = m_CachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open() || !file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size())))
+		{
+			std::cerr << "WARNING: Failed to write mesh cache: " << tempPath << "\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, m_CachePath, error);
+	if (error)
+	{
+		std::cerr << "WARNING: Failed to write mesh cache: " << m_CachePath << " (" << error.message() << ")\n";
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
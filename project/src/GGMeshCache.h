@@ -0,0 +1,71 @@
+#pragma once
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GGMappedFile.h"
+#include "Model.h"
+
+namespace GG
+{
+	struct CachedTexture
+	{
+		std::string Key;                         // Resolved file path, or "*N" for textures embedded in the model
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		bool IsEmbedded = false;
+		uint32_t EmbeddedWidth = 0;              // Same meaning as aiTexture::mWidth/mHeight
+		uint32_t EmbeddedHeight = 0;
+		std::span<const uint8_t> EmbeddedData;
+	};
+
+	struct CachedMesh
+	{
+		std::span<const Vertex> Vertices;
+		std::span<const uint32_t> Indices;
+		std::span<const Meshlet> Meshlets;
+		std::span<const MeshLod> Lods;
+		glm::vec4 BoundingSphere{ 0.f };
+		float UvDensity = 0.f;
+		Mesh::PBRMaterialIndices MaterialIndices; // Below Scene's default count: default slot, otherwise default count + cached texture index
+		glm::mat4 ModelMatrix{ 1.f };
+	};
+
+	// Cooked, memory mapped output of Scene::ProcessNode, stored next to the source model.
+	// The cache is keyed by a hash of the source file contents, of every other file Assimp read for it
+	// (glTF buffers, OBJ material libraries) and the Assimp import flags.
+	class MeshCache
+	{
+	public:
+		MeshCache(const std::string& sourcePath, uint32_t importFlags);
+
+		bool Load();
+		// Files besides the source the import read, hashed into the cache by Write
+		void SetDependencies(std::vector<std::string> dependencyPaths) { m_DependencyPaths = std::move(dependencyPaths); }
+		bool Write(const std::vector<CachedMesh>& meshes, const std::vector<CachedTexture>& textures, float coldLoadMs);
+
+		const std::vector<CachedMesh>& GetMeshes() const { return m_Meshes; }
+		const std::vector<CachedTexture>& GetTextures() const { return m_Textures; }
+		float GetColdLoadTime() const { return m_ColdLoadMs; }
+		const std::string& GetCachePath() const { return m_CachePath; }
+
+	private:
+		bool HashSourceFile();
+
+		static constexpr uint32_t m_Version = 6;
+
+		std::string m_SourcePath;
+		std::string m_CachePath;
+		uint32_t m_ImportFlags;
+
+		uint64_t m_SourceHash = 0;
+		uint64_t m_SourceSize = 0;
+		bool m_IsSourceHashed = false;
+		std::vector<std::string> m_DependencyPaths;
+
+		MappedFile m_MappedFile;
+		std::vector<CachedMesh> m_Meshes;
+		std::vector<CachedTexture> m_Textures;
+		float m_ColdLoadMs = 0.f;
+	};
+}
@@ -0,0 +1,363 @@
+#include "GGMeshOptimizer.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <numeric>
+
+#include "Model.h"
+
+using namespace GG;
+
+namespace
+{
+	constexpr uint32_t InvalidIndex = ~0u;
+
+	// FIFO post-transform cache, a hit leaves the order untouched like the hardware does
+	class FifoCache
+	{
+	public:
+		FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+			: m_InsertTime(vertexCount, 0), m_CacheSize(cacheSize)
+		{
+		}
+
+		bool Access(uint32_t vertex)
+		{
+			if (m_InsertTime[vertex] != 0 && m_Time - m_InsertTime[vertex] < m_CacheSize) return true;
+
+			m_InsertTime[vertex] = ++m_Time;
+			return false;
+		}
+
+		void Reset()
+		{
+			m_Time += m_CacheSize + 1;
+		}
+
+	private:
+		std::vector<uint32_t> m_InsertTime;
+		uint32_t m_Time = 0;
+		uint32_t m_CacheSize;
+	};
+
+	struct TriangleAdjacency
+	{
+		std::vector<uint32_t> Offsets;   // Per vertex start into Triangles, vertexCount + 1 entries
+		std::vector<uint32_t> Triangles;
+	};
+
+	TriangleAdjacency BuildAdjacency(std::span<const uint32_t> indices, uint32_t vertexCount)
+	{
+		TriangleAdjacency adjacency;
+		adjacency.Offsets.assign(vertexCount + 1, 0);
+
+		for (uint32_t index : indices)
+		{
+			++adjacency.Offsets[index + 1];
+		}
+		std::partial_sum(adjacency.Offsets.begin(), adjacency.Offsets.end(), adjacency.Offsets.begin());
+
+		std::vector<uint32_t> fill(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+		adjacency.Triangles.resize(indices.size());
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			adjacency.Triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		return adjacency;
+	}
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats{};
+	if (indices.size() < 3 || vertexCount == 0) return stats;
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> isUsed(vertexCount, false);
+	uint32_t misses = 0;
+	uint32_t uniqueVertices = 0;
+
+	for (uint32_t index : indices)
+	{
+		if (!cache.Access(index)) ++misses;
+		if (!isUsed[index])
+		{
+			isUsed[index] = true;
+			++uniqueVertices;
+		}
+	}
+
+	stats.Acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	stats.Atvr = static_cast<float>(misses) / static_cast<float>(uniqueVertices);
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || vertexCount == 0) return;
+
+	const TriangleAdjacency adjacency = BuildAdjacency(indices, vertexCount);
+
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		liveTriangles[v] = adjacency.Offsets[v + 1] - adjacency.Offsets[v];
+	}
+
+	std::vector<uint32_t> cacheTime(vertexCount, 0);
+	std::vector<bool> isEmitted(triangleCount, false);
+	std::vector<uint32_t> deadEndStack;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	uint32_t timeStamp = cacheSize + 1;
+	uint32_t cursor = 0;
+
+	// Fall back to recently used vertices first, then to the next vertex in input order
+	auto skipDeadEnd = [&]() -> uint32_t
+	{
+		while (!deadEndStack.empty())
+		{
+			const uint32_t vertex = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (liveTriangles[vertex] > 0) return vertex;
+		}
+
+		while (cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0) return cursor;
+			++cursor;
+		}
+
+		return InvalidIndex;
+	};
+
+	uint32_t fanningVertex = skipDeadEnd();
+	while (fanningVertex != InvalidIndex)
+	{
+		candidates.clear();
+
+		for (uint32_t i = adjacency.Offsets[fanningVertex]; i < adjacency.Offsets[fanningVertex + 1]; ++i)
+		{
+			const uint32_t triangle = adjacency.Triangles[i];
+			if (isEmitted[triangle]) continue;
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t vertex = indices[triangle * 3 + corner];
+				result.push_back(vertex);
+				deadEndStack.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveTriangles[vertex];
+
+				if (timeStamp - cacheTime[vertex] > cacheSize)
+				{
+					cacheTime[vertex] = timeStamp++;
+				}
+			}
+			isEmitted[triangle] = true;
+		}
+
+		// Prefer the candidate that stays in the cache for all of its remaining triangles, oldest first
+		uint32_t bestVertex = InvalidIndex;
+		int32_t bestPriority = -1;
+		for (uint32_t vertex : candidates)
+		{
+			if (liveTriangles[vertex] == 0) continue;
+
+			int32_t priority = 0;
+			if (timeStamp - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+			{
+				priority = static_cast<int32_t>(timeStamp - cacheTime[vertex]);
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				bestVertex = vertex;
+			}
+		}
+
+		fanningVertex = bestVertex != InvalidIndex ? bestVertex : skipDeadEnd();
+	}
+
+	std::copy(result.begin(), result.end(), indices.begin());
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold, uint32_t cacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	if (triangleCount == 0 || vertexCount == 0) return;
+
+	// Hard boundaries: triangles where the cache optimized order restarts with three misses
+	std::vector<uint32_t> hardClusters;
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			uint32_t misses = 0;
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				if (!cache.Access(indices[t * 3 + corner])) ++misses;
+			}
+			if (t == 0 || misses == 3) hardClusters.push_back(static_cast<uint32_t>(t));
+		}
+	}
+
+	// Soft boundaries: cut a hard cluster wherever the running ACMR is already within threshold of the whole cluster
+	std::vector<uint32_t> clusters;
+	for (size_t c = 0; c < hardClusters.size(); ++c)
+	{
+		const uint32_t start = hardClusters[c];
+		const uint32_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : static_cast<uint32_t>(triangleCount);
+
+		FifoCache cache(vertexCount, cacheSize);
+		uint32_t clusterMisses = 0;
+		for (uint32_t t = start; t < end; ++t)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				if (!cache.Access(indices[t * 3 + corner])) ++clusterMisses;
+			}
+		}
+		const float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+		cache.Reset();
+		uint32_t runningMisses = 0;
+		uint32_t clusterStart = start;
+		for (uint32_t t = start; t < end; ++t)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				if (!cache.Access(indices[t * 3 + corner])) ++runningMisses;
+			}
+
+			const float runningAcmr = static_cast<float>(runningMisses) / static_cast<float>(t - clusterStart + 1);
+			if (runningAcmr <= clusterAcmr * threshold || t + 1 == end)
+			{
+				clusters.push_back(clusterStart);
+				clusterStart = t + 1;
+				runningMisses = 0;
+				cache.Reset();
+			}
+		}
+	}
+
+	// Clusters facing away from the mesh centre are likely in front of the rest, draw them first
+	glm::vec3 meshCentroid{ 0.f };
+	for (uint32_t index : indices)
+	{
+		meshCentroid += vertices[index].pos;
+	}
+	meshCentroid /= static_cast<float>(indices.size());
+
+	std::vector<float> sortKeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		const uint32_t start = clusters[c];
+		const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+
+		glm::vec3 centroid{ 0.f };
+		glm::vec3 normal{ 0.f };
+		float area = 0.f;
+		for (uint32_t t = start; t < end; ++t)
+		{
+			const glm::vec3& p0 = vertices[indices[t * 3 + 0]].pos;
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+
+			const glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+			const float triangleArea = glm::length(areaNormal);
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.f);
+			normal += areaNormal;
+			area += triangleArea;
+		}
+
+		centroid = area > 0.f ? centroid / area : centroid;
+		const float normalLength = glm::length(normal);
+		normal = normalLength > 0.f ? normal / normalLength : normal;
+
+		sortKeys[c] = glm::dot(centroid - meshCentroid, normal);
+	}
+
+	std::vector<uint32_t> order(clusters.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t c : order)
+	{
+		const uint32_t start = clusters[c];
+		const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+		result.insert(result.end(), indices.begin() + start * 3, indices.begin() + end * 3);
+	}
+
+	std::copy(result.begin(), result.end(), indices.begin());
+}
+
+VertexDedupStats MeshOptimizer::DeduplicateVertices(std::vector<Vertex>& vertices, std::span<uint32_t> indices)
+{
+	const uint32_t sourceVertexCount = static_cast<uint32_t>(vertices.size());
+
+	// At most half full, slots hold the index of a kept vertex
+	const size_t tableSize = std::bit_ceil(std::max<size_t>(sourceVertexCount * 2ull, 16));
+	const size_t tableMask = tableSize - 1;
+	std::vector<uint32_t> table(tableSize, InvalidIndex);
+	std::vector<uint32_t> remap(sourceVertexCount);
+	const std::hash<Vertex> hasher;
+
+	uint32_t vertexCount = 0;
+	for (uint32_t i = 0; i < sourceVertexCount; ++i)
+	{
+		const Vertex& vertex = vertices[i];
+		size_t slot = hasher(vertex) & tableMask;
+
+		while (table[slot] != InvalidIndex && !(vertices[table[slot]] == vertex))
+		{
+			slot = (slot + 1) & tableMask;
+		}
+
+		if (table[slot] == InvalidIndex)
+		{
+			// Kept vertices only move towards the front, so the slots written earlier stay valid
+			vertices[vertexCount] = vertex;
+			table[slot] = vertexCount++;
+		}
+		remap[i] = table[slot];
+	}
+
+	vertices.resize(vertexCount);
+	for (uint32_t& index : indices)
+	{
+		index = remap[index];
+	}
+
+	return { sourceVertexCount, vertexCount };
+}
+
+uint32_t MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), InvalidIndex);
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertices.size());
+
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == InvalidIndex)
+		{
+			remap[index] = static_cast<uint32_t>(reordered.size());
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices = std::move(reordered);
+	return static_cast<uint32_t>(vertices.size());
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Vertex;
+
+namespace GG
+{
+	struct VertexCacheStats
+	{
+		float Acmr = 0.f; // Average cache miss ratio, vertex shader invocations per triangle (0.5 - 3)
+		float Atvr = 0.f; // Average transformed vertex ratio, invocations per unique vertex (1 is optimal)
+	};
+
+	struct VertexDedupStats
+	{
+		uint32_t SourceVertexCount = 0;
+		uint32_t VertexCount = 0;
+	};
+
+	// Import time reordering of a triangle list. All passes keep the triangle set and winding intact.
+	namespace MeshOptimizer
+	{
+		// Cache size used by the analysis and the optimizer, matches the FIFO size most desktop GPUs behave like
+		constexpr uint32_t VertexCacheSize = 16;
+
+		VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = VertexCacheSize);
+
+		// Tipsify (Sander et al. 2007), linear time triangle reordering for the post-transform cache
+		void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = VertexCacheSize);
+
+		// Splits the cache optimized order into clusters and sorts them front facing first from the mesh centre,
+		// threshold is the ACMR a cluster may lose relative to the cache optimized order
+		void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold = 1.05f, uint32_t cacheSize = VertexCacheSize);
+
+		// Merges vertices equal in every attribute through an open addressing table, survivors keep their first occurrence order.
+		// Indices are remapped in place, unreferenced vertices are kept.
+		VertexDedupStats DeduplicateVertices(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+		// Renumbers vertices in first use order and drops unused ones, returns the new vertex count
+		uint32_t OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+	}
+}
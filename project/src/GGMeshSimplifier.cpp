@@ -0,0 +1,280 @@
+#include "GGMeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "Model.h"
+
+using namespace GG;
+
+namespace
+{
+	constexpr uint32_t InvalidIndex = ~0u;
+
+	// Symmetric 4x4 plane quadric, stored as the upper triangle plus the accumulated area weight
+	struct Quadric
+	{
+		double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+		double a11 = 0, a12 = 0, a13 = 0;
+		double a22 = 0, a23 = 0;
+		double a33 = 0;
+		double Weight = 0;
+
+		static Quadric FromPlane(const glm::vec3& normal, double distance, double weight)
+		{
+			Quadric q;
+			q.a00 = normal.x * normal.x * weight; q.a01 = normal.x * normal.y * weight; q.a02 = normal.x * normal.z * weight; q.a03 = normal.x * distance * weight;
+			q.a11 = normal.y * normal.y * weight; q.a12 = normal.y * normal.z * weight; q.a13 = normal.y * distance * weight;
+			q.a22 = normal.z * normal.z * weight; q.a23 = normal.z * distance * weight;
+			q.a33 = distance * distance * weight;
+			q.Weight = weight;
+			return q;
+		}
+
+		Quadric& operator+=(const Quadric& o)
+		{
+			a00 += o.a00; a01 += o.a01; a02 += o.a02; a03 += o.a03;
+			a11 += o.a11; a12 += o.a12; a13 += o.a13;
+			a22 += o.a22; a23 += o.a23;
+			a33 += o.a33;
+			Weight += o.Weight;
+			return *this;
+		}
+
+		// Weighted squared distance of p to the accumulated planes, divided by the weight so it is in model space units
+		double Error(const glm::vec3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+				+ a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+				+ a22 * z * z + 2 * a23 * z
+				+ a33;
+			return Weight > 0 ? std::max(error, 0.0) / Weight : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t From;      // Attribute vertex that is removed
+		uint32_t To;        // Attribute vertex it is replaced with
+		double Error;
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const glm::vec3& p) const
+		{
+			uint32_t bits[3];
+			memcpy(bits, &p, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(std::span<const uint32_t> indices, std::span<const Vertex> vertices, uint32_t targetIndexCount,
+	float maxError, float* resultError)
+{
+	std::vector<uint32_t> result(indices.begin(), indices.end());
+	if (resultError) *resultError = 0.f;
+
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	if (result.size() <= targetIndexCount || vertexCount == 0) return result;
+
+	// Vertices that only differ in attributes share one position slot, collapses are decided per position
+	std::vector<uint32_t> positionOf(vertexCount);
+	std::vector<uint32_t> attributeCount;
+	{
+		std::unordered_map<glm::vec3, uint32_t, PositionHash> positionIds;
+		positionIds.reserve(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			auto [it, inserted] = positionIds.try_emplace(vertices[v].pos, static_cast<uint32_t>(positionIds.size()));
+			positionOf[v] = it->second;
+		}
+		attributeCount.assign(positionIds.size(), 0);
+
+		std::vector<bool> isReferenced(vertexCount, false);
+		for (uint32_t index : result)
+		{
+			if (!isReferenced[index])
+			{
+				isReferenced[index] = true;
+				++attributeCount[positionOf[index]];
+			}
+		}
+	}
+	const uint32_t positionCount = static_cast<uint32_t>(attributeCount.size());
+
+	std::vector<bool> isLocked(positionCount, false);
+	for (uint32_t p = 0; p < positionCount; ++p)
+	{
+		isLocked[p] = attributeCount[p] > 1;
+	}
+
+	// Open and non-manifold edges, an edge is interior when it is used exactly once in each direction
+	{
+		std::unordered_map<uint64_t, int32_t> edgeBalance;
+		edgeBalance.reserve(result.size());
+		auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b); };
+
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t a = positionOf[result[i + corner]];
+				const uint32_t b = positionOf[result[i + (corner + 1) % 3]];
+				edgeBalance[edgeKey(a, b)] += a < b ? 1 : 1 << 16;
+			}
+		}
+
+		for (const auto& [key, balance] : edgeBalance)
+		{
+			if (balance != (1 | 1 << 16))
+			{
+				isLocked[static_cast<uint32_t>(key >> 32)] = true;
+				isLocked[static_cast<uint32_t>(key)] = true;
+			}
+		}
+	}
+
+	std::vector<Quadric> quadrics(positionCount);
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		const glm::vec3& p0 = vertices[result[i + 0]].pos;
+		const glm::vec3& p1 = vertices[result[i + 1]].pos;
+		const glm::vec3& p2 = vertices[result[i + 2]].pos;
+
+		const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+		const float doubleArea = glm::length(cross);
+		if (doubleArea <= 0.f) continue;
+
+		const glm::vec3 normal = cross / doubleArea;
+		const Quadric quadric = Quadric::FromPlane(normal, -glm::dot(normal, p0), doubleArea * 0.5);
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			quadrics[positionOf[result[i + corner]]] += quadric;
+		}
+	}
+
+	const double maxErrorSquared = static_cast<double>(maxError) * maxError;
+	double largestError = 0;
+
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> isTouched(positionCount);
+	std::vector<uint32_t> triangleOffsets(positionCount + 1);
+	std::vector<uint32_t> triangles;
+	std::vector<Collapse> collapses;
+
+	// Each pass collapses a set of independent edges cheapest first, then compacts the index buffer
+	while (result.size() > targetIndexCount)
+	{
+		const size_t triangleCount = result.size() / 3;
+
+		// Triangles around each position
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (uint32_t index : result)
+		{
+			++triangleOffsets[positionOf[index] + 1];
+		}
+		std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin());
+		triangles.resize(result.size());
+		{
+			std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				triangles[fill[positionOf[result[i]]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t from = result[i + corner];
+				const uint32_t to = result[i + (corner + 1) % 3];
+				const uint32_t fromPosition = positionOf[from];
+				if (isLocked[fromPosition] || fromPosition == positionOf[to]) continue;
+
+				Quadric combined = quadrics[fromPosition];
+				combined += quadrics[positionOf[to]];
+				const double error = combined.Error(vertices[to].pos);
+				if (error <= maxErrorSquared)
+				{
+					collapses.push_back({ from, to, error });
+				}
+			}
+		}
+
+		if (collapses.empty()) break;
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+		std::iota(remap.begin(), remap.end(), 0u);
+		std::fill(isTouched.begin(), isTouched.end(), false);
+
+		// Every interior collapse removes two triangles
+		const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+		size_t removedTriangles = 0;
+
+		for (const Collapse& collapse : collapses)
+		{
+			if (removedTriangles >= trianglesToRemove) break;
+
+			const uint32_t fromPosition = positionOf[collapse.From];
+			const uint32_t toPosition = positionOf[collapse.To];
+			if (isTouched[fromPosition] || isTouched[toPosition]) continue;
+
+			// Reject collapses that flip a surviving triangle around the removed vertex
+			bool isFlipping = false;
+			for (uint32_t t = triangleOffsets[fromPosition]; t < triangleOffsets[fromPosition + 1] && !isFlipping; ++t)
+			{
+				const uint32_t* corners = &result[triangles[t] * 3];
+				uint32_t current[3] = { remap[corners[0]], remap[corners[1]], remap[corners[2]] };
+
+				const bool hasTarget = positionOf[current[0]] == toPosition || positionOf[current[1]] == toPosition || positionOf[current[2]] == toPosition;
+				if (hasTarget) continue;
+
+				const glm::vec3 before = glm::cross(vertices[current[1]].pos - vertices[current[0]].pos, vertices[current[2]].pos - vertices[current[0]].pos);
+				for (uint32_t& corner : current)
+				{
+					if (positionOf[corner] == fromPosition) corner = collapse.To;
+				}
+				const glm::vec3 after = glm::cross(vertices[current[1]].pos - vertices[current[0]].pos, vertices[current[2]].pos - vertices[current[0]].pos);
+
+				isFlipping = glm::dot(before, after) <= 0.f;
+			}
+			if (isFlipping) continue;
+
+			remap[collapse.From] = collapse.To;
+			quadrics[toPosition] += quadrics[fromPosition];
+			isTouched[fromPosition] = true;
+			isTouched[toPosition] = true;
+
+			removedTriangles += 2;
+			largestError = std::max(largestError, collapse.Error);
+		}
+
+		if (removedTriangles == 0) break;
+
+		// Drop the triangles that collapsed to a line
+		size_t write = 0;
+		for (size_t i = 0; i < triangleCount * 3; i += 3)
+		{
+			const uint32_t a = remap[result[i + 0]];
+			const uint32_t b = remap[result[i + 1]];
+			const uint32_t c = remap[result[i + 2]];
+			if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c]) continue;
+
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+	}
+
+	if (resultError) *resultError = static_cast<float>(std::sqrt(largestError));
+	return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Vertex;
+
+namespace GG
+{
+	// One level of detail, a range of the mesh's index buffer over the shared vertex buffer
+	struct MeshLod
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		float Error = 0.f;          // Model space distance the surface may be off from LOD 0
+		uint32_t Padding = 0;
+	};
+
+	namespace MeshSimplifier
+	{
+		// Quadric error driven edge collapse that only removes vertices, the result indexes the same vertex buffer.
+		// Vertices on open borders and on attribute seams (same position, different vertex) are never moved, which keeps
+		// the LODs crack free and the texture layout intact. Stops at targetIndexCount, at maxError or when nothing
+		// can be collapsed anymore, resultError receives the largest collapse error in model space units.
+		std::vector<uint32_t> Simplify(std::span<const uint32_t> indices, std::span<const Vertex> vertices, uint32_t targetIndexCount,
+			float maxError, float* resultError = nullptr);
+	}
+}
@@ -0,0 +1,191 @@
+#include "GGMeshlet.h"
+
+#include "Model.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GG;
+
+namespace
+{
+	// Cones wider than this (minimum normal dot axis) almost never cull anything, skip the test for them
+	constexpr float MinConeDot = 0.1f;
+
+	void ComputeBounds(Meshlet& meshlet, std::span<const uint32_t> indices, std::span<const Vertex> vertices)
+	{
+		const uint32_t firstIndex = meshlet.FirstIndex;
+		const uint32_t indexCount = meshlet.TriangleCount * 3;
+
+		glm::vec3 aabbMin{ vertices[indices[firstIndex]].pos };
+		glm::vec3 aabbMax{ aabbMin };
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; ++i)
+		{
+			aabbMin = glm::min(aabbMin, vertices[indices[i]].pos);
+			aabbMax = glm::max(aabbMax, vertices[indices[i]].pos);
+		}
+
+		const glm::vec3 center = (aabbMin + aabbMax) * 0.5f;
+		float radiusSquared = 0.f;
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; ++i)
+		{
+			const glm::vec3 offset = vertices[indices[i]].pos - center;
+			radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+		}
+
+		meshlet.AabbMin = aabbMin;
+		meshlet.AabbMax = aabbMax;
+		meshlet.Center = center;
+		meshlet.Radius = std::sqrt(radiusSquared);
+
+		// Normal cone from the face normals, vertex normals would not match what the rasterizer culls
+		auto faceNormal = [&](uint32_t triangle, glm::vec3& normal) -> bool
+		{
+			const glm::vec3& p0 = vertices[indices[firstIndex + triangle * 3 + 0]].pos;
+			const glm::vec3& p1 = vertices[indices[firstIndex + triangle * 3 + 1]].pos;
+			const glm::vec3& p2 = vertices[indices[firstIndex + triangle * 3 + 2]].pos;
+
+			normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+			if (length <= 0.f) return false;
+
+			normal /= length;
+			return true;
+		};
+
+		glm::vec3 axis{ 0.f };
+		glm::vec3 normal;
+		for (uint32_t t = 0; t < meshlet.TriangleCount; ++t)
+		{
+			if (faceNormal(t, normal)) axis += normal;
+		}
+
+		const float axisLength = glm::length(axis);
+		if (axisLength <= 0.f) return;
+		axis /= axisLength;
+
+		float minDot = 1.f;
+		for (uint32_t t = 0; t < meshlet.TriangleCount; ++t)
+		{
+			if (faceNormal(t, normal)) minDot = std::min(minDot, glm::dot(axis, normal));
+		}
+
+		if (minDot <= MinConeDot) return;
+
+		meshlet.ConeAxis = axis;
+		meshlet.ConeCutoff = std::sqrt(1.f - minDot * minDot);
+	}
+}
+
+std::vector<Meshlet> GG::BuildMeshlets(std::span<const uint32_t> indices, std::span<const Vertex> vertices, uint32_t maxVertices, uint32_t maxTriangles)
+{
+	std::vector<Meshlet> meshlets;
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0 || vertices.empty()) return meshlets;
+
+	meshlets.reserve(triangleCount / maxTriangles + 1);
+
+	// Id of the meshlet a vertex was last counted in, saves clearing a set per meshlet
+	std::vector<uint32_t> vertexMeshlet(vertices.size(), ~0u);
+	Meshlet current{};
+
+	auto countNewVertices = [&](uint32_t triangle, uint32_t meshletId) -> uint32_t
+	{
+		const uint32_t* corners = &indices[triangle * 3];
+		uint32_t newVertices = vertexMeshlet[corners[0]] != meshletId ? 1 : 0;
+		newVertices += vertexMeshlet[corners[1]] != meshletId && corners[1] != corners[0] ? 1 : 0;
+		newVertices += vertexMeshlet[corners[2]] != meshletId && corners[2] != corners[0] && corners[2] != corners[1] ? 1 : 0;
+		return newVertices;
+	};
+
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		uint32_t newVertices = countNewVertices(t, static_cast<uint32_t>(meshlets.size()));
+		if (current.TriangleCount > 0 && (current.VertexCount + newVertices > maxVertices || current.TriangleCount == maxTriangles))
+		{
+			ComputeBounds(current, indices, vertices);
+			meshlets.push_back(current);
+
+			current = Meshlet{};
+			current.FirstIndex = t * 3;
+			newVertices = countNewVertices(t, static_cast<uint32_t>(meshlets.size()));
+		}
+
+		const uint32_t meshletId = static_cast<uint32_t>(meshlets.size());
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			vertexMeshlet[indices[t * 3 + corner]] = meshletId;
+		}
+		current.VertexCount += newVertices;
+		++current.TriangleCount;
+	}
+
+	ComputeBounds(current, indices, vertices);
+	meshlets.push_back(current);
+
+	return meshlets;
+}
+
+FrustumPlanes GG::ExtractFrustumPlanes(const glm::mat4& clipFromSpace)
+{
+	// Gribb/Hartmann on the rows of the matrix, depth is in [0, 1]
+	const glm::vec4 row0{ clipFromSpace[0][0], clipFromSpace[1][0], clipFromSpace[2][0], clipFromSpace[3][0] };
+	const glm::vec4 row1{ clipFromSpace[0][1], clipFromSpace[1][1], clipFromSpace[2][1], clipFromSpace[3][1] };
+	const glm::vec4 row2{ clipFromSpace[0][2], clipFromSpace[1][2], clipFromSpace[2][2], clipFromSpace[3][2] };
+	const glm::vec4 row3{ clipFromSpace[0][3], clipFromSpace[1][3], clipFromSpace[2][3], clipFromSpace[3][3] };
+
+	FrustumPlanes planes{ row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 };
+	for (glm::vec4& plane : planes)
+	{
+		const float length = glm::length(glm::vec3(plane));
+		plane = length > 0.f ? plane / length : plane;
+	}
+
+	return planes;
+}
+
+bool GG::IsSphereVisible(const FrustumPlanes& planes, const glm::vec3& center, float radius)
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+	}
+
+	return true;
+}
+
+bool GG::IsMeshletVisible(const Meshlet& meshlet, const FrustumPlanes& planes, const glm::vec3& cameraPosition, bool isConeCullingEnabled)
+{
+	if (!IsSphereVisible(planes, meshlet.Center, meshlet.Radius)) return false;
+
+	if (isConeCullingEnabled)
+	{
+		const glm::vec3 toCenter = meshlet.Center - cameraPosition;
+		if (glm::dot(toCenter, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(toCenter) + meshlet.Radius) return false;
+	}
+
+	return true;
+}
+
+uint32_t GG::CullMeshlets(std::span<const Meshlet> meshlets, const FrustumPlanes& planes, const glm::vec3& cameraPosition,
+	bool isConeCullingEnabled, std::vector<IndexRange>& visibleRanges)
+{
+	uint32_t visibleCount = 0;
+	for (const Meshlet& meshlet : meshlets)
+	{
+		if (!IsMeshletVisible(meshlet, planes, cameraPosition, isConeCullingEnabled)) continue;
+
+		++visibleCount;
+		const uint32_t indexCount = meshlet.TriangleCount * 3;
+		if (!visibleRanges.empty() && visibleRanges.back().FirstIndex + visibleRanges.back().IndexCount == meshlet.FirstIndex)
+		{
+			visibleRanges.back().IndexCount += indexCount;
+		}
+		else
+		{
+			visibleRanges.push_back({ meshlet.FirstIndex, indexCount });
+		}
+	}
+
+	return visibleCount;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct Vertex;
+
+namespace GG
+{
+	// A contiguous run of a mesh's index buffer with the bounds used for CPU cluster culling, all in model space.
+	// Plain data, stored as is in the mesh cache.
+	struct Meshlet
+	{
+		uint32_t FirstIndex = 0;     // Relative to the mesh's first index
+		uint32_t TriangleCount = 0;
+		uint32_t VertexCount = 0;    // Unique vertices referenced
+		float ConeCutoff = 1.f;      // Sine of the normal cone spread, 1 together with a zero axis disables cone culling
+
+		glm::vec3 Center{ 0.f };
+		float Radius = 0.f;
+		glm::vec3 AabbMin{ 0.f };
+		uint32_t Padding0 = 0;
+		glm::vec3 AabbMax{ 0.f };
+		uint32_t Padding1 = 0;
+		glm::vec3 ConeAxis{ 0.f };
+		uint32_t Padding2 = 0;
+	};
+	static_assert(sizeof(Meshlet) == 80);
+
+	struct IndexRange
+	{
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+	};
+
+	// Normalized planes as (normal, distance), a point p is inside when dot(normal, p) + distance >= 0 for all six
+	using FrustumPlanes = std::array<glm::vec4, 6>;
+
+	constexpr uint32_t MeshletMaxVertices = 64;
+	constexpr uint32_t MeshletMaxTriangles = 124;
+
+	// Splits the index buffer in order, so every meshlet is a contiguous index range and the
+	// vertex cache order of the mesh optimizer is kept
+	std::vector<Meshlet> BuildMeshlets(std::span<const uint32_t> indices, std::span<const Vertex> vertices,
+		uint32_t maxVertices = MeshletMaxVertices, uint32_t maxTriangles = MeshletMaxTriangles);
+
+	// Works for any clip from space matrix, passing projection * view * model gives model space planes
+	FrustumPlanes ExtractFrustumPlanes(const glm::mat4& clipFromSpace);
+
+	bool IsSphereVisible(const FrustumPlanes& planes, const glm::vec3& center, float radius);
+
+	// cameraPosition in the same space as the planes. Cone culling assumes back faces are culled by the pipeline
+	bool IsMeshletVisible(const Meshlet& meshlet, const FrustumPlanes& planes, const glm::vec3& cameraPosition, bool isConeCullingEnabled);
+
+	// Appends the visible meshlets as index ranges, neighbouring visible meshlets are merged into one range.
+	// Returns the number of visible meshlets
+	uint32_t CullMeshlets(std::span<const Meshlet> meshlets, const FrustumPlanes& planes, const glm::vec3& cameraPosition,
+		bool isConeCullingEnabled, std::vector<IndexRange>& visibleRanges);
+}
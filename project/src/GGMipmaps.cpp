@@ -0,0 +1,302 @@
+#include "GGMipmaps.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GG_MIPMAPS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace GG;
+
+namespace
+{
+	uint32_t HalfExtent(uint32_t extent)
+	{
+		return std::max(extent / 2, 1u);
+	}
+
+	// 8 bit average with the same rounding in both paths, the last row or column of an odd sized level is dropped like a blit does
+	void DownsampleLinear(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, MipLevel& target)
+	{
+		target.Width = HalfExtent(sourceWidth);
+		target.Height = HalfExtent(sourceHeight);
+		target.Pixels.resize(static_cast<size_t>(target.Width) * target.Height * 4);
+
+		// Target pixels whose 2x2 footprint needs no column clamping
+		const uint32_t unclampedWidth = sourceWidth / 2;
+
+		for (uint32_t y = 0; y < target.Height; ++y)
+		{
+			const uint8_t* row0 = source + static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth * 4;
+			const uint8_t* row1 = source + static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth * 4;
+			uint8_t* out = target.Pixels.data() + static_cast<size_t>(y) * target.Width * 4;
+
+			uint32_t x = 0;
+#ifdef GG_MIPMAPS_SSE2
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i bias = _mm_set1_epi16(2);
+
+			// 16 source bytes per row give two target pixels, widened to 16 bit so the sum of four can not overflow
+			const auto averagePair = [&](const uint8_t* top, const uint8_t* bottom)
+			{
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom));
+				__m128i left = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i right = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+				left = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+				right = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+				return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(left, right), bias), 2);
+			};
+
+			for (; x + 4 <= unclampedWidth; x += 4)
+			{
+				const __m128i first = averagePair(row0 + x * 8, row1 + x * 8);
+				const __m128i second = averagePair(row0 + x * 8 + 16, row1 + x * 8 + 16);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(first, second));
+			}
+#endif
+			for (; x < target.Width; ++x)
+			{
+				const uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					out[x * 4 + c] = static_cast<uint8_t>((row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c] + 2) >> 2);
+				}
+			}
+		}
+	}
+
+	void DownsampleFloat(const float* source, uint32_t sourceWidth, uint32_t sourceHeight, FloatMipLevel& target)
+	{
+		target.Width = HalfExtent(sourceWidth);
+		target.Height = HalfExtent(sourceHeight);
+		target.Pixels.resize(static_cast<size_t>(target.Width) * target.Height * 4);
+
+#ifdef GG_MIPMAPS_SSE2
+		const __m128 quarter = _mm_set1_ps(0.25f);
+#endif
+		for (uint32_t y = 0; y < target.Height; ++y)
+		{
+			const float* row0 = source + static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth * 4;
+			const float* row1 = source + static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth * 4;
+			float* out = target.Pixels.data() + static_cast<size_t>(y) * target.Width * 4;
+
+			for (uint32_t x = 0; x < target.Width; ++x)
+			{
+				const uint32_t x0 = std::min(x * 2, sourceWidth - 1) * 4;
+				const uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1) * 4;
+#ifdef GG_MIPMAPS_SSE2
+				const __m128 top = _mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1));
+				const __m128 bottom = _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1));
+				_mm_storeu_ps(out + x * 4, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+#else
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					out[x * 4 + c] = ((row0[x0 + c] + row0[x1 + c]) + (row1[x0 + c] + row1[x1 + c])) * 0.25f;
+				}
+#endif
+			}
+		}
+	}
+
+	float SrgbToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	const std::array<float, 256>& GetSrgbDecodeTable()
+	{
+		static const std::array<float, 256> table = []
+		{
+			std::array<float, 256> result{};
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				result[i] = SrgbToLinear(i / 255.f);
+			}
+			return result;
+		}();
+		return table;
+	}
+
+	// Linear values halfway between neighbouring sRGB codes, the encode picks the nearest code in linear light
+	const std::array<float, 255>& GetSrgbEncodeThresholds()
+	{
+		static const std::array<float, 255> table = []
+		{
+			const std::array<float, 256>& decode = GetSrgbDecodeTable();
+			std::array<float, 255> result{};
+			for (uint32_t i = 0; i < 255; ++i)
+			{
+				result[i] = (decode[i] + decode[i + 1]) * 0.5f;
+			}
+			return result;
+		}();
+		return table;
+	}
+
+	uint8_t EncodeUnorm(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f);
+	}
+
+	constexpr uint32_t SrgbEncodeBuckets = 4096;
+
+	// Smallest sRGB code of every evenly spaced linear bucket, the encode only has to step past the few thresholds inside its bucket
+	const std::array<uint8_t, SrgbEncodeBuckets>& GetSrgbEncodeBuckets()
+	{
+		static const std::array<uint8_t, SrgbEncodeBuckets> table = []
+		{
+			const std::array<float, 255>& thresholds = GetSrgbEncodeThresholds();
+			std::array<uint8_t, SrgbEncodeBuckets> result{};
+			for (uint32_t i = 0; i < SrgbEncodeBuckets; ++i)
+			{
+				const float bucketStart = static_cast<float>(i) / SrgbEncodeBuckets;
+				result[i] = static_cast<uint8_t>(std::upper_bound(thresholds.begin(), thresholds.end(), bucketStart) - thresholds.begin());
+			}
+			return result;
+		}();
+		return table;
+	}
+
+	uint8_t EncodeSrgb(float linear)
+	{
+		const std::array<float, 255>& thresholds = GetSrgbEncodeThresholds();
+		const float clamped = std::clamp(linear, 0.f, 1.f);
+
+		uint32_t code = GetSrgbEncodeBuckets()[std::min(static_cast<uint32_t>(clamped * SrgbEncodeBuckets), SrgbEncodeBuckets - 1)];
+		while (code < 255 && clamped >= thresholds[code])
+		{
+			++code;
+		}
+		return static_cast<uint8_t>(code);
+	}
+
+	FloatMipLevel DecodeLevel(const uint8_t* rgba, uint32_t width, uint32_t height, MipFilter filter)
+	{
+		FloatMipLevel level{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+		const std::array<float, 256>& srgbDecode = GetSrgbDecodeTable();
+
+		for (size_t i = 0; i < level.Pixels.size(); i += 4)
+		{
+			for (size_t c = 0; c < 3; ++c)
+			{
+				level.Pixels[i + c] = filter == MipFilter::Srgb ? srgbDecode[rgba[i + c]] : rgba[i + c] / 127.5f - 1.f;
+			}
+			level.Pixels[i + 3] = rgba[i + 3] / 255.f;
+		}
+		return level;
+	}
+
+	void Renormalize(FloatMipLevel& level)
+	{
+		for (size_t i = 0; i < level.Pixels.size(); i += 4)
+		{
+			float* normal = &level.Pixels[i];
+			const float lengthSquared = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+
+			// Opposing normals can cancel out, fall back to the unperturbed tangent space normal
+			if (lengthSquared < 1e-12f)
+			{
+				normal[0] = 0.f;
+				normal[1] = 0.f;
+				normal[2] = 1.f;
+				continue;
+			}
+
+			const float inverseLength = 1.f / std::sqrt(lengthSquared);
+			normal[0] *= inverseLength;
+			normal[1] *= inverseLength;
+			normal[2] *= inverseLength;
+		}
+	}
+
+	MipLevel EncodeLevel(const FloatMipLevel& level, MipFilter filter)
+	{
+		MipLevel result{ level.Width, level.Height, std::vector<uint8_t>(level.Pixels.size()) };
+
+		for (size_t i = 0; i < level.Pixels.size(); i += 4)
+		{
+			for (size_t c = 0; c < 3; ++c)
+			{
+				result.Pixels[i + c] = filter == MipFilter::Srgb ? EncodeSrgb(level.Pixels[i + c]) : EncodeUnorm(level.Pixels[i + c] * 0.5f + 0.5f);
+			}
+			result.Pixels[i + 3] = EncodeUnorm(level.Pixels[i + 3]);
+		}
+		return result;
+	}
+}
+
+uint32_t GG::GetMipLevelCount(uint32_t width, uint32_t height)
+{
+	return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+}
+
+std::vector<MipLevel> GG::GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, MipFilter filter)
+{
+	std::vector<MipLevel> levels(GetMipLevelCount(width, height) - 1);
+
+	if (filter == MipFilter::Linear)
+	{
+		const uint8_t* source = rgba;
+		uint32_t sourceWidth = width;
+		uint32_t sourceHeight = height;
+		for (MipLevel& level : levels)
+		{
+			DownsampleLinear(source, sourceWidth, sourceHeight, level);
+			source = level.Pixels.data();
+			sourceWidth = level.Width;
+			sourceHeight = level.Height;
+		}
+		return levels;
+	}
+
+	// Each level is filtered from the previous float level, only the stored copy is quantized
+	FloatMipLevel source = DecodeLevel(rgba, width, height, filter);
+	FloatMipLevel target;
+	for (MipLevel& level : levels)
+	{
+		DownsampleFloat(source.Pixels.data(), source.Width, source.Height, target);
+		if (filter == MipFilter::NormalMap)
+		{
+			Renormalize(target);
+		}
+
+		level = EncodeLevel(target, filter);
+		std::swap(source, target);
+	}
+
+	return levels;
+}
+
+std::vector<FloatMipLevel> GG::GenerateMipChain(const float* rgba, uint32_t width, uint32_t height)
+{
+	std::vector<FloatMipLevel> levels(GetMipLevelCount(width, height) - 1);
+
+	const float* source = rgba;
+	uint32_t sourceWidth = width;
+	uint32_t sourceHeight = height;
+	for (FloatMipLevel& level : levels)
+	{
+		DownsampleFloat(source, sourceWidth, sourceHeight, level);
+		source = level.Pixels.data();
+		sourceWidth = level.Width;
+		sourceHeight = level.Height;
+	}
+
+	return levels;
+}
+
+const char* GG::GetMipFilterInstructionSet()
+{
+#ifdef GG_MIPMAPS_SSE2
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace GG
+{
+	enum class MipFilter
+	{
+		Linear,		// Plain average of the stored values
+		Srgb,		// Averaged in linear light, alpha stays linear
+		NormalMap	// Averaged as [-1, 1] vectors and renormalized, alpha stays linear
+	};
+
+	struct MipLevel
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<uint8_t> Pixels;   // Tightly packed 8 bit RGBA
+	};
+
+	struct FloatMipLevel
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<float> Pixels;     // Tightly packed 32 bit float RGBA
+	};
+
+	uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+	// CPU 2x2 box filtered levels 1 to the 1x1 level, level 0 is not part of the result.
+	// Srgb and NormalMap filter the whole chain in float so rounding does not add up over the levels.
+	std::vector<MipLevel> GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, MipFilter filter = MipFilter::Linear);
+	std::vector<FloatMipLevel> GenerateMipChain(const float* rgba, uint32_t width, uint32_t height);
+
+	// "SSE2" or "scalar", whichever the filters were built with
+	const char* GetMipFilterInstructionSet();
+}
@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 
+#include "GGVertexFormat.h"
+
 
 class Scene;
 
@@ -20,6 +22,9 @@ struct PipelineContext
 {
 	PipelineContext();
 
+	// Replaces the default Vertex input layout
+	void SetVertexFormat(GG::VertexFormat format);
+
 	std::vector<VkPipelineShaderStageCreateInfo> ShaderStages{};
 	VkPushConstantRange PushConstantRange{};
 	std::vector<VkFormat> ColorAttachmentFormats	{ };
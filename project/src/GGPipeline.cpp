@@ -157,3 +157,14 @@ PipelineContext::PipelineContext()
 	PushConstantRange.offset = 0;
 	PushConstantRange.size = sizeof(PushConstants);
 }
+
+void PipelineContext::SetVertexFormat(GG::VertexFormat format)
+{
+	DefaultBindingDescription = GG::GetVertexBindingDescription(format);
+	AttributeDescriptions = GG::GetVertexAttributeDescriptions(format);
+
+	VertexInputState.vertexBindingDescriptionCount = 1;
+	VertexInputState.vertexAttributeDescriptionCount = static_cast<uint32_t>(AttributeDescriptions.size());
+	VertexInputState.pVertexBindingDescriptions = &DefaultBindingDescription;
+	VertexInputState.pVertexAttributeDescriptions = AttributeDescriptions.data();
+}
@@ -0,0 +1,117 @@
+#include "GGStagingPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+using namespace GG;
+
+void StagingPool::Create(VkDevice device, MemoryAllocator& allocator)
+{
+	m_Device = device;
+	m_pAllocator = &allocator;
+}
+
+void StagingPool::Destroy()
+{
+	for (auto& freeBuffers : m_FreeBuffers)
+	{
+		for (const StagingBuffer& buffer : freeBuffers)
+		{
+			DestroyBuffer(buffer);
+		}
+		freeBuffers.clear();
+	}
+	m_Stats.PooledBytes = 0;
+}
+
+StagingBuffer StagingPool::Acquire(VkDeviceSize size)
+{
+	const uint32_t sizeClass = GetSizeClass(size);
+
+	StagingBuffer buffer;
+	if (sizeClass < m_SizeClassCount && !m_FreeBuffers[sizeClass].empty())
+	{
+		buffer = m_FreeBuffers[sizeClass].back();
+		m_FreeBuffers[sizeClass].pop_back();
+		m_Stats.PooledBytes -= buffer.Size;
+		++m_Stats.Hits;
+	}
+	else
+	{
+		buffer = CreateBuffer(sizeClass < m_SizeClassCount ? GetClassSize(sizeClass) : size, sizeClass);
+		++m_Stats.Misses;
+	}
+
+	m_Stats.InUseBytes += buffer.Size;
+	m_Stats.PeakInUseBytes = std::max(m_Stats.PeakInUseBytes, m_Stats.InUseBytes);
+	return buffer;
+}
+
+void StagingPool::Recycle(const StagingBuffer& buffer)
+{
+	m_Stats.InUseBytes -= buffer.Size;
+
+	if (!m_IsPooling || buffer.SizeClass >= m_SizeClassCount || m_Stats.PooledBytes + buffer.Size > m_MaxPooledBytes)
+	{
+		DestroyBuffer(buffer);
+		return;
+	}
+
+	m_FreeBuffers[buffer.SizeClass].push_back(buffer);
+	m_Stats.PooledBytes += buffer.Size;
+}
+
+void StagingPool::SetPooling(bool isEnabled)
+{
+	m_IsPooling = isEnabled;
+	if (!m_IsPooling)
+	{
+		Destroy();
+	}
+}
+
+void StagingPool::ResetStats()
+{
+	m_Stats.Hits = 0;
+	m_Stats.Misses = 0;
+	m_Stats.PeakInUseBytes = m_Stats.InUseBytes;
+}
+
+StagingBuffer StagingPool::CreateBuffer(VkDeviceSize size, uint32_t sizeClass)
+{
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	StagingBuffer buffer;
+	if (vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer.Buffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create staging buffer!");
+	}
+
+	buffer.Memory = m_pAllocator->AllocateBufferMemory(buffer.Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		MemoryCategory::Staging);
+	buffer.Size = size;
+	buffer.SizeClass = sizeClass;
+	++m_Stats.BufferCount;
+	return buffer;
+}
+
+void StagingPool::DestroyBuffer(const StagingBuffer& buffer)
+{
+	vkDestroyBuffer(m_Device, buffer.Buffer, nullptr);
+	m_pAllocator->Free(buffer.Memory);
+	--m_Stats.BufferCount;
+}
+
+uint32_t StagingPool::GetSizeClass(VkDeviceSize size)
+{
+	if (size <= m_MinClassSize) return 0;
+
+	// Classes above the largest one mean an unpooled buffer
+	const uint32_t sizeClass = static_cast<uint32_t>(std::bit_width((size - 1) / m_MinClassSize));
+	return std::min(sizeClass, m_SizeClassCount);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMemoryAllocator.h"
+
+namespace GG
+{
+	// Host visible, coherent and persistently mapped, Size is the capacity of its size class and may exceed what was asked for
+	struct StagingBuffer
+	{
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		MemoryAllocation Memory;
+		VkDeviceSize Size = 0;
+		uint32_t SizeClass = 0;
+
+		void* GetMapped() const { return Memory.pMapped; }
+	};
+
+	struct StagingPoolStats
+	{
+		uint64_t Hits = 0;                // Acquires served from a recycled buffer
+		uint64_t Misses = 0;              // Acquires that had to create one
+		VkDeviceSize InUseBytes = 0;      // Acquired and not recycled yet
+		VkDeviceSize PeakInUseBytes = 0;
+		VkDeviceSize PooledBytes = 0;     // Recycled and waiting for reuse
+		uint32_t BufferCount = 0;         // In use and pooled
+
+		float GetHitRate() const { return Hits + Misses > 0 ? static_cast<float>(Hits) / static_cast<float>(Hits + Misses) : 0.f; }
+	};
+
+	// Recycles staging buffers in power of two size classes instead of creating and destroying a VkBuffer per upload.
+	// Requests above the largest class get a buffer of their own that is destroyed on Recycle. Not thread safe
+	class StagingPool
+	{
+	public:
+		StagingPool() = default;
+		StagingPool(const StagingPool&) = delete;
+		StagingPool& operator=(const StagingPool&) = delete;
+
+		void Create(VkDevice device, MemoryAllocator& allocator);
+		// Every acquired buffer has to be recycled first
+		void Destroy();
+
+		StagingBuffer Acquire(VkDeviceSize size);
+		// Only once the GPU finished every copy out of the buffer
+		void Recycle(const StagingBuffer& buffer);
+
+		// Off creates a buffer for every Acquire and destroys it on Recycle, as before the pool. Used as the benchmark baseline
+		void SetPooling(bool isEnabled);
+		const StagingPoolStats& GetStats() const { return m_Stats; }
+		// Keeps the buffers, counts hits and misses again from 0 and the peak from what is in use now
+		void ResetStats();
+
+	private:
+		StagingBuffer CreateBuffer(VkDeviceSize size, uint32_t sizeClass);
+		void DestroyBuffer(const StagingBuffer& buffer);
+		static uint32_t GetSizeClass(VkDeviceSize size);
+		static VkDeviceSize GetClassSize(uint32_t sizeClass) { return m_MinClassSize << sizeClass; }
+
+		// 16 KB to 32 MB, small enough for a single mesh and large enough for a 4K BC7 texture with its mips
+		static constexpr VkDeviceSize m_MinClassSize = 16ull * 1024;
+		static constexpr uint32_t m_SizeClassCount = 12;
+		// Idle buffers beyond this are destroyed on Recycle instead of pooled
+		static constexpr VkDeviceSize m_MaxPooledBytes = 128ull * 1024 * 1024;
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		MemoryAllocator* m_pAllocator = nullptr;
+		bool m_IsPooling = true;
+
+		std::array<std::vector<StagingBuffer>, m_SizeClassCount> m_FreeBuffers;
+		StagingPoolStats m_Stats;
+	};
+}
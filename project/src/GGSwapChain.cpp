@@ -175,7 +175,7 @@ void SwapChain::CreateDepthResources(const VkSampleCountFlagBits& msaaSamples) c
 	VkFormat depthFormat = VkHelperFunctions::FindDepthFormat(m_PhysicalDevice);
 	m_DepthImg->CreateImage(m_SwapChainExtent.width, m_SwapChainExtent.height, 1, msaaSamples, depthFormat,
 		VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Device, m_PhysicalDevice);
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *m_pAllocator, MemoryCategory::GBuffer);
 
 	m_DepthImg->CreateImageView(depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1, m_Device);
 
@@ -183,11 +183,14 @@ void SwapChain::CreateDepthResources(const VkSampleCountFlagBits& msaaSamples) c
 
 void SwapChain::CreateColorResources(const VkSampleCountFlagBits& msaaSamples) const
 {
+	// Only a multisampled frame needs a separate color target, without MSAA it would be a full screen image nothing renders to
+	if (msaaSamples == VK_SAMPLE_COUNT_1_BIT) return;
+
 	const VkFormat colorFormat = m_SwapChainImageFormat;
 
 	m_ColorImg->CreateImage(m_SwapChainExtent.width, m_SwapChainExtent.height, 1, msaaSamples, colorFormat, VK_IMAGE_TILING_OPTIMAL,
 		VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Device, m_PhysicalDevice);
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *m_pAllocator, MemoryCategory::GBuffer);
 	m_ColorImg->CreateImageView(colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1,m_Device);
 }
 
@@ -23,7 +23,7 @@ namespace GG
 	class SwapChain
 	{
 	public:
-		SwapChain(const VkDevice& device, const VkPhysicalDevice& physicalDevice):m_Device(device),m_PhysicalDevice(physicalDevice){}
+		SwapChain(const VkDevice& device, const VkPhysicalDevice& physicalDevice, MemoryAllocator& allocator):m_Device(device),m_PhysicalDevice(physicalDevice),m_pAllocator(&allocator){}
 		static SwapChainSupportDetails QuerySwapChainSupport(VkSurfaceKHR& surface, VkPhysicalDevice physicalDevice);
 		static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats); 
 		static VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
@@ -65,5 +65,6 @@ namespace GG
 
 		VkDevice m_Device;
 		VkPhysicalDevice m_PhysicalDevice;
+		MemoryAllocator* m_pAllocator;
 	};
 }
@@ -0,0 +1,77 @@
+#include "GGSwizzle.h"
+
+#include <cstring>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define GG_SWIZZLE_SSSE3 1
+#include <tmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GG_SWIZZLE_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GG_SWIZZLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace GG;
+
+namespace
+{
+	uint32_t SwapRedBlue(uint32_t pixel)
+	{
+		return (pixel & 0xFF00FF00u) | ((pixel >> 16) & 0xFFu) | ((pixel & 0xFFu) << 16);
+	}
+}
+
+void GG::SwizzleBgraToRgba(const uint8_t* bgra, uint8_t* rgba, size_t pixelCount)
+{
+	size_t i = 0;
+#if defined(GG_SWIZZLE_SSSE3)
+	const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+	for (; i + 4 <= pixelCount; i += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_shuffle_epi8(pixels, shuffle));
+	}
+#elif defined(GG_SWIZZLE_NEON)
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		uint8x16x4_t pixels = vld4q_u8(bgra + i * 4);
+		const uint8x16_t blue = pixels.val[0];
+		pixels.val[0] = pixels.val[2];
+		pixels.val[2] = blue;
+		vst4q_u8(rgba + i * 4, pixels);
+	}
+#elif defined(GG_SWIZZLE_SSE2)
+	// Same masks and shifts as the scalar swap on four pixels at a time
+	const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+	const __m128i lowByte = _mm_set1_epi32(0xFF);
+	for (; i + 4 <= pixelCount; i += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4));
+		const __m128i red = _mm_and_si128(_mm_srli_epi32(pixels, 16), lowByte);
+		const __m128i blue = _mm_slli_epi32(_mm_and_si128(pixels, lowByte), 16);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(_mm_and_si128(pixels, greenAlpha), _mm_or_si128(red, blue)));
+	}
+#endif
+	for (; i < pixelCount; ++i)
+	{
+		uint32_t pixel;
+		memcpy(&pixel, bgra + i * 4, sizeof(pixel));
+		pixel = SwapRedBlue(pixel);
+		memcpy(rgba + i * 4, &pixel, sizeof(pixel));
+	}
+}
+
+const char* GG::GetSwizzleInstructionSet()
+{
+#if defined(GG_SWIZZLE_SSSE3)
+	return "SSSE3";
+#elif defined(GG_SWIZZLE_NEON)
+	return "NEON";
+#elif defined(GG_SWIZZLE_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace GG
+{
+	// Swaps the first and third byte of pixelCount 4 byte pixels, source and target may be the same buffer
+	void SwizzleBgraToRgba(const uint8_t* bgra, uint8_t* rgba, size_t pixelCount);
+
+	// "SSSE3", "NEON", "SSE2" or "scalar", whichever the swizzle was built with
+	const char* GetSwizzleInstructionSet();
+}
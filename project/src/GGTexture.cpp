@@ -1,12 +1,16 @@
 ﻿#include "GGTexture.h"
 
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
 
 #include "GGVkHelperFunctions.h"
 #include <cmath>
 
 #include "GGBuffer.h"
-#include "GGCommandManager.h"
+#include "GGHalfFloat.h"
+#include "GGMipmaps.h"
+#include "GGUploadQueue.h"
 
 
 using namespace GG;
@@ -19,267 +23,252 @@ Texture::Texture(std::unique_ptr<stbi_uc[]> pixels, int width, int height, VkFor
 	m_Pixels = m_ManagedPixels.get();
 }
 
-static uint16_t float_to_half(float f)
+namespace
 {
-	uint32_t bits = *reinterpret_cast<uint32_t*>(&f);
-	uint32_t sign = (bits >> 16) & 0x8000;
-	uint32_t mantissa = bits & 0x007FFFFF;
-	uint32_t exp = bits & 0x7F800000;
+	MipFilter GetMipFilter(VkFormat format, TextureUsage usage)
+	{
+		if (usage == TextureUsage::NormalMap) return MipFilter::NormalMap;
 
-	if (exp >= 0x47800000) return sign | 0x7C00; // Inf/NaN
-	if (exp <= 0x38000000) return sign; // Underflow/zero
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+			return MipFilter::Srgb;
+		default:
+			return MipFilter::Linear;
+		}
+	}
 
-	return sign | (((exp - 0x38000000) >> 13) & 0x7C00) | ((mantissa >> 13) & 0x03FF);
+	std::vector<uint8_t> CompressLevel(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height)
+	{
+		std::vector<uint8_t> blocks(GetCompressedSize(format, width, height));
+		CompressImage(format, rgba, width, height, blocks.data());
+		return blocks;
+	}
 }
 
-//mipmapping
-void Texture::GenerateMipmaps(const CommandManager* commandManager, const VkQueue graphicsQueue, const VkDevice device, const VkPhysicalDevice physicalDevice)
+void Texture::CreateImage(Buffer* buffer, UploadQueue& uploadQueue, const VkDevice device, const VkPhysicalDevice physicalDevice, uint32_t firstMip)
 {
-	// Check if image format supports linear blitting
-	VkFormatProperties formatProperties;
-	vkGetPhysicalDeviceFormatProperties(physicalDevice, m_TotalImage.GetImageFormat(), &formatProperties);
+	CreateTextureImage(buffer, uploadQueue, device, physicalDevice, firstMip);
+	CreateTextureImageView(device);
+}
 
-	if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-		throw std::runtime_error("texture image format does not support linear blitting!");
+std::vector<uint64_t> Texture::GetLevelSizes() const
+{
+	std::vector<uint64_t> sizes;
+	sizes.reserve(m_Levels.size());
+	for (const TextureCacheLevel& level : m_Levels)
+	{
+		sizes.push_back(level.Data.size());
 	}
+	return sizes;
+}
+//mipmapping
 
-	VkCommandBuffer commandBuffer = commandManager->BeginSingleTimeCommands(device);
-
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.image = m_TotalImage.GetImage();
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
-	barrier.subresourceRange.levelCount = 1;
-
-	int32_t mipWidth = m_TexWidth;
-	int32_t mipHeight = m_TexHeight;
-
-	for (uint32_t i = 1; i < m_MipLevels; i++) {
-		barrier.subresourceRange.baseMipLevel = i - 1;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-		vkCmdPipelineBarrier(commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
-
-		VkImageBlit blit{};
-		blit.srcOffsets[0] = { 0, 0, 0 };
-		blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		blit.srcSubresource.mipLevel = i - 1;
-		blit.srcSubresource.baseArrayLayer = 0;
-		blit.srcSubresource.layerCount = 1;
-		blit.dstOffsets[0] = { 0, 0, 0 };
-		blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		blit.dstSubresource.mipLevel = i;
-		blit.dstSubresource.baseArrayLayer = 0;
-		blit.dstSubresource.layerCount = 1;
-
-		const auto& image = m_TotalImage.GetImage();
-
-		vkCmdBlitImage(commandBuffer,
-			image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-			image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1, &blit,
-			VK_FILTER_LINEAR);
-
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-		vkCmdPipelineBarrier(commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
-
-		if (mipWidth > 1) mipWidth /= 2;
-		if (mipHeight > 1) mipHeight /= 2;
-	}
+void Texture::Decode()
+{
+	if (m_IsDecoded) return;
 
-	barrier.subresourceRange.baseMipLevel = m_MipLevels - 1;
-	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	const auto decodeStart = std::chrono::high_resolution_clock::now();
 
-	vkCmdPipelineBarrier(commandBuffer,
-		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-		0, nullptr,
-		0, nullptr,
-		1, &barrier);
+	if (m_IsUsingPath)
+	{
+		DecodeFile();
+	}
+	else
+	{
+		// In memory textures have no file to key a cache on, their mips are rebuilt on every load
+		GenerateLevels(m_Pixels);
+	}
 
-	commandManager->EndSingleTimeCommands(graphicsQueue, commandBuffer,device);
+	m_DecodeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - decodeStart).count();
+	m_IsDecoded = true;
 }
 
-void Texture::CreateImage(Buffer* buffer, const CommandManager* commandManager, const VkQueue graphicsQueue, const VkDevice device, const VkPhysicalDevice physicalDevice)
+void Texture::DecodeFile()
 {
-	CreateTextureImage(buffer, commandManager, graphicsQueue, device, physicalDevice);
-	CreateTextureImageView(device);
-}
-//mipmapping
+	m_CompressedFormat = m_IsBlockCompressionEnabled ? GG::GetCompressedFormat(m_ImgFormat, m_Usage) : VK_FORMAT_UNDEFINED;
+	m_TextureCache = std::make_unique<TextureCache>(m_TexturePath, GetUploadFormat(), GetMipFilter(m_ImgFormat, m_Usage));
+
+	if (m_TextureCache->Load())
+	{
+		m_Levels = m_TextureCache->GetLevels();
+		m_IsCacheHit = true;
+	}
+	else
+	{
+		if (m_ImgFormat == VK_FORMAT_R16G16B16A16_SFLOAT)
+		{
+			DecodeHalfFloatLevels();
+		}
+		else
+		{
+			int texChannels;
+			m_DecodedPixels = stbi_load(m_TexturePath.c_str(), &m_TexWidth, &m_TexHeight, &texChannels, STBI_rgb_alpha);
+			if (!m_DecodedPixels) throw std::runtime_error("Failed to load uchar texture");
+			m_Pixels = m_DecodedPixels;
+
+			GenerateLevels(m_Pixels);
+		}
 
+		// A failed write only costs the next start another decode
+		m_TextureCache->Write(m_Levels);
+	}
 
-//multisampling
+	m_TexWidth = static_cast<int32_t>(m_Levels[0].Width);
+	m_TexHeight = static_cast<int32_t>(m_Levels[0].Height);
+}
 
-void Texture::CreateTextureImage(Buffer* buffer, const CommandManager* commandManager, const VkQueue graphicsQueue, const VkDevice device, const VkPhysicalDevice physicalDevice)
+void Texture::GenerateLevels(const stbi_uc* pixels)
 {
-	int texChannels;
-	stbi_uc* loadedPixels = nullptr;
-	float* loadedFloatPixels = nullptr;
-	std::vector<uint16_t> halfFloatData;
+	const uint32_t width = static_cast<uint32_t>(m_TexWidth);
+	const uint32_t height = static_cast<uint32_t>(m_TexHeight);
 
-	if (m_IsUsingPath) 
+	const auto mipStart = std::chrono::high_resolution_clock::now();
+	std::vector<MipLevel> mips = GenerateMipChain(pixels, width, height, GetMipFilter(m_ImgFormat, m_Usage));
+	m_MipGenerationMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - mipStart).count();
+	m_LevelStorage.reserve(mips.size() + 1);
+
+	if (m_CompressedFormat == VK_FORMAT_UNDEFINED)
 	{
-		if (m_ImgFormat == VK_FORMAT_R16G16B16A16_SFLOAT) 
+		m_Levels.push_back({ width, height, { pixels, static_cast<size_t>(width) * height * 4 } });
+		for (MipLevel& mip : mips)
 		{
-			loadedFloatPixels = stbi_loadf(m_TexturePath.c_str(), &m_TexWidth, &m_TexHeight, &texChannels, STBI_rgb_alpha);
-			if (!loadedFloatPixels) throw std::runtime_error("Failed to load float texture");
-			size_t totalPixels = m_TexWidth * m_TexHeight * 4;
-			halfFloatData.resize(totalPixels);
-			for (size_t i = 0; i < totalPixels; ++i)
-				halfFloatData[i] = float_to_half(loadedFloatPixels[i]);
-			stbi_image_free(loadedFloatPixels);
-			m_Pixels = reinterpret_cast<stbi_uc*>(halfFloatData.data());
+			AddLevel(mip.Width, mip.Height, std::move(mip.Pixels));
 		}
+		return;
+	}
 
-		else 
-		{
-			loadedPixels = stbi_load(m_TexturePath.c_str(), &m_TexWidth, &m_TexHeight, &texChannels, STBI_rgb_alpha);
-			if (!loadedPixels) throw std::runtime_error("Failed to load uchar texture");
-			m_Pixels = loadedPixels;
-		}
+	// Blits can not write block compressed images, so every level is encoded here
+	const auto compressStart = std::chrono::high_resolution_clock::now();
+	AddLevel(width, height, CompressLevel(m_CompressedFormat, pixels, width, height));
+	for (const MipLevel& mip : mips)
+	{
+		AddLevel(mip.Width, mip.Height, CompressLevel(m_CompressedFormat, mip.Pixels.data(), mip.Width, mip.Height));
 	}
+	m_CompressMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - compressStart).count();
+}
 
-	uint32_t bytesPerPixel = (m_ImgFormat == VK_FORMAT_R16G16B16A16_SFLOAT) ? 8 : 4;
-	VkDeviceSize imageSize = static_cast<VkDeviceSize>(m_TexWidth) * m_TexHeight * bytesPerPixel;
+void Texture::DecodeHalfFloatLevels()
+{
+	int texChannels;
+	float* pixels = stbi_loadf(m_TexturePath.c_str(), &m_TexWidth, &m_TexHeight, &texChannels, STBI_rgb_alpha);
+	if (!pixels) throw std::runtime_error("Failed to load float texture");
 
-	m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_TexWidth, m_TexHeight)))) + 1;
+	const uint32_t width = static_cast<uint32_t>(m_TexWidth);
+	const uint32_t height = static_cast<uint32_t>(m_TexHeight);
 
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-	buffer->CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		stagingBuffer, stagingBufferMemory);
+	// Filtered in full precision, only the stored levels are rounded to half
+	const auto mipStart = std::chrono::high_resolution_clock::now();
+	const std::vector<FloatMipLevel> mips = GenerateMipChain(pixels, width, height);
+	m_MipGenerationMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - mipStart).count();
+	m_LevelStorage.reserve(mips.size() + 1);
 
-	void* data;
-	vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-	memcpy(data, m_Pixels, static_cast<size_t>(imageSize));
-	vkUnmapMemory(device, stagingBufferMemory);
+	const auto addHalfLevel = [this](const float* source, uint32_t levelWidth, uint32_t levelHeight)
+	{
+		const size_t valueCount = static_cast<size_t>(levelWidth) * levelHeight * 4;
+		std::vector<uint8_t> data(valueCount * sizeof(uint16_t));
 
-	if (loadedPixels) stbi_image_free(loadedPixels);
+		FloatToHalf(source, reinterpret_cast<uint16_t*>(data.data()), valueCount);
+		AddLevel(levelWidth, levelHeight, std::move(data));
+	};
 
-	m_TotalImage.CreateImage(m_TexWidth, m_TexHeight, m_MipLevels, VK_SAMPLE_COUNT_1_BIT, m_ImgFormat,
-		VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, device, physicalDevice);
+	addHalfLevel(pixels, width, height);
+	stbi_image_free(pixels);
 
-	TransitionImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, commandManager, graphicsQueue, device);
-	CopyBufferToImage(stagingBuffer, commandManager, graphicsQueue, device);
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
-	GenerateMipmaps(commandManager, graphicsQueue, device, physicalDevice);
+	for (const FloatMipLevel& mip : mips)
+	{
+		addHalfLevel(mip.Pixels.data(), mip.Width, mip.Height);
+	}
 }
 
-
-void Texture::TransitionImageLayout(const VkImageLayout oldLayout, const VkImageLayout newLayout, const CommandManager* commandManager, const VkQueue graphicsQueue, const VkDevice device)
+void Texture::AddLevel(uint32_t width, uint32_t height, std::vector<uint8_t> data)
 {
-	VkCommandBuffer commandBuffer = commandManager->BeginSingleTimeCommands(device);
-
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = oldLayout;
-	barrier.newLayout = newLayout;
+	const std::vector<uint8_t>& storage = m_LevelStorage.emplace_back(std::move(data));
+	m_Levels.push_back({ width, height, storage });
+}
 
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+void Texture::ReleaseDecodedPixels()
+{
+	m_Levels.clear();
+	m_LevelStorage = {};
+	m_TextureCache.reset();
+	m_IsDecoded = false;
 
-	barrier.image = m_TotalImage.GetImage();
-	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseMipLevel = 0;
-	barrier.subresourceRange.levelCount = m_MipLevels;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
+	if (!m_IsUsingPath) return;
 
-	VkPipelineStageFlags sourceStage;
-	VkPipelineStageFlags destinationStage;
+	if (m_DecodedPixels) stbi_image_free(m_DecodedPixels);
+	m_DecodedPixels = nullptr;
+	m_Pixels = nullptr;
+}
 
-	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-		barrier.srcAccessMask = 0;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+void Texture::CreateTextureImage(Buffer* buffer, UploadQueue& uploadQueue, const VkDevice device, const VkPhysicalDevice physicalDevice, uint32_t firstMip)
+{
+	// Scene::CreateImages decodes on the thread pool, anything else falls back to decoding here
+	Decode();
+
+	firstMip = std::min(firstMip, static_cast<uint32_t>(m_Levels.size()) - 1);
+	m_FirstMip = firstMip;
+	m_MipLevels = static_cast<uint32_t>(m_Levels.size()) - firstMip;
+	const std::span<const TextureCacheLevel> levels(m_Levels.data() + firstMip, m_MipLevels);
+
+	// Every level goes up in one copy, offsets are kept at 16 bytes which covers texel and block alignment of all formats used
+	std::vector<VkBufferImageCopy> regions(m_MipLevels);
+	VkDeviceSize imageSize = 0;
+	for (uint32_t level = 0; level < m_MipLevels; ++level)
+	{
+		VkBufferImageCopy& region = regions[level];
+		region.bufferOffset = imageSize;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { levels[level].Width, levels[level].Height, 1 };
 
-		sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		imageSize = (imageSize + levels[level].Data.size() + 15) & ~VkDeviceSize(15);
 	}
-	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	const StagingBuffer staging = uploadQueue.AcquireStagingBuffer(imageSize);
+	for (uint32_t level = 0; level < m_MipLevels; ++level)
+	{
+		memcpy(static_cast<uint8_t*>(staging.GetMapped()) + regions[level].bufferOffset, levels[level].Data.data(), levels[level].Data.size());
 	}
-	else {
-		throw std::invalid_argument("unsupported layout transition!");
+
+	const VkFormat uploadFormat = GetUploadFormat();
+	const uint32_t width = levels[0].Width;
+	const uint32_t height = levels[0].Height;
+	if (!m_IsRetainingLevels)
+	{
+		ReleaseDecodedPixels();
 	}
 
-	vkCmdPipelineBarrier
-	(
-		commandBuffer,
-		sourceStage,
-		destinationStage,
-		0,
-		0, nullptr,
-		0, nullptr,
-		1, &barrier
-	);
+	m_TotalImage.CreateImage(width, height, m_MipLevels, VK_SAMPLE_COUNT_1_BIT, uploadFormat,
+		VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer->GetMemoryAllocator(), MemoryCategory::Textures);
 
-	commandManager->EndSingleTimeCommands(graphicsQueue, commandBuffer, device);
+	// Recorded into the open upload batch, the image is only sampled once the batch's ticket is ready
+	VkCommandBuffer commandBuffer = uploadQueue.GetCommandBuffer();
 
-}
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = m_TotalImage.GetImage();
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, 1 };
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 
-void Texture::CopyBufferToImage(const VkBuffer buffer, const CommandManager* commandManager, const VkQueue graphicsQueue, const VkDevice device) 
-{
-	VkCommandBuffer commandBuffer = commandManager->BeginSingleTimeCommands(device);
-
-	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-
-	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
-	region.imageSubresource.layerCount = 1;
-
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = { static_cast<uint32_t>(m_TexWidth), static_cast<uint32_t>(m_TexHeight), 1 };
-
-	vkCmdCopyBufferToImage
-	(
-		commandBuffer,
-		buffer,
-		m_TotalImage.GetImage(),
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		1,
-		&region
-	);
-
-	commandManager->EndSingleTimeCommands(graphicsQueue,commandBuffer,device);
+	vkCmdCopyBufferToImage(commandBuffer, staging.Buffer, m_TotalImage.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<uint32_t>(regions.size()), regions.data());
+
+	uploadQueue.ReleaseImage(m_TotalImage.GetImage(), m_MipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
 }
 
 void Texture::CreateTextureImageView( const VkDevice device)
 {
-	m_TotalImage.CreateImageView(m_ImgFormat, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels, device);
+	m_TotalImage.CreateImageView(m_TotalImage.GetImageFormat(), VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels, device);
 }
 
 void Texture::DestroyTexture(const VkDevice device) const
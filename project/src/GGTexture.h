@@ -1,14 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 #include "GGImage.h"
+#include "GGTextureCache.h"
+#include "GGTextureCompressor.h"
 #include <stb_image.h>
 
 namespace GG
 {
-	class CommandManager;
 	class Buffer;
+	class UploadQueue;
 
 	class Texture
 	{
@@ -17,12 +21,35 @@ namespace GG
 
 		Texture(std::unique_ptr<stbi_uc[]> pixels, int width, int height, VkFormat format);
 
-		void GenerateMipmaps(const CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device, VkPhysicalDevice physicalDevice);
+		// CPU side decode and mip chain of the texture, touches no Vulkan state so it can run on a worker thread.
+		// Path based textures load the finished chain from their cache file when it is up to date
+		void Decode();
+		float GetDecodeTime() const { return m_DecodeMs; }
+		// Parts of the decode time, 0 when the levels came from the cache
+		float GetMipGenerationTime() const { return m_MipGenerationMs; }
+		float GetCompressTime() const { return m_CompressMs; }
+		const std::string& GetTexturePath() const { return m_TexturePath; }
+		bool IsUsingPath() const { return m_IsUsingPath; }
 
+		// Path based 8 bit textures are transcoded to a BC format picked from the usage, the usage also picks the mip filter.
+		// Both have to be set before Decode
+		void SetUsage(TextureUsage usage) { m_Usage = usage; }
+		TextureUsage GetUsage() const { return m_Usage; }
+		void SetBlockCompression(bool isEnabled) { m_IsBlockCompressionEnabled = isEnabled; }
+		// VK_FORMAT_UNDEFINED when the texture is uploaded uncompressed
+		VkFormat GetCompressedFormat() const { return m_CompressedFormat; }
+		bool IsCacheHit() const { return m_IsCacheHit; }
+		// Frees whatever Decode produced, CreateImage calls this once the data is in the staging buffer unless levels are retained
+		void ReleaseDecodedPixels();
+		// Keeps every decoded level after the upload so the image can be recreated with a different first mip
+		void SetLevelRetention(bool isRetaining) { m_IsRetainingLevels = isRetaining; }
+		// Byte size of every decoded level from mip 0, empty once the levels are released
+		std::vector<uint64_t> GetLevelSizes() const;
 
-		//multisampling
-		void CreateImage(Buffer* buffer, const CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device, VkPhysicalDevice physicalDevice);
-		void CopyBufferToImage(VkBuffer buffer, const CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device);
+		// Records the upload into the open batch of uploadQueue, the image may be sampled once that batch is ready.
+		// firstMip drops the finer levels, the image then starts at that level's size
+		void CreateImage(Buffer* buffer, UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice, uint32_t firstMip = 0);
+		uint32_t GetFirstMip() const { return m_FirstMip; }
 		void CreateTextureImageView(VkDevice device);
 
 		VkImageView& GetImageView() { return m_TotalImage.GetImageView(); }
@@ -30,18 +57,43 @@ namespace GG
 		VkImage& GetImage() { return m_TotalImage.GetImage(); }
 		VkFormat& GetImageFormat() { return m_TotalImage.GetImageFormat(); }
 		VkImageLayout& GetImageLayout() { return m_TotalImage.GetCurrentLayout(); }
+		VkFormat GetSourceFormat() const { return m_ImgFormat; }
+		// Level 0 size, known once the texture is decoded
+		uint32_t GetWidth() const { return static_cast<uint32_t>(m_TexWidth); }
+		uint32_t GetHeight() const { return static_cast<uint32_t>(m_TexHeight); }
 
 		void DestroyTexture(VkDevice device) const;
 	private:
-		void CreateTextureImage(Buffer* buffer, const CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device, VkPhysicalDevice physicalDevice);
-		void TransitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout, const CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device);
+		void CreateTextureImage(Buffer* buffer, UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice, uint32_t firstMip);
+		void DecodeFile();
+		void DecodeHalfFloatLevels();
+		// Uncompressed level 0 is referenced in place, levels 1 and up are built with the CPU mip filters
+		void GenerateLevels(const stbi_uc* pixels);
+		void AddLevel(uint32_t width, uint32_t height, std::vector<uint8_t> data);
+		VkFormat GetUploadFormat() const { return m_CompressedFormat != VK_FORMAT_UNDEFINED ? m_CompressedFormat : m_ImgFormat; }
 
 		uint32_t m_MipLevels;
+		uint32_t m_FirstMip = 0;
+		bool m_IsRetainingLevels = false;
 		Image m_TotalImage;
 
 		const std::string m_TexturePath;
 		stbi_uc* m_Pixels;
 		std::unique_ptr<stbi_uc[]> m_ManagedPixels;
+		stbi_uc* m_DecodedPixels = nullptr;
+		bool m_IsDecoded = false;
+		float m_DecodeMs = 0.f;
+		float m_MipGenerationMs = 0.f;
+		float m_CompressMs = 0.f;
+
+		TextureUsage m_Usage = TextureUsage::Color;
+		bool m_IsBlockCompressionEnabled = false;
+		VkFormat m_CompressedFormat = VK_FORMAT_UNDEFINED;
+		bool m_IsCacheHit = false;
+		std::unique_ptr<TextureCache> m_TextureCache;
+		// Every mip level ready for upload, pointing into the cache mapping, the decoded pixels or m_LevelStorage
+		std::vector<TextureCacheLevel> m_Levels;
+		std::vector<std::vector<uint8_t>> m_LevelStorage;
 
 		bool m_IsUsingPath;
 		int32_t m_TexWidth;
@@ -0,0 +1,225 @@
+#include "GGTextureCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+using namespace GG;
+
+namespace
+{
+	struct TextureCacheHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint64_t SourceSize;
+		int64_t SourceWriteTime;
+		uint32_t Format;
+		uint32_t LevelCount;
+		uint32_t MipFilter;
+		uint32_t Padding;
+	};
+
+	struct TextureLevelEntry
+	{
+		uint64_t DataOffset;
+		uint64_t DataSize;
+		uint32_t Width;
+		uint32_t Height;
+	};
+
+	constexpr char CacheMagic[4] = { 'G', 'G', 'T', 'C' };
+	constexpr size_t BlobAlignment = 16;
+
+	// Largest level 0 side a cache is trusted with, and the longest mip chain that goes with it
+	constexpr uint32_t MaxCachedDimension = 16384;
+	constexpr uint32_t MaxCachedLevelCount = 15;
+
+	bool IsRangeValid(uint64_t offset, uint64_t size, size_t fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	// Byte size a level of the format has to have, 0 for a format the cache never stores
+	uint64_t GetExpectedLevelSize(VkFormat format, uint32_t width, uint32_t height)
+	{
+		const uint64_t blockCount = static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4);
+		const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+
+		switch (format)
+		{
+		case VK_FORMAT_BC4_UNORM_BLOCK:
+			return blockCount * 8;
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			return blockCount * 16;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+			return pixelCount * 4;
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+			return pixelCount * 8;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			return pixelCount * 16;
+		default:
+			return 0;
+		}
+	}
+
+	// Level 0 within MaxCachedDimension, every further level halved down to 1 and no more levels than the full chain
+	bool IsLevelValid(const TextureLevelEntry& entry, const TextureLevelEntry* pPrevious, VkFormat format)
+	{
+		if (entry.Width == 0 || entry.Height == 0) return false;
+
+		if (!pPrevious)
+		{
+			if (entry.Width > MaxCachedDimension || entry.Height > MaxCachedDimension) return false;
+		}
+		else
+		{
+			// A previous level of 1 x 1 ends the chain, the next one would have the same size
+			if (pPrevious->Width == 1 && pPrevious->Height == 1) return false;
+			if (entry.Width != std::max(1u, pPrevious->Width >> 1) || entry.Height != std::max(1u, pPrevious->Height >> 1)) return false;
+		}
+
+		const uint64_t expectedSize = GetExpectedLevelSize(format, entry.Width, entry.Height);
+		return expectedSize != 0 && entry.DataSize == expectedSize;
+	}
+}
+
+TextureCache::TextureCache(const std::string& sourcePath, VkFormat format, MipFilter mipFilter)
+	: m_SourcePath(sourcePath), m_CachePath(sourcePath + ".ggtex"), m_Format(format), m_MipFilter(mipFilter)
+{
+}
+
+bool TextureCache::ReadSourceStamp()
+{
+	std::error_code error;
+	m_SourceSize = std::filesystem::file_size(m_SourcePath, error);
+	if (error) return false;
+
+	const auto writeTime = std::filesystem::last_write_time(m_SourcePath, error);
+	if (error) return false;
+
+	m_SourceWriteTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+	return true;
+}
+
+bool TextureCache::Load()
+{
+	m_Levels.clear();
+
+	if (!ReadSourceStamp() || !m_MappedFile.Open(m_CachePath))
+	{
+		return false;
+	}
+
+	const uint8_t* data = m_MappedFile.GetData();
+	const size_t fileSize = m_MappedFile.GetSize();
+
+	TextureCacheHeader header{};
+	if (fileSize < sizeof(header))
+	{
+		m_MappedFile.Close();
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+
+	if (memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.Version != m_Version || header.Format != static_cast<uint32_t>(m_Format) ||
+		header.MipFilter != static_cast<uint32_t>(m_MipFilter) ||
+		header.SourceSize != m_SourceSize || header.SourceWriteTime != m_SourceWriteTime || header.LevelCount == 0 || header.LevelCount > MaxCachedLevelCount ||
+		!IsRangeValid(sizeof(header), static_cast<uint64_t>(header.LevelCount) * sizeof(TextureLevelEntry), fileSize))
+	{
+		m_MappedFile.Close();
+		return false;
+	}
+
+	m_Levels.reserve(header.LevelCount);
+	TextureLevelEntry previous{};
+	for (uint32_t i = 0; i < header.LevelCount; ++i)
+	{
+		TextureLevelEntry entry;
+		memcpy(&entry, data + sizeof(header) + i * sizeof(TextureLevelEntry), sizeof(entry));
+
+		// CreateTextureImage sizes the image and its copy regions from these, so they have to match the format exactly
+		if (!IsRangeValid(entry.DataOffset, entry.DataSize, fileSize) || !IsLevelValid(entry, i > 0 ? &previous : nullptr, m_Format))
+		{
+			std::cerr << "WARNING: Corrupt texture cache: " << m_CachePath << "\n";
+			m_Levels.clear();
+			m_MappedFile.Close();
+			return false;
+		}
+
+		m_Levels.push_back({ entry.Width, entry.Height, { data + entry.DataOffset, static_cast<size_t>(entry.DataSize) } });
+		previous = entry;
+	}
+
+	return true;
+}
+
+bool TextureCache::Write(const std::vector<TextureCacheLevel>& levels)
+{
+	if (levels.empty() || !ReadSourceStamp())
+	{
+		return false;
+	}
+
+	const size_t tableSize = levels.size() * sizeof(TextureLevelEntry);
+	std::vector<uint8_t> fileData(sizeof(TextureCacheHeader) + tableSize);
+	std::vector<TextureLevelEntry> entries(levels.size());
+
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		fileData.resize((fileData.size() + BlobAlignment - 1) & ~(BlobAlignment - 1));
+		entries[i].DataOffset = fileData.size();
+		entries[i].DataSize = levels[i].Data.size();
+		entries[i].Width = levels[i].Width;
+		entries[i].Height = levels[i].Height;
+		fileData.insert(fileData.end(), levels[i].Data.begin(), levels[i].Data.end());
+	}
+
+	TextureCacheHeader header{};
+	memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = m_Version;
+	header.SourceSize = m_SourceSize;
+	header.SourceWriteTime = m_SourceWriteTime;
+	header.Format = static_cast<uint32_t>(m_Format);
+	header.LevelCount = static_cast<uint32_t>(levels.size());
+	header.MipFilter = static_cast<uint32_t>(m_MipFilter);
+	memcpy(fileData.data(), &header, sizeof(header));
+	memcpy(fileData.data() + sizeof(header), entries.data(), tableSize);
+
+	// Same temporary file and rename as the mesh cache, a crash never leaves a half written cache behind
+	Close();
+	const std::string tempPath = m_CachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open() || !file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size())))
+		{
+			std::cerr << "WARNING: Failed to write texture cache: " << tempPath << "\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, m_CachePath, error);
+	if (error)
+	{
+		std::cerr << "WARNING: Failed to write texture cache: " << m_CachePath << " (" << error.message() << ")\n";
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+void TextureCache::Close()
+{
+	m_Levels.clear();
+	m_MappedFile.Close();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMappedFile.h"
+#include "GGMipmaps.h"
+
+namespace GG
+{
+	struct TextureCacheLevel
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::span<const uint8_t> Data;
+	};
+
+	// Finished mip chain of one texture file, stored next to it and memory mapped on load.
+	// Keyed by the source file size and write time and by the stored format and mip filter.
+	class TextureCache
+	{
+	public:
+		TextureCache(const std::string& sourcePath, VkFormat format, MipFilter mipFilter);
+
+		bool Load();
+		bool Write(const std::vector<TextureCacheLevel>& levels);
+
+		const std::vector<TextureCacheLevel>& GetLevels() const { return m_Levels; }
+		VkFormat GetFormat() const { return m_Format; }
+		const std::string& GetCachePath() const { return m_CachePath; }
+		void Close();
+
+	private:
+		bool ReadSourceStamp();
+
+		static constexpr uint32_t m_Version = 2;
+
+		std::string m_SourcePath;
+		std::string m_CachePath;
+		VkFormat m_Format;
+		MipFilter m_MipFilter;
+
+		uint64_t m_SourceSize = 0;
+		int64_t m_SourceWriteTime = 0;
+
+		MappedFile m_MappedFile;
+		std::vector<TextureCacheLevel> m_Levels;
+	};
+}
@@ -0,0 +1,315 @@
+#include "GGTextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace GG;
+
+namespace
+{
+	constexpr uint32_t BlockSize = 4;
+
+	// BC7 4 bit index interpolation weights, out of 64
+	constexpr int32_t Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	class BitWriter
+	{
+	public:
+		explicit BitWriter(uint8_t* dst) : m_Dst(dst) { memset(m_Dst, 0, 16); }
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; ++i, ++m_Position)
+			{
+				m_Dst[m_Position >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (m_Position & 7));
+			}
+		}
+
+	private:
+		uint8_t* m_Dst;
+		uint32_t m_Position = 0;
+	};
+
+	int32_t Interpolate4(int32_t e0, int32_t e1, uint32_t index)
+	{
+		return ((64 - Bc7Weights4[index]) * e0 + Bc7Weights4[index] * e1 + 32) >> 6;
+	}
+
+	void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* pixels)
+	{
+		for (uint32_t y = 0; y < BlockSize; ++y)
+		{
+			const uint32_t sourceY = std::min(blockY * BlockSize + y, height - 1);
+			for (uint32_t x = 0; x < BlockSize; ++x)
+			{
+				const uint32_t sourceX = std::min(blockX * BlockSize + x, width - 1);
+				memcpy(pixels + (y * BlockSize + x) * 4, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	struct Bc7Candidate
+	{
+		int32_t Endpoints[2][4];   // 8 bit values, p-bit included
+		uint8_t Indices[16];
+		int64_t Error;
+	};
+
+	// Mode 6 endpoints are 7 bits per channel plus one shared p-bit per endpoint
+	void QuantizeEndpoint(const float* endpoint, uint32_t pBit, int32_t* quantized)
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			const int32_t value = static_cast<int32_t>(std::lround((endpoint[c] - static_cast<float>(pBit)) * 0.5f));
+			quantized[c] = (std::clamp(value, 0, 127) << 1) | static_cast<int32_t>(pBit);
+		}
+	}
+
+	void FindIndices(const uint8_t* pixels, Bc7Candidate& candidate)
+	{
+		int32_t palette[16][4];
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				palette[i][c] = Interpolate4(candidate.Endpoints[0][c], candidate.Endpoints[1][c], i);
+			}
+		}
+
+		int32_t axis[4];
+		int64_t axisLengthSquared = 0;
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			axis[c] = candidate.Endpoints[1][c] - candidate.Endpoints[0][c];
+			axisLengthSquared += static_cast<int64_t>(axis[c]) * axis[c];
+		}
+
+		candidate.Error = 0;
+		for (uint32_t p = 0; p < 16; ++p)
+		{
+			const uint8_t* pixel = pixels + p * 4;
+
+			// Project onto the endpoint line, then check the neighbouring palette entries since the weights are not uniform
+			int32_t guess = 0;
+			if (axisLengthSquared > 0)
+			{
+				int64_t projection = 0;
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					projection += static_cast<int64_t>(pixel[c] - candidate.Endpoints[0][c]) * axis[c];
+				}
+				guess = static_cast<int32_t>(std::clamp<int64_t>((projection * 15 + axisLengthSquared / 2) / axisLengthSquared, 0, 15));
+			}
+
+			int64_t bestError = INT64_MAX;
+			uint8_t bestIndex = 0;
+			for (int32_t index = std::max(guess - 1, 0); index <= std::min(guess + 1, 15); ++index)
+			{
+				int64_t error = 0;
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					const int64_t difference = pixel[c] - palette[index][c];
+					error += difference * difference;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = static_cast<uint8_t>(index);
+				}
+			}
+
+			candidate.Indices[p] = bestIndex;
+			candidate.Error += bestError;
+		}
+	}
+}
+
+VkFormat GG::GetCompressedFormat(VkFormat sourceFormat, TextureUsage usage)
+{
+	if (sourceFormat != VK_FORMAT_R8G8B8A8_SRGB && sourceFormat != VK_FORMAT_R8G8B8A8_UNORM) return VK_FORMAT_UNDEFINED;
+
+	switch (usage)
+	{
+	case TextureUsage::Color:
+		return sourceFormat == VK_FORMAT_R8G8B8A8_SRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+	case TextureUsage::NormalMap:
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case TextureUsage::MetallicRoughness:
+		return VK_FORMAT_BC7_UNORM_BLOCK;
+	case TextureUsage::Occlusion:
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	}
+
+	return VK_FORMAT_UNDEFINED;
+}
+
+const char* GG::GetCompressedFormatName(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC7_SRGB_BLOCK: return "BC7 sRGB";
+	case VK_FORMAT_BC7_UNORM_BLOCK: return "BC7";
+	case VK_FORMAT_BC5_UNORM_BLOCK: return "BC5";
+	case VK_FORMAT_BC4_UNORM_BLOCK: return "BC4";
+	default: return "uncompressed";
+	}
+}
+
+size_t GG::GetCompressedSize(VkFormat format, uint32_t width, uint32_t height)
+{
+	const size_t blockCount = static_cast<size_t>((width + BlockSize - 1) / BlockSize) * ((height + BlockSize - 1) / BlockSize);
+	return blockCount * (format == VK_FORMAT_BC4_UNORM_BLOCK ? 8 : 16);
+}
+
+void GG::CompressImage(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst)
+{
+	const uint32_t blocksX = (width + BlockSize - 1) / BlockSize;
+	const uint32_t blocksY = (height + BlockSize - 1) / BlockSize;
+	const size_t blockBytes = format == VK_FORMAT_BC4_UNORM_BLOCK ? 8 : 16;
+
+	uint8_t pixels[16 * 4];
+	for (uint32_t blockY = 0; blockY < blocksY; ++blockY)
+	{
+		for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+		{
+			LoadBlock(rgba, width, height, blockX, blockY, pixels);
+			uint8_t* block = dst + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+
+			switch (format)
+			{
+			case VK_FORMAT_BC4_UNORM_BLOCK: EncodeBC4Block(pixels, 0, block); break;
+			case VK_FORMAT_BC5_UNORM_BLOCK: EncodeBC5Block(pixels, block); break;
+			default: EncodeBC7Block(pixels, block); break;
+			}
+		}
+	}
+}
+
+void GG::EncodeBC4Block(const uint8_t* pixels, uint32_t channel, uint8_t* dst)
+{
+	int32_t minValue = 255;
+	int32_t maxValue = 0;
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		minValue = std::min<int32_t>(minValue, pixels[p * 4 + channel]);
+		maxValue = std::max<int32_t>(maxValue, pixels[p * 4 + channel]);
+	}
+
+	// Endpoint 0 > endpoint 1 selects the 8 value ramp, a flat block just uses index 0
+	dst[0] = static_cast<uint8_t>(maxValue);
+	dst[1] = static_cast<uint8_t>(minValue);
+
+	const int32_t range = maxValue - minValue;
+	uint64_t indexBits = 0;
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		uint64_t index = 0;
+		if (range > 0)
+		{
+			// Position on the ramp from min (0) to max (7), then mapped to the BC4 palette order
+			const int32_t step = ((pixels[p * 4 + channel] - minValue) * 7 + range / 2) / range;
+			index = step == 7 ? 0 : step == 0 ? 1 : static_cast<uint64_t>(8 - step);
+		}
+		indexBits |= index << (p * 3);
+	}
+
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		dst[2 + i] = static_cast<uint8_t>(indexBits >> (i * 8));
+	}
+}
+
+void GG::EncodeBC5Block(const uint8_t* pixels, uint8_t* dst)
+{
+	EncodeBC4Block(pixels, 0, dst);
+	EncodeBC4Block(pixels, 1, dst + 8);
+}
+
+void GG::EncodeBC7Block(const uint8_t* pixels, uint8_t* dst)
+{
+	// Mode 6: one subset, RGBA endpoints, 4 bit indices. Endpoints come from the principal axis of the block
+	float mean[4] = {};
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		for (uint32_t c = 0; c < 4; ++c) mean[c] += pixels[p * 4 + c];
+	}
+	for (float& m : mean) m /= 16.f;
+
+	float covariance[4][4] = {};
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		float offset[4];
+		for (uint32_t c = 0; c < 4; ++c) offset[c] = pixels[p * 4 + c] - mean[c];
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			for (uint32_t j = 0; j < 4; ++j) covariance[i][j] += offset[i] * offset[j];
+		}
+	}
+
+	float axis[4] = { 1.f, 1.f, 1.f, 1.f };
+	for (uint32_t iteration = 0; iteration < 8; ++iteration)
+	{
+		float next[4] = {};
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			for (uint32_t j = 0; j < 4; ++j) next[i] += covariance[i][j] * axis[j];
+		}
+
+		const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+		if (length < 1e-6f) break;
+		for (uint32_t c = 0; c < 4; ++c) axis[c] = next[c] / length;
+	}
+
+	float minProjection = 0.f;
+	float maxProjection = 0.f;
+	for (uint32_t p = 0; p < 16; ++p)
+	{
+		float projection = 0.f;
+		for (uint32_t c = 0; c < 4; ++c) projection += (pixels[p * 4 + c] - mean[c]) * axis[c];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	float endpoints[2][4];
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		endpoints[0][c] = std::clamp(mean[c] + axis[c] * minProjection, 0.f, 255.f);
+		endpoints[1][c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.f, 255.f);
+	}
+
+	Bc7Candidate best{};
+	best.Error = INT64_MAX;
+	for (uint32_t pBits = 0; pBits < 4; ++pBits)
+	{
+		Bc7Candidate candidate{};
+		QuantizeEndpoint(endpoints[0], pBits & 1, candidate.Endpoints[0]);
+		QuantizeEndpoint(endpoints[1], pBits >> 1, candidate.Endpoints[1]);
+		FindIndices(pixels, candidate);
+
+		if (candidate.Error < best.Error) best = candidate;
+	}
+
+	// The first index is stored with its top bit implied zero
+	if (best.Indices[0] >= 8)
+	{
+		std::swap(best.Endpoints[0], best.Endpoints[1]);
+		for (uint8_t& index : best.Indices) index = static_cast<uint8_t>(15 - index);
+	}
+
+	BitWriter writer(dst);
+	writer.Write(1u << 6, 7);
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		writer.Write(static_cast<uint32_t>(best.Endpoints[0][c]) >> 1, 7);
+		writer.Write(static_cast<uint32_t>(best.Endpoints[1][c]) >> 1, 7);
+	}
+	writer.Write(static_cast<uint32_t>(best.Endpoints[0][0]) & 1, 1);
+	writer.Write(static_cast<uint32_t>(best.Endpoints[1][0]) & 1, 1);
+
+	writer.Write(best.Indices[0], 3);
+	for (uint32_t p = 1; p < 16; ++p)
+	{
+		writer.Write(best.Indices[p], 4);
+	}
+}
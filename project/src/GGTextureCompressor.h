@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+namespace GG
+{
+	// What a texture is sampled for, decides the block compressed format it is stored in
+	enum class TextureUsage
+	{
+		Color,              // BC7, keeps the sRGB-ness of the requested format
+		NormalMap,          // BC5, X and Y only, the shader rebuilds Z
+		MetallicRoughness,  // BC7, roughness and metallic live in G and B
+		Occlusion           // BC4, R only
+	};
+
+	// VK_FORMAT_UNDEFINED when the texture stays uncompressed (HDR sources and anything that is not 8 bit RGBA)
+	VkFormat GetCompressedFormat(VkFormat sourceFormat, TextureUsage usage);
+	const char* GetCompressedFormatName(VkFormat format);
+
+	size_t GetCompressedSize(VkFormat format, uint32_t width, uint32_t height);
+
+	// rgba is tightly packed 8 bit RGBA, dst must hold GetCompressedSize bytes. Partial edge blocks repeat the last row/column.
+	// Pure CPU work, safe to call from several threads on different images.
+	void CompressImage(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst);
+
+	// Single blocks, pixels are 16 RGBA texels in row order
+	void EncodeBC4Block(const uint8_t* pixels, uint32_t channel, uint8_t* dst);
+	void EncodeBC5Block(const uint8_t* pixels, uint8_t* dst);
+	void EncodeBC7Block(const uint8_t* pixels, uint8_t* dst);
+}
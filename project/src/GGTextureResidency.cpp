@@ -0,0 +1,171 @@
+#include "GGTextureResidency.h"
+
+#include <algorithm>
+
+using namespace GG;
+
+uint32_t TextureResidency::AddTexture(uint32_t textureIndex, const std::vector<uint64_t>& levelSizes)
+{
+	if (textureIndex >= m_Textures.size())
+	{
+		m_Textures.resize(textureIndex + 1);
+	}
+
+	Entry& entry = m_Textures[textureIndex];
+	if (!entry.LevelBytes.empty())
+	{
+		m_ResidentBytes -= GetBytes(entry, entry.ResidentMip);
+	}
+
+	const uint32_t mipCount = static_cast<uint32_t>(levelSizes.size());
+	entry.LevelBytes.assign(mipCount, 0);
+	uint64_t chainBytes = 0;
+	for (uint32_t mip = mipCount; mip-- > 0;)
+	{
+		chainBytes += levelSizes[mip];
+		entry.LevelBytes[mip] = chainBytes;
+	}
+
+	entry.TailMip = mipCount > m_TailMipCount ? mipCount - m_TailMipCount : 0;
+	entry.ResidentMip = entry.TailMip;
+	entry.RequestedMip = entry.TailMip;
+	entry.LastRequestFrame = m_Frame;
+	entry.IsRequested = false;
+
+	// The tail is outside the budget, it is what keeps a texture visible at all
+	m_ResidentBytes += GetBytes(entry, entry.ResidentMip);
+	return entry.ResidentMip;
+}
+
+void TextureResidency::RequestMip(uint32_t textureIndex, uint32_t mip)
+{
+	if (!IsManaged(textureIndex)) return;
+
+	Entry& entry = m_Textures[textureIndex];
+	mip = std::min(mip, entry.TailMip);
+
+	if (!entry.IsRequested || mip < entry.RequestedMip)
+	{
+		entry.RequestedMip = mip;
+	}
+	entry.IsRequested = true;
+	entry.LastRequestFrame = m_Frame;
+}
+
+std::vector<TextureResidencyChange> TextureResidency::Update(uint32_t maxStreamIns)
+{
+	constexpr uint32_t NoProtectedTexture = ~0u;
+	std::vector<TextureResidencyChange> changes;
+
+	// A lowered budget is honoured even when nothing asks for more
+	while (m_ResidentBytes > m_BudgetBytes && EvictOne(NoProtectedTexture, changes)) {}
+
+	std::vector<uint32_t> candidates;
+	for (uint32_t i = 0; i < m_Textures.size(); ++i)
+	{
+		const Entry& entry = m_Textures[i];
+		if (entry.IsRequested && entry.RequestedMip < entry.ResidentMip)
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b)
+	{
+		const uint32_t shortfallA = m_Textures[a].ResidentMip - m_Textures[a].RequestedMip;
+		const uint32_t shortfallB = m_Textures[b].ResidentMip - m_Textures[b].RequestedMip;
+		return shortfallA != shortfallB ? shortfallA > shortfallB : a < b;
+	});
+	candidates.resize(std::min<size_t>(candidates.size(), maxStreamIns));
+
+	for (uint32_t textureIndex : candidates)
+	{
+		const Entry& entry = m_Textures[textureIndex];
+		const auto bytesWith = [&](uint32_t mip) { return m_ResidentBytes - GetBytes(entry, entry.ResidentMip) + GetBytes(entry, mip); };
+
+		uint32_t mip = entry.RequestedMip;
+		while (bytesWith(mip) > m_BudgetBytes && EvictOne(textureIndex, changes)) {}
+
+		// Whatever still does not fit is granted from the coarse end
+		while (mip < entry.ResidentMip && bytesWith(mip) > m_BudgetBytes)
+		{
+			++mip;
+		}
+
+		if (mip < entry.ResidentMip)
+		{
+			SetResidentMip(textureIndex, mip, changes);
+			++m_Stats.StreamInCount;
+		}
+	}
+
+	m_Stats.BudgetBytes = m_BudgetBytes;
+	m_Stats.ResidentBytes = m_ResidentBytes;
+	m_Stats.RequestedBytes = 0;
+	m_Stats.TextureCount = 0;
+	m_Stats.ReducedTextureCount = 0;
+	for (Entry& entry : m_Textures)
+	{
+		if (entry.LevelBytes.empty()) continue;
+
+		++m_Stats.TextureCount;
+		m_Stats.RequestedBytes += GetBytes(entry, entry.RequestedMip);
+		m_Stats.ReducedTextureCount += entry.ResidentMip > entry.RequestedMip ? 1 : 0;
+		entry.IsRequested = false;
+	}
+
+	++m_Frame;
+	return changes;
+}
+
+bool TextureResidency::EvictOne(uint32_t protectedIndex, std::vector<TextureResidencyChange>& changes)
+{
+	// Textures nobody asked for this frame go first, oldest request first, and fall back to their tail.
+	// After that textures seen this frame give back the mips finer than they asked for.
+	uint32_t victim = ~0u;
+	uint32_t victimMip = 0;
+	bool isVictimUnused = false;
+
+	for (uint32_t i = 0; i < m_Textures.size(); ++i)
+	{
+		const Entry& entry = m_Textures[i];
+		if (i == protectedIndex || entry.LevelBytes.empty()) continue;
+
+		const bool isUnused = entry.LastRequestFrame < m_Frame;
+		const uint32_t targetMip = isUnused ? entry.TailMip : entry.RequestedMip;
+		if (entry.ResidentMip >= targetMip) continue;
+
+		const bool isBetter = victim == ~0u
+			|| (isUnused && !isVictimUnused)
+			|| (isUnused == isVictimUnused && entry.LastRequestFrame < m_Textures[victim].LastRequestFrame);
+		if (isBetter)
+		{
+			victim = i;
+			victimMip = targetMip;
+			isVictimUnused = isUnused;
+		}
+	}
+
+	if (victim == ~0u) return false;
+
+	SetResidentMip(victim, victimMip, changes);
+	++m_Stats.EvictionCount;
+	return true;
+}
+
+void TextureResidency::SetResidentMip(uint32_t textureIndex, uint32_t mip, std::vector<TextureResidencyChange>& changes)
+{
+	Entry& entry = m_Textures[textureIndex];
+	m_ResidentBytes = m_ResidentBytes - GetBytes(entry, entry.ResidentMip) + GetBytes(entry, mip);
+	entry.ResidentMip = mip;
+
+	const auto change = std::find_if(changes.begin(), changes.end(), [textureIndex](const TextureResidencyChange& c) { return c.TextureIndex == textureIndex; });
+	if (change != changes.end())
+	{
+		change->FirstMip = mip;
+	}
+	else
+	{
+		changes.push_back({ textureIndex, mip });
+	}
+}
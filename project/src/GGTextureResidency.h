@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace GG
+{
+	struct TextureResidencyStats
+	{
+		uint64_t BudgetBytes = 0;
+		uint64_t ResidentBytes = 0;
+		uint64_t RequestedBytes = 0;        // What every texture would take at the mip it asked for last
+		uint32_t TextureCount = 0;
+		uint32_t ReducedTextureCount = 0;   // Textures resident coarser than they asked for
+		uint64_t StreamInCount = 0;         // Totals since creation
+		uint64_t EvictionCount = 0;
+	};
+
+	struct TextureResidencyChange
+	{
+		uint32_t TextureIndex;
+		uint32_t FirstMip;
+	};
+
+	// CPU side bookkeeping of which mips of every texture are in VRAM. Textures ask for the finest mip they need every frame,
+	// Update picks the changes that fit the budget and the caller recreates the images with the new first mip.
+	class TextureResidency
+	{
+	public:
+		explicit TextureResidency(uint64_t budgetBytes = 0) : m_BudgetBytes(budgetBytes) {}
+
+		void SetBudget(uint64_t budgetBytes) { m_BudgetBytes = budgetBytes; }
+
+		// levelSizes holds the size of every mip from level 0, returns the first mip to upload the texture with
+		uint32_t AddTexture(uint32_t textureIndex, const std::vector<uint64_t>& levelSizes);
+		bool IsManaged(uint32_t textureIndex) const { return textureIndex < m_Textures.size() && !m_Textures[textureIndex].LevelBytes.empty(); }
+
+		// The finest request of the frame wins
+		void RequestMip(uint32_t textureIndex, uint32_t mip);
+
+		// Evicts least recently requested textures down to their tail while over budget, then grants up to maxStreamIns
+		// finer requests, largest shortfall first. A request that does not fit even after eviction is granted partially.
+		std::vector<TextureResidencyChange> Update(uint32_t maxStreamIns);
+
+		const TextureResidencyStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct Entry
+		{
+			std::vector<uint64_t> LevelBytes;   // Bytes of the chain from each mip down, LevelBytes[0] is the whole chain
+			uint32_t ResidentMip = 0;
+			uint32_t RequestedMip = 0;
+			uint32_t TailMip = 0;
+			uint64_t LastRequestFrame = 0;
+			bool IsRequested = false;
+		};
+
+		uint64_t GetBytes(const Entry& entry, uint32_t mip) const { return entry.LevelBytes[mip]; }
+		// Coarsens the least recently requested texture that can give something back, returns false once nothing is left
+		bool EvictOne(uint32_t protectedIndex, std::vector<TextureResidencyChange>& changes);
+		void SetResidentMip(uint32_t textureIndex, uint32_t mip, std::vector<TextureResidencyChange>& changes);
+
+		// Mips up to 64x64 stay resident, so a texture never falls back to its placeholder
+		static constexpr uint32_t m_TailMipCount = 7;
+
+		std::vector<Entry> m_Textures;
+		uint64_t m_BudgetBytes;
+		uint64_t m_ResidentBytes = 0;
+		uint64_t m_Frame = 0;
+		TextureResidencyStats m_Stats;
+	};
+}
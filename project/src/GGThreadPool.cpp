@@ -0,0 +1,52 @@
+#include "GGThreadPool.h"
+
+#include <algorithm>
+
+using namespace GG;
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	m_Workers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i)
+	{
+		m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_IsStopping = true;
+	}
+	m_Condition.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return m_IsStopping || !m_Tasks.empty(); });
+
+			// Drain the queue before stopping so no future is left without a value
+			if (m_Tasks.empty()) return;
+
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop();
+		}
+		task();
+	}
+}
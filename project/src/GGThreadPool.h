@@ -0,0 +1,57 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace GG
+{
+	// Fixed set of worker threads for CPU side asset work (decoding, cooking). Vulkan calls stay on the main thread.
+	class ThreadPool
+	{
+	public:
+		// 0 uses one thread per hardware thread, minus the main thread
+		explicit ThreadPool(uint32_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		template<typename Func>
+		std::future<std::invoke_result_t<Func>> Enqueue(Func&& func);
+
+		uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Workers;
+		std::queue<std::function<void()>> m_Tasks;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		bool m_IsStopping = false;
+	};
+
+	template<typename Func>
+	std::future<std::invoke_result_t<Func>> ThreadPool::Enqueue(Func&& func)
+	{
+		using ReturnType = std::invoke_result_t<Func>;
+
+		// std::function needs a copyable target, packaged_task is move only
+		auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
+		std::future<ReturnType> result = task->get_future();
+
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Tasks.emplace([task] { (*task)(); });
+		}
+		m_Condition.notify_one();
+
+		return result;
+	}
+}
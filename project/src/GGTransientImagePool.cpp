@@ -0,0 +1,93 @@
+#include "GGTransientImagePool.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "GGImage.h"
+
+using namespace GG;
+
+void TransientImagePool::Declare(Image& image, const TransientImageDesc& desc, VkDevice device)
+{
+	image.CreateUnboundImage(desc.Width, desc.Height, 1, desc.Samples, desc.Format, VK_IMAGE_TILING_OPTIMAL, desc.Usage, device);
+
+	Entry entry{};
+	entry.pImage = &image;
+	entry.Desc = desc;
+	vkGetImageMemoryRequirements(device, image.GetImage(), &entry.Requirements);
+	m_Entries.push_back(entry);
+}
+
+bool TransientImagePool::Overlaps(const TransientImageDesc& a, const TransientImageDesc& b)
+{
+	return a.FirstPass <= b.LastPass && b.FirstPass <= a.LastPass;
+}
+
+void TransientImagePool::Build(MemoryAllocator& allocator)
+{
+	m_pAllocator = &allocator;
+	m_Stats = {};
+	m_Stats.ImageCount = static_cast<uint32_t>(m_Entries.size());
+
+	// Largest first, each image joins the first slot whose images are all dead during its passes
+	std::vector<uint32_t> order(m_Entries.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_Entries[a].Requirements.size > m_Entries[b].Requirements.size; });
+
+	for (const uint32_t index : order)
+	{
+		Entry& entry = m_Entries[index];
+		m_Stats.UnaliasedBytes += entry.Requirements.size;
+
+		const auto fits = [this, &entry](const Slot& slot)
+		{
+			if ((slot.MemoryTypeBits & entry.Requirements.memoryTypeBits) == 0) return false;
+			return std::none_of(slot.Entries.begin(), slot.Entries.end(),
+				[this, &entry](uint32_t other) { return Overlaps(m_Entries[other].Desc, entry.Desc); });
+		};
+
+		auto slot = std::find_if(m_Slots.begin(), m_Slots.end(), fits);
+		if (slot == m_Slots.end())
+		{
+			slot = m_Slots.emplace(m_Slots.end());
+		}
+
+		slot->Size = std::max(slot->Size, entry.Requirements.size);
+		slot->Alignment = std::max(slot->Alignment, entry.Requirements.alignment);
+		slot->MemoryTypeBits &= entry.Requirements.memoryTypeBits;
+		slot->IsTransientOnly &= (entry.Desc.Usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0;
+		slot->Entries.push_back(index);
+		entry.Slot = static_cast<uint32_t>(slot - m_Slots.begin());
+	}
+
+	for (Slot& slot : m_Slots)
+	{
+		VkMemoryRequirements requirements{ slot.Size, slot.Alignment, slot.MemoryTypeBits };
+
+		// Lazily allocated memory is only legal for images that never leave the render pass
+		const bool isLazy = slot.IsTransientOnly && allocator.HasMemoryType(slot.MemoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+		slot.Memory = allocator.AllocateMemory(requirements, isLazy ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			MemoryCategory::GBuffer);
+
+		for (const uint32_t index : slot.Entries)
+		{
+			m_Entries[index].pImage->BindAliasedMemory(allocator.GetDevice(), slot.Memory);
+		}
+
+		++m_Stats.AllocationCount;
+		m_Stats.AllocatedBytes += slot.Size;
+		if (isLazy)
+		{
+			m_Stats.LazilyAllocatedBytes += slot.Size;
+		}
+	}
+}
+
+// The images themselves are destroyed by their owners
+void TransientImagePool::Destroy() const
+{
+	for (const Slot& slot : m_Slots)
+	{
+		m_pAllocator->Free(slot.Memory);
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMemoryAllocator.h"
+
+namespace GG
+{
+	class Image;
+
+	// Passes in recording order, a transient image is alive from the first pass that touches it to the last
+	enum class FramePass : uint32_t
+	{
+		DepthPrePass,
+		GBuffer,
+		Lighting,
+		Blit
+	};
+
+	struct TransientImageDesc
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		VkImageUsageFlags Usage = 0;
+		VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+		FramePass FirstPass = FramePass::DepthPrePass;
+		FramePass LastPass = FramePass::Blit;
+	};
+
+	struct TransientMemoryStats
+	{
+		uint32_t ImageCount = 0;
+		uint32_t AllocationCount = 0;
+		VkDeviceSize UnaliasedBytes = 0;
+		VkDeviceSize AllocatedBytes = 0;
+		VkDeviceSize LazilyAllocatedBytes = 0;
+	};
+
+	// Render targets that only live for part of a frame. Images whose pass ranges don't overlap share one allocation,
+	// transient attachments go to lazily allocated memory where the device has it. Every owner must start each frame
+	// from VK_IMAGE_LAYOUT_UNDEFINED since an aliased image's contents don't survive the other images' passes
+	class TransientImagePool
+	{
+	public:
+		// Creates the VkImage right away, memory is bound in Build
+		void Declare(Image& image, const TransientImageDesc& desc, VkDevice device);
+		void Build(MemoryAllocator& allocator);
+		void Destroy() const;
+
+		const TransientMemoryStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct Entry
+		{
+			Image* pImage;
+			TransientImageDesc Desc;
+			VkMemoryRequirements Requirements;
+			uint32_t Slot;
+		};
+
+		struct Slot
+		{
+			VkDeviceSize Size = 0;
+			VkDeviceSize Alignment = 1;
+			uint32_t MemoryTypeBits = ~0u;
+			bool IsTransientOnly = true;
+			std::vector<uint32_t> Entries;
+			MemoryAllocation Memory;
+		};
+
+		static bool Overlaps(const TransientImageDesc& a, const TransientImageDesc& b);
+
+		std::vector<Entry> m_Entries;
+		std::vector<Slot> m_Slots;
+		MemoryAllocator* m_pAllocator = nullptr;
+		TransientMemoryStats m_Stats;
+	};
+}
@@ -0,0 +1,364 @@
+#include "GGUploadQueue.h"
+
+#include <stdexcept>
+
+using namespace GG;
+
+void UploadQueue::Create(VkDevice device, MemoryAllocator& allocator, VkQueue graphicsQueue, uint32_t graphicsFamily, VkQueue transferQueue,
+	uint32_t transferFamily)
+{
+	m_Device = device;
+	m_StagingPool.Create(device, allocator);
+	m_GraphicsQueue = graphicsQueue;
+	m_GraphicsFamily = graphicsFamily;
+	m_TransferQueue = transferQueue;
+	m_TransferFamily = transferFamily;
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = transferFamily;
+
+	if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_TransferPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload command pool!");
+	}
+
+	m_TransferSemaphore = CreateTimelineSemaphore();
+
+	if (!HasDedicatedTransferQueue()) return;
+
+	poolInfo.queueFamilyIndex = graphicsFamily;
+	if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_AcquirePool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload acquire command pool!");
+	}
+
+	m_AcquireSemaphore = CreateTimelineSemaphore();
+}
+
+void UploadQueue::Destroy()
+{
+	if (m_IsBatchOpen)
+	{
+		vkEndCommandBuffer(m_OpenBatch.TransferCommands);
+		m_SubmittedBatches.push_back(std::move(m_OpenBatch));
+		m_IsBatchOpen = false;
+	}
+
+	// Command buffers go with their pools
+	for (Batch& batch : m_SubmittedBatches)
+	{
+		RecycleStagingBuffers(batch);
+	}
+	m_SubmittedBatches.clear();
+	m_StagingPool.Destroy();
+
+	vkDestroySemaphore(m_Device, m_TransferSemaphore, nullptr);
+	vkDestroyCommandPool(m_Device, m_TransferPool, nullptr);
+
+	if (!HasDedicatedTransferQueue()) return;
+
+	vkDestroySemaphore(m_Device, m_AcquireSemaphore, nullptr);
+	vkDestroyCommandPool(m_Device, m_AcquirePool, nullptr);
+}
+
+StagingBuffer UploadQueue::AcquireStagingBuffer(VkDeviceSize size)
+{
+	if (m_IsBatchOpen && m_OpenBatch.StagingBytes >= m_MaxBatchStagingBytes)
+	{
+		Submit();
+	}
+
+	GetCommandBuffer();
+	const StagingBuffer buffer = m_StagingPool.Acquire(size);
+	m_OpenBatch.StagingBuffers.push_back(buffer);
+	m_OpenBatch.StagingBytes += buffer.Size;
+	return buffer;
+}
+
+VkCommandBuffer UploadQueue::GetCommandBuffer()
+{
+	if (m_IsBatchOpen) return m_OpenBatch.TransferCommands;
+
+	m_OpenBatch = Batch{};
+	m_OpenBatch.Ticket = m_NextTicket;
+
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandPool = m_TransferPool;
+	allocInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(m_Device, &allocInfo, &m_OpenBatch.TransferCommands) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate upload command buffer!");
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(m_OpenBatch.TransferCommands, &beginInfo);
+
+	m_IsBatchOpen = true;
+	return m_OpenBatch.TransferCommands;
+}
+
+void UploadQueue::ReleaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	GetCommandBuffer();
+
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = dstAccess;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = buffer;
+	barrier.offset = offset;
+	barrier.size = size;
+
+	if (!HasDedicatedTransferQueue())
+	{
+		m_OpenBatch.ReleaseBufferBarriers.push_back(barrier);
+		m_OpenBatch.ReleaseStages |= dstStage;
+		return;
+	}
+
+	// The destination range is overwritten, so the transfer family never acquires it from graphics first
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+
+	VkBufferMemoryBarrier release = barrier;
+	release.dstAccessMask = 0;
+	m_OpenBatch.ReleaseBufferBarriers.push_back(release);
+	m_OpenBatch.ReleaseStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+	VkBufferMemoryBarrier acquire = barrier;
+	acquire.srcAccessMask = 0;
+	m_OpenBatch.AcquireBufferBarriers.push_back(acquire);
+	m_OpenBatch.AcquireStages |= dstStage;
+}
+
+void UploadQueue::ReleaseImage(VkImage image, uint32_t mipLevels, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags dstStage,
+	VkAccessFlags dstAccess)
+{
+	GetCommandBuffer();
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = dstAccess;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1 };
+
+	if (!HasDedicatedTransferQueue())
+	{
+		m_OpenBatch.ReleaseImageBarriers.push_back(barrier);
+		m_OpenBatch.ReleaseStages |= dstStage;
+		return;
+	}
+
+	// Release and acquire both carry the same layout transition, it is executed once
+	barrier.srcQueueFamilyIndex = m_TransferFamily;
+	barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+
+	VkImageMemoryBarrier release = barrier;
+	release.dstAccessMask = 0;
+	m_OpenBatch.ReleaseImageBarriers.push_back(release);
+	m_OpenBatch.ReleaseStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+	VkImageMemoryBarrier acquire = barrier;
+	acquire.srcAccessMask = 0;
+	m_OpenBatch.AcquireImageBarriers.push_back(acquire);
+	m_OpenBatch.AcquireStages |= dstStage;
+}
+
+UploadTicket UploadQueue::Submit()
+{
+	if (!m_IsBatchOpen) return m_NextTicket - 1;
+
+	Batch& batch = m_OpenBatch;
+	if (!batch.ReleaseBufferBarriers.empty() || !batch.ReleaseImageBarriers.empty())
+	{
+		vkCmdPipelineBarrier(batch.TransferCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, batch.ReleaseStages, 0,
+			0, nullptr,
+			static_cast<uint32_t>(batch.ReleaseBufferBarriers.size()), batch.ReleaseBufferBarriers.data(),
+			static_cast<uint32_t>(batch.ReleaseImageBarriers.size()), batch.ReleaseImageBarriers.data());
+	}
+	vkEndCommandBuffer(batch.TransferCommands);
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &batch.Ticket;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &batch.TransferCommands;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &m_TransferSemaphore;
+
+	if (vkQueueSubmit(m_TransferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit upload batch!");
+	}
+
+	// On the graphics queue itself the barriers above already order the batch before any later frame
+	if (!HasDedicatedTransferQueue())
+	{
+		m_ReadyTicket = batch.Ticket;
+	}
+
+	const UploadTicket ticket = batch.Ticket;
+	m_SubmittedBatches.push_back(std::move(batch));
+	m_IsBatchOpen = false;
+	++m_NextTicket;
+	return ticket;
+}
+
+void UploadQueue::Update()
+{
+	uint64_t transferValue = 0;
+	vkGetSemaphoreCounterValue(m_Device, m_TransferSemaphore, &transferValue);
+
+	for (Batch& batch : m_SubmittedBatches)
+	{
+		if (batch.Ticket > transferValue) break;
+
+		RecycleStagingBuffers(batch);
+		if (HasDedicatedTransferQueue() && !batch.IsAcquireSubmitted)
+		{
+			SubmitAcquire(batch);
+		}
+	}
+
+	uint64_t completedValue = transferValue;
+	if (HasDedicatedTransferQueue())
+	{
+		vkGetSemaphoreCounterValue(m_Device, m_AcquireSemaphore, &completedValue);
+	}
+
+	while (!m_SubmittedBatches.empty() && m_SubmittedBatches.front().Ticket <= completedValue && m_SubmittedBatches.front().StagingBuffers.empty())
+	{
+		Batch& batch = m_SubmittedBatches.front();
+		vkFreeCommandBuffers(m_Device, m_TransferPool, 1, &batch.TransferCommands);
+		if (batch.AcquireCommands != VK_NULL_HANDLE)
+		{
+			vkFreeCommandBuffers(m_Device, m_AcquirePool, 1, &batch.AcquireCommands);
+		}
+		m_SubmittedBatches.pop_front();
+	}
+}
+
+void UploadQueue::Wait(UploadTicket ticket)
+{
+	if (IsReady(ticket)) return;
+
+	if (ticket >= m_NextTicket)
+	{
+		Submit();
+	}
+
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &m_TransferSemaphore;
+	waitInfo.pValues = &ticket;
+	vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX);
+
+	Update();
+}
+
+void UploadQueue::SubmitAcquire(Batch& batch)
+{
+	if (!batch.AcquireBufferBarriers.empty() || !batch.AcquireImageBarriers.empty())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = m_AcquirePool;
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(m_Device, &allocInfo, &batch.AcquireCommands) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to allocate upload acquire command buffer!");
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(batch.AcquireCommands, &beginInfo);
+
+		// The semaphore wait below covers AcquireStages, the barrier chains from there to every later use in submission order
+		vkCmdPipelineBarrier(batch.AcquireCommands, batch.AcquireStages, batch.AcquireStages, 0,
+			0, nullptr,
+			static_cast<uint32_t>(batch.AcquireBufferBarriers.size()), batch.AcquireBufferBarriers.data(),
+			static_cast<uint32_t>(batch.AcquireImageBarriers.size()), batch.AcquireImageBarriers.data());
+		vkEndCommandBuffer(batch.AcquireCommands);
+	}
+
+	// The transfer already finished, the wait only makes its release happen-before the acquire and never blocks the queue
+	const uint64_t waitValue = batch.Ticket;
+	const VkPipelineStageFlags waitStage = batch.AcquireStages != 0 ? batch.AcquireStages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = 1;
+	timelineInfo.pWaitSemaphoreValues = &waitValue;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &batch.Ticket;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &m_TransferSemaphore;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = batch.AcquireCommands != VK_NULL_HANDLE ? 1 : 0;
+	submitInfo.pCommandBuffers = &batch.AcquireCommands;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &m_AcquireSemaphore;
+
+	if (vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to submit upload acquire!");
+	}
+
+	batch.IsAcquireSubmitted = true;
+	m_ReadyTicket = batch.Ticket;
+}
+
+void UploadQueue::RecycleStagingBuffers(Batch& batch)
+{
+	for (const StagingBuffer& staging : batch.StagingBuffers)
+	{
+		m_StagingPool.Recycle(staging);
+	}
+	batch.StagingBuffers.clear();
+}
+
+VkSemaphore UploadQueue::CreateTimelineSemaphore() const
+{
+	VkSemaphoreTypeCreateInfo typeInfo{};
+	typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	typeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &typeInfo;
+
+	VkSemaphore semaphore;
+	if (vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upload timeline semaphore!");
+	}
+	return semaphore;
+}
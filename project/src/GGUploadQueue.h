@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "GGMemoryAllocator.h"
+#include "GGStagingPool.h"
+
+namespace GG
+{
+	// Timeline value of an upload batch, 0 stands for nothing to wait on
+	using UploadTicket = uint64_t;
+
+	// Records uploads into batches that run on a dedicated transfer queue family when the device has one, otherwise on the
+	// graphics queue. A written buffer range or image is released to the graphics family in the batch, the matching acquire
+	// is submitted on the graphics queue only once the transfer finished, so rendering never waits on an upload.
+	// A batch's resources may be used by graphics work submitted after IsReady returns true for its ticket.
+	// Not thread safe, the graphics queue is shared with the frame submits of the main thread
+	class UploadQueue
+	{
+	public:
+		UploadQueue() = default;
+		UploadQueue(const UploadQueue&) = delete;
+		UploadQueue& operator=(const UploadQueue&) = delete;
+
+		void Create(VkDevice device, MemoryAllocator& allocator, VkQueue graphicsQueue, uint32_t graphicsFamily, VkQueue transferQueue, uint32_t transferFamily);
+		// Only once the device is idle
+		void Destroy();
+
+		// Staging memory for one upload, recycled once the GPU finished the open batch. Submits the open batch first when its
+		// staging memory is over m_MaxBatchStagingBytes, so it has to be acquired before the upload's commands are recorded
+		StagingBuffer AcquireStagingBuffer(VkDeviceSize size);
+		VkCommandBuffer GetCommandBuffer();
+		// Makes a range written by this batch's transfers visible to the given graphics stages
+		void ReleaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+		// Same for an image, moving all its mips from oldLayout to newLayout on the way
+		void ReleaseImage(VkImage image, uint32_t mipLevels, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags dstStage,
+			VkAccessFlags dstAccess);
+
+		// Ticket of the open batch, covers everything recorded so far
+		UploadTicket GetOpenTicket() const { return m_NextTicket; }
+		// Submits the open batch, with nothing recorded it returns the ticket of the last submit
+		UploadTicket Submit();
+		// Acquires finished transfers on the graphics queue and frees what their batches no longer need, called once a frame
+		void Update();
+		// Blocks until the batch is ready, submitting it if it is still open
+		void Wait(UploadTicket ticket);
+
+		bool IsReady(UploadTicket ticket) const { return ticket <= m_ReadyTicket; }
+		UploadTicket GetReadyTicket() const { return m_ReadyTicket; }
+		bool HasDedicatedTransferQueue() const { return m_TransferFamily != m_GraphicsFamily; }
+		StagingPool& GetStagingPool() { return m_StagingPool; }
+
+	private:
+		struct Batch
+		{
+			UploadTicket Ticket = 0;
+			VkCommandBuffer TransferCommands = VK_NULL_HANDLE;
+			VkCommandBuffer AcquireCommands = VK_NULL_HANDLE;
+			bool IsAcquireSubmitted = false;
+			std::vector<StagingBuffer> StagingBuffers;
+			VkDeviceSize StagingBytes = 0;
+
+			// Recorded together at the end of the batch. Without a dedicated transfer queue the release barriers are
+			// plain barriers to the graphics stages and there is nothing to acquire
+			std::vector<VkBufferMemoryBarrier> ReleaseBufferBarriers;
+			std::vector<VkImageMemoryBarrier> ReleaseImageBarriers;
+			VkPipelineStageFlags ReleaseStages = 0;
+			std::vector<VkBufferMemoryBarrier> AcquireBufferBarriers;
+			std::vector<VkImageMemoryBarrier> AcquireImageBarriers;
+			VkPipelineStageFlags AcquireStages = 0;
+		};
+
+		void SubmitAcquire(Batch& batch);
+		void RecycleStagingBuffers(Batch& batch);
+		VkSemaphore CreateTimelineSemaphore() const;
+
+		// Bounds the staging memory one batch holds on to during a long run of uploads, e.g. loading every texture up front
+		static constexpr VkDeviceSize m_MaxBatchStagingBytes = 64ull * 1024 * 1024;
+
+		VkDevice m_Device = VK_NULL_HANDLE;
+		StagingPool m_StagingPool;
+		VkQueue m_GraphicsQueue = VK_NULL_HANDLE;
+		VkQueue m_TransferQueue = VK_NULL_HANDLE;
+		uint32_t m_GraphicsFamily = 0;
+		uint32_t m_TransferFamily = 0;
+
+		VkCommandPool m_TransferPool = VK_NULL_HANDLE;
+		VkCommandPool m_AcquirePool = VK_NULL_HANDLE;    // Graphics family, only with a dedicated transfer queue
+		VkSemaphore m_TransferSemaphore = VK_NULL_HANDLE; // Reaches a batch's ticket once its transfers finished
+		VkSemaphore m_AcquireSemaphore = VK_NULL_HANDLE;  // Reaches it once the graphics queue acquired its resources
+
+		Batch m_OpenBatch;
+		bool m_IsBatchOpen = false;
+		std::deque<Batch> m_SubmittedBatches;
+		UploadTicket m_NextTicket = 1;
+		UploadTicket m_ReadyTicket = 0;
+	};
+}
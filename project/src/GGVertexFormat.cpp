@@ -0,0 +1,102 @@
+#include "GGVertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "GGHalfFloat.h"
+#include "Model.h"
+
+using namespace GG;
+
+namespace
+{
+	// Octahedral mapping of a unit vector onto [-1, 1]^2, a zero vector maps to +Z
+	glm::vec2 OctEncode(const glm::vec3& vector)
+	{
+		const float l1Norm = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+		if (l1Norm <= 0.f) return { 0.f, 0.f };
+
+		glm::vec2 encoded{ vector.x / l1Norm, vector.y / l1Norm };
+		if (vector.z < 0.f)
+		{
+			const float x = (1.f - std::abs(encoded.y)) * (encoded.x >= 0.f ? 1.f : -1.f);
+			const float y = (1.f - std::abs(encoded.x)) * (encoded.y >= 0.f ? 1.f : -1.f);
+			encoded = { x, y };
+		}
+		return encoded;
+	}
+
+	int16_t QuantizeSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * 32767.f));
+	}
+
+	uint32_t QuantizeUnorm15(float value)
+	{
+		return static_cast<uint32_t>(std::lround((std::clamp(value, -1.f, 1.f) * 0.5f + 0.5f) * 32767.f));
+	}
+
+	CompactVertex EncodeCompact(const Vertex& vertex)
+	{
+		CompactVertex compact{};
+		compact.pos = vertex.pos;
+		compact.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+		compact.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+
+		const glm::vec2 normal = OctEncode(vertex.normal);
+		compact.normal[0] = QuantizeSnorm16(normal.x);
+		compact.normal[1] = QuantizeSnorm16(normal.y);
+
+		// Handedness is the only thing the bitangent adds once normal and tangent are known
+		const bool isMirrored = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.f;
+		const glm::vec2 tangent = OctEncode(vertex.tangent);
+		compact.tangent = QuantizeUnorm15(tangent.x) | (QuantizeUnorm15(tangent.y) << 15) | (isMirrored ? 0x80000000u : 0u);
+
+		return compact;
+	}
+}
+
+uint32_t GG::GetVertexStride(VertexFormat format)
+{
+	return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+}
+
+const char* GG::GetVertexFormatName(VertexFormat format)
+{
+	return format == VertexFormat::Compact ? "Compact" : "Full";
+}
+
+VkVertexInputBindingDescription GG::GetVertexBindingDescription(VertexFormat format)
+{
+	return format == VertexFormat::Compact ? CompactVertex::getBindingDescription() : Vertex::getBindingDescription();
+}
+
+std::vector<VkVertexInputAttributeDescription> GG::GetVertexAttributeDescriptions(VertexFormat format)
+{
+	if (format == VertexFormat::Compact)
+	{
+		const auto descriptions = CompactVertex::getAttributeDescriptions();
+		return { descriptions.begin(), descriptions.end() };
+	}
+
+	const auto descriptions = Vertex::getAttributeDescriptions();
+	return { descriptions.begin(), descriptions.end() };
+}
+
+void GG::EncodeVertices(VertexFormat format, std::span<const Vertex> vertices, void* dst)
+{
+	if (format == VertexFormat::Full)
+	{
+		memcpy(dst, vertices.data(), vertices.size_bytes());
+		return;
+	}
+
+	auto* compactVertices = static_cast<uint8_t*>(dst);
+	for (const Vertex& vertex : vertices)
+	{
+		const CompactVertex compact = EncodeCompact(vertex);
+		memcpy(compactVertices, &compact, sizeof(compact));
+		compactVertices += sizeof(compact);
+	}
+}
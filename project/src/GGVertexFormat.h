@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Vertex;
+
+namespace GG
+{
+	// GPU side vertex layout for the whole scene. Meshes are always imported and cached as Vertex,
+	// Compact is encoded while filling the upload staging memory.
+	enum class VertexFormat
+	{
+		Full,		// Vertex, 68 bytes
+		Compact		// CompactVertex, 24 bytes
+	};
+
+	uint32_t GetVertexStride(VertexFormat format);
+	const char* GetVertexFormatName(VertexFormat format);
+
+	VkVertexInputBindingDescription GetVertexBindingDescription(VertexFormat format);
+	std::vector<VkVertexInputAttributeDescription> GetVertexAttributeDescriptions(VertexFormat format);
+
+	// dst must hold vertices.size() * GetVertexStride(format) bytes
+	void EncodeVertices(VertexFormat format, std::span<const Vertex> vertices, void* dst);
+}
@@ -1,5 +1,6 @@
 #include "GGVkDevice.h"
 
+#include <algorithm>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -15,6 +16,8 @@ void Device::InitializeDevice(VkInstance& instance, VkSurfaceKHR& surface, bool
 {
 	PickPhysicalDevice(instance, surface);
 	CreateLogicalDevice(surface, isValidationLayerEnabled,errorHandler);
+	m_MemoryAllocator.Initialize(m_Device, m_PhysicalDevice, m_IsMemoryBudgetEnabled);
+	m_UploadQueue.Create(m_Device, m_MemoryAllocator, m_GraphicsQueue, m_GraphicsQueueFamily, m_TransferQueue, m_TransferQueueFamily);
 }
 
 //---------------Logical Device Setup------------------------
@@ -23,7 +26,9 @@ void Device::CreateLogicalDevice(VkSurfaceKHR& surface,bool isValidationLayerEna
 	QueueFamilyIndices indices = GG::VkHelperFunctions::FindQueueFamilies(m_PhysicalDevice, surface);
 
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+	m_GraphicsQueueFamily = indices.graphicsFamily.value();
+	m_TransferQueueFamily = indices.transferFamily.value_or(m_GraphicsQueueFamily);
+	std::set<uint32_t> uniqueQueueFamilies = { m_GraphicsQueueFamily, indices.presentFamily.value(), m_TransferQueueFamily };
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -45,10 +50,16 @@ void Device::CreateLogicalDevice(VkSurfaceKHR& surface,bool isValidationLayerEna
 	features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
 	features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
 	features12.runtimeDescriptorArray = VK_TRUE;
+	features12.timelineSemaphore = VK_TRUE;
+
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+	m_IsTextureCompressionBCEnabled = supportedFeatures.textureCompressionBC == VK_TRUE;
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 	deviceFeatures.sampleRateShading = VK_TRUE;
+	deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
 
 	VkPhysicalDeviceFeatures2 deviceFeatures2{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,.pNext = &features12, .features = deviceFeatures};
 
@@ -60,8 +71,16 @@ void Device::CreateLogicalDevice(VkSurfaceKHR& surface,bool isValidationLayerEna
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+	// Optional, without it the allocator can only see its own allocations and guesses the budget from the heap sizes
+	std::vector<const char*> extensions = m_DeviceExtensions;
+	m_IsMemoryBudgetEnabled = IsDeviceExtensionAvailable(m_PhysicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (m_IsMemoryBudgetEnabled)
+	{
+		extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
 
 	if (isValidationLayerEnabled)
 	{
@@ -82,6 +101,7 @@ void Device::CreateLogicalDevice(VkSurfaceKHR& surface,bool isValidationLayerEna
 
 	vkGetDeviceQueue(m_Device, indices.graphicsFamily.value(), 0, &m_GraphicsQueue);
 	vkGetDeviceQueue(m_Device, indices.presentFamily.value(), 0, &m_PresentQueue);
+	vkGetDeviceQueue(m_Device, m_TransferQueueFamily, 0, &m_TransferQueue);
 
 }
 //---------------no more Logical Device Setup------------------------
@@ -155,6 +175,18 @@ bool Device::CheckDeviceExtensionSupport(const VkPhysicalDevice device) const
 	return requiredExtensions.empty();
 }
 
+bool Device::IsDeviceExtensionAvailable(const VkPhysicalDevice device, const char* extensionName)
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	return std::any_of(availableExtensions.begin(), availableExtensions.end(),
+		[extensionName](const VkExtensionProperties& extension) { return std::string(extension.extensionName) == extensionName; });
+}
+
 //--------------No Longer Physical Device stuff------------------
 
 void Device::DeviceWaitIdle() const
@@ -162,10 +194,14 @@ void Device::DeviceWaitIdle() const
 	vkDeviceWaitIdle(m_Device);
 }
 
-void Device::DestroyDevice() const
+void Device::DestroyDevice()
 {
 	vkDestroySampler(m_Device, m_TextureSampler, nullptr);
 
+	m_UploadQueue.Destroy();
+	m_DeletionQueue.Flush();
+	m_MemoryAllocator.Destroy();
+
 	vkDestroyDevice(m_Device, nullptr);
 }
 
@@ -2,6 +2,10 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+#include "GGDeletionQueue.h"
+#include "GGMemoryAllocator.h"
+#include "GGUploadQueue.h"
+
 namespace GG
 {
 	class VkErrorHandler;
@@ -18,10 +22,11 @@ namespace GG
 		void PickPhysicalDevice(const VkInstance& instance, VkSurfaceKHR& surface);
 		bool IsDeviceSuitable(VkPhysicalDevice& physicalDevice, VkSurfaceKHR& surface) const;
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device) const;
+		static bool IsDeviceExtensionAvailable(VkPhysicalDevice device, const char* extensionName);
 
 		void DeviceWaitIdle() const;
 
-		void DestroyDevice() const;
+		void DestroyDevice();
 
 		//multisampling
 		void GetMaxUsableSampleCount();
@@ -35,6 +40,15 @@ namespace GG
 
 		VkQueue& GetGraphicsQueue() { return m_GraphicsQueue; }
 		VkQueue& GetPresentQueue() { return m_PresentQueue; }
+		uint32_t GetGraphicsQueueFamily() const { return m_GraphicsQueueFamily; }
+		uint32_t GetTransferQueueFamily() const { return m_TransferQueueFamily; }
+
+		MemoryAllocator& GetMemoryAllocator() { return m_MemoryAllocator; }
+		DeletionQueue& GetDeletionQueue() { return m_DeletionQueue; }
+		UploadQueue& GetUploadQueue() { return m_UploadQueue; }
+
+		bool IsTextureCompressionBCEnabled() const { return m_IsTextureCompressionBCEnabled; }
+		bool IsMemoryBudgetEnabled() const { return m_IsMemoryBudgetEnabled; }
 
 	private:
 		VkDevice m_Device;
@@ -49,6 +63,16 @@ namespace GG
 
 		VkQueue m_GraphicsQueue;
 		VkQueue m_PresentQueue;
+		VkQueue m_TransferQueue;          // The graphics queue when the device has no separate transfer family
+		uint32_t m_GraphicsQueueFamily = 0;
+		uint32_t m_TransferQueueFamily = 0;
+
+		MemoryAllocator m_MemoryAllocator;
+		DeletionQueue m_DeletionQueue;
+		UploadQueue m_UploadQueue;
+
+		bool m_IsTextureCompressionBCEnabled = false;
+		bool m_IsMemoryBudgetEnabled = false;
 
 	};
 
@@ -45,6 +45,19 @@ QueueFamilyIndices VkHelperFunctions::FindQueueFamilies(VkPhysicalDevice device,
 		i++;
 	}
 
+	// A transfer only family is usually a copy engine, a compute family without graphics is the next best thing
+	for (const VkQueueFlags excluded : { VkQueueFlags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT), VkQueueFlags(VK_QUEUE_GRAPHICS_BIT) })
+	{
+		for (uint32_t family = 0; family < queueFamilyCount; ++family)
+		{
+			if ((queueFamilies[family].queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamilies[family].queueFlags & excluded))
+			{
+				indices.transferFamily = family;
+				return indices;
+			}
+		}
+	}
+
 	return indices;
 }
 
@@ -8,6 +8,8 @@ struct QueueFamilyIndices
 {
 	std::optional<uint32_t> graphicsFamily;
 	std::optional<uint32_t> presentFamily;
+	// Preferably a family without graphics so uploads run next to rendering, absent means uploads go through graphicsFamily
+	std::optional<uint32_t> transferFamily;
 
 	bool isComplete() {
 		return graphicsFamily.has_value() && presentFamily.has_value();
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <array>
 #include "GGSwapChain.h"
 
 #include "GGBuffer.h"
@@ -15,9 +16,15 @@
 #include "Time.h"
 #include "GGShader.h"
 
+namespace
+{
+	constexpr float BytesPerMB = 1024.f * 1024.f;
+}
+
 
 	void GGVulkan::Run()
 	{
+		m_RunStart = std::chrono::high_resolution_clock::now();
 		InitWindow();
 		InitVulkan();
 		MainLoop();
@@ -63,16 +70,27 @@
 		CreateSurface();
 
 		m_Device->InitializeDevice(m_Instance, m_Surface, m_EnableValidationLayers, m_ErrorHandler);
+		// Two frames in flight, plus the frame whose descriptor set is only rewritten after its fence
+		m_Device->GetDeletionQueue().Initialize(device, m_Device->GetMemoryAllocator(), m_MaxFramesInFlight + 1);
 
-		m_VkSwapChain = new GG::SwapChain{device,physicalDevice};
+		m_VkSwapChain = new GG::SwapChain{device,physicalDevice,m_Device->GetMemoryAllocator()};
 
 		m_VkSwapChain->CreateSwapChain(m_Surface,m_Window);
 		m_VkSwapChain->CreateImageViews();
 
-		m_GBuffer.CreateImages(m_VkSwapChain->GetSwapChainExtent(), m_Device);
-		m_BlitPass.CreateImage(m_VkSwapChain->GetSwapChainExtent(), m_Device);
+		m_GBuffer.CreateImages(m_VkSwapChain->GetSwapChainExtent(), m_Device, m_TransientImages);
+		m_BlitPass.CreateImage(m_VkSwapChain->GetSwapChainExtent(), m_Device, m_TransientImages);
+		m_TransientImages.Build(m_Device->GetMemoryAllocator());
+		m_GBuffer.CreateImageViews(m_Device);
+		m_BlitPass.CreateImageView(m_Device);
 
-		m_pBuffer = new GG::Buffer(device, physicalDevice,m_MaxFramesInFlight);
+		const GG::TransientMemoryStats& transientStats = m_TransientImages.GetStats();
+		std::cout << "[TransientMemory] " << transientStats.ImageCount << " render targets at " << m_VkSwapChain->GetSwapChainExtent().width << "x"
+			<< m_VkSwapChain->GetSwapChainExtent().height << ": " << transientStats.AllocatedBytes / BytesPerMB << " MB in "
+			<< transientStats.AllocationCount << " allocations, " << (transientStats.UnaliasedBytes - transientStats.AllocatedBytes) / BytesPerMB
+			<< " MB saved by aliasing, " << transientStats.LazilyAllocatedBytes / BytesPerMB << " MB lazily allocated\n";
+
+		m_pBuffer = new GG::Buffer(device, physicalDevice, m_Device->GetMemoryAllocator(), m_MaxFramesInFlight);
 
 		if (m_CurrentScene->GetTextureCount() <= 0)
 		{
@@ -85,7 +103,7 @@
 		m_BlitPass.CreateDescriptorSetLayout(m_Device, m_pDescriptorManager);
 
 		CreateDepthPrePassPipeline();
-		m_GBuffer.CreatePipeline(m_Device,m_pDescriptorManager);
+		m_GBuffer.CreatePipeline(m_Device,m_pDescriptorManager,m_CurrentScene->GetVertexFormat());
 		CreateLightingPipeline();
 		CreateLightingPipeline();
 		m_BlitPass.CreateBlitPipeline(m_Device, m_pDescriptorManager,m_VkSwapChain->GetSwapChainImgFormat());
@@ -94,13 +112,22 @@
 		m_VkSwapChain->CreateColorResources(mssaSamples);
 		m_VkSwapChain->CreateDepthResources(mssaSamples);
 
-		m_CurrentScene->CreateImages(m_pBuffer, m_pCommandManager, m_Device->GetGraphicsQueue(), device, physicalDevice);
+		if (!m_Device->IsTextureCompressionBCEnabled())
+		{
+			std::cerr << "WARNING: device does not support BC texture compression, textures are uploaded uncompressed\n";
+			m_CurrentScene->SetTextureCompression(false);
+		}
+		m_CurrentScene->CreateImages(m_pBuffer, m_Device->GetUploadQueue(), device, physicalDevice);
 
 		m_Device->CreateTextureSampler();
 
-		m_CurrentScene->CreateMeshBuffers(m_Device,m_pBuffer,m_pCommandManager);
+		m_CurrentScene->CreateMeshBuffers(m_Device,m_pBuffer);
+		if (m_IsStagingBenchmark)
+		{
+			RunStagingBenchmark();
+		}
 
-		m_pBuffer->CreateUniformBuffers(m_CurrentScene);
+		m_pBuffer->CreateUniformBuffers(m_Device->GetDeletionQueue());
 
 		CreateDescriptorPool4PrePass();
 		m_GBuffer.CreateDescriptorPool(m_Device,m_pDescriptorManager,m_MaxFramesInFlight);
@@ -111,9 +138,19 @@
 		m_GBuffer.CreateDescriptorSets(m_CurrentScene,m_Device,m_pDescriptorManager,m_pBuffer,m_MaxFramesInFlight);
 		CreateDescriptorSetsLighting();
 		m_BlitPass.CreateDescriptorSets(m_Device, m_pDescriptorManager, m_MaxFramesInFlight);
+		m_FrameBufferVersions.resize(m_MaxFramesInFlight);
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_MaxFramesInFlight); ++i)
+		{
+			m_FrameBufferVersions[i] = m_pBuffer->GetFrameBufferVersion(i);
+		}
 
 		m_pCommandManager->CreateCommandBuffers(device,m_MaxFramesInFlight);
 		CreateSyncObjects();
+
+		m_Device->GetMemoryAllocator().SetBudgetCallback(m_MemoryBudgetThreshold,
+			[this](uint32_t heapIndex, const GG::MemoryHeapBudget& heap, bool isOverThreshold) { OnMemoryBudgetCrossed(heapIndex, heap, isOverThreshold); });
+
+		ReportDeviceMemory();
 	}
 
 	void GGVulkan::CreateSurface()
@@ -129,19 +166,178 @@
 		while (!glfwWindowShouldClose(m_Window))
 		{
 			Time::Update();
+			if (m_CurrentScene->IsIncrementalLoadPending())
+			{
+				m_CurrentScene->UpdateIncrementalLoad(m_Device, m_IncrementalLoadSliceMs);
+			}
+			m_CurrentScene->SetViewportHeight(m_VkSwapChain->GetSwapChainExtent().height);
 			m_CurrentScene->Update();
 			glfwPollEvents();
 
 			//if (glfwGetKey(m_Window, GLFW_KEY_F2) == GLFW_PRESS) m_CurrentScene = m_Scenes [1]; TODO: Create a proper scene switching system
 			DrawFrame();
+
+			if (m_IsReportingStats)
+			{
+				UpdateFrameStats();
+			}
 		}
 		m_Device->DeviceWaitIdle();
 	}
 
+	void GGVulkan::UpdateFrameStats()
+	{
+		// The frame after a report also timed the console write, so it stays out of the average
+		if (m_IsFrameTimeSampleSkipped)
+		{
+			m_IsFrameTimeSampleSkipped = false;
+			return;
+		}
+
+		m_FrameTimeAccumulator += Time::GetDeltaTime();
+		++m_FrameTimeSamples;
+		if (m_FrameTimeAccumulator >= m_FrameTimeReportInterval)
+		{
+			std::cout << "[FrameTime] " << m_FrameTimeAccumulator * 1000.f / m_FrameTimeSamples << " ms average over " << m_FrameTimeSamples
+				<< " frames (" << GG::GetVertexFormatName(m_CurrentScene->GetVertexFormat()) << " vertices)\n";
+
+			const Scene::VisibilityStats& visibilityStats = m_CurrentScene->GetVisibilityStats();
+			std::cout << "[Visibility] " << visibilityStats.VisibleMeshlets << "/" << visibilityStats.TotalMeshlets << " meshlets, "
+				<< visibilityStats.VisibleTriangles << "/" << visibilityStats.TotalTriangles << " triangles in "
+				<< visibilityStats.DrawCount << " draws, " << visibilityStats.ReducedLodMeshes << " meshes below LOD 0\n";
+
+			if (m_CurrentScene->IsTextureResidencyEnabled())
+			{
+				const GG::TextureResidencyStats& residencyStats = m_CurrentScene->GetTextureResidencyStats();
+				std::cout << "[TextureResidency] " << residencyStats.ResidentBytes / BytesPerMB << "/" << residencyStats.BudgetBytes / BytesPerMB
+					<< " MB resident, " << residencyStats.RequestedBytes / BytesPerMB << " MB requested, " << residencyStats.ReducedTextureCount << "/"
+					<< residencyStats.TextureCount << " textures below their requested mip, " << residencyStats.StreamInCount << " stream ins, "
+					<< residencyStats.EvictionCount << " evictions\n";
+			}
+			ReportDeviceMemory();
+			m_FrameTimeAccumulator = 0.f;
+			m_FrameTimeSamples = 0;
+			m_IsFrameTimeSampleSkipped = true;
+		}
+	}
+
+	void GGVulkan::ReportDeviceMemory() const
+	{
+		const GG::MemoryAllocatorStats stats = m_Device->GetMemoryAllocator().GetStats();
+		std::cout << "[DeviceMemory] " << stats.AllocationCount << " allocations in " << stats.BlockCount << " blocks + " << stats.DedicatedCount
+			<< " dedicated (" << stats.DeviceMemoryCount << "/" << stats.MaxDeviceMemoryCount << " VkDeviceMemory), "
+			<< stats.UsedBytes / BytesPerMB << "/" << stats.BlockBytes / BytesPerMB << " MB of blocks used, " << stats.DedicatedBytes / BytesPerMB
+			<< " MB dedicated, " << stats.WastedBytes / 1024.f << " KB wasted, " << stats.FreeRangeCount << " free ranges, "
+			<< stats.GetFragmentation() * 100.f << "% fragmented\n";
+
+		const GG::MemoryBudget budget = m_Device->GetMemoryAllocator().GetBudget();
+		std::cout << "[MemoryBudget]" << (budget.IsReportedByDriver ? "" : " estimated without VK_EXT_memory_budget,");
+		for (uint32_t i = 0; i < budget.HeapCount; ++i)
+		{
+			const GG::MemoryHeapBudget& heap = budget.Heaps[i];
+			std::cout << " heap " << i << (heap.IsDeviceLocal ? " (device local) " : " (host) ") << heap.Usage / BytesPerMB << "/"
+				<< heap.Budget / BytesPerMB << " MB, " << heap.AllocatorBytes / BytesPerMB << " MB ours" << (i + 1 < budget.HeapCount ? ";" : "\n");
+		}
+
+		std::cout << "[MemoryBudget]";
+		for (uint32_t i = 0; i < static_cast<uint32_t>(GG::MemoryCategory::Count); ++i)
+		{
+			std::cout << " " << GG::GetMemoryCategoryName(static_cast<GG::MemoryCategory>(i)) << " " << budget.CategoryBytes[i] / BytesPerMB << " MB"
+				<< (i + 1 < static_cast<uint32_t>(GG::MemoryCategory::Count) ? "," : "\n");
+		}
+
+		const GG::StagingPoolStats& stagingStats = m_Device->GetUploadQueue().GetStagingPool().GetStats();
+		std::cout << "[StagingPool] " << stagingStats.Hits << " hits, " << stagingStats.Misses << " misses (" << stagingStats.GetHitRate() * 100.f << "% hit rate), "
+			<< stagingStats.InUseBytes / BytesPerMB << " MB in use, " << stagingStats.PeakInUseBytes / BytesPerMB << " MB peak, "
+			<< stagingStats.PooledBytes / BytesPerMB << " MB pooled in " << stagingStats.BufferCount << " buffers\n";
+	}
+
+	void GGVulkan::RunStagingBenchmark()
+	{
+		GG::UploadQueue& uploadQueue = m_Device->GetUploadQueue();
+		GG::StagingPool& stagingPool = uploadQueue.GetStagingPool();
+
+		// Contents don't matter, only the upload sizes do
+		Mesh templateMesh;
+		templateMesh.GetVertices().resize(m_StagingBenchmarkVertexCount);
+		templateMesh.GetIndices().resize(m_StagingBenchmarkIndexCount);
+		for (uint32_t i = 0; i < m_StagingBenchmarkIndexCount; ++i)
+		{
+			templateMesh.GetIndices()[i] = i % m_StagingBenchmarkVertexCount;
+		}
+
+		GG::GeometryPool geometryPool;
+		geometryPool.Create(m_pBuffer, m_CurrentScene->GetVertexFormat(), m_StagingBenchmarkMeshCount * m_StagingBenchmarkVertexCount,
+			m_StagingBenchmarkMeshCount * m_StagingBenchmarkIndexCount);
+
+		for (const bool isPooled : { false, true })
+		{
+			stagingPool.SetPooling(isPooled);
+			stagingPool.ResetStats();
+			std::vector<Mesh> meshes(m_StagingBenchmarkMeshCount, templateMesh);
+
+			// Submitted and updated like DrawFrame does, so buffers are only recycled once a batch really finished
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < m_StagingBenchmarkMeshCount; ++i)
+			{
+				meshes[i].CreateBuffers(m_Device, geometryPool);
+				if ((i + 1) % m_StagingBenchmarkMeshesPerFrame == 0)
+				{
+					uploadQueue.Submit();
+					uploadQueue.Update();
+				}
+			}
+			uploadQueue.Wait(uploadQueue.Submit());
+			const float uploadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+			const GG::StagingPoolStats& stats = stagingPool.GetStats();
+			std::cout << "[StagingBenchmark] " << m_StagingBenchmarkMeshCount << " meshes, " << m_StagingBenchmarkMeshesPerFrame << " per submit, "
+				<< (isPooled ? "staging pool: " : "buffer per upload: ") << uploadMs << " ms, " << stats.Hits << " hits, " << stats.Misses << " misses, "
+				<< stats.PeakInUseBytes / 1024.f << " KB peak staging\n";
+
+			for (Mesh& mesh : meshes)
+			{
+				mesh.ReleaseGeometry(geometryPool);
+			}
+		}
+
+		m_Device->DeviceWaitIdle();
+		geometryPool.Destroy();
+	}
+
+	void GGVulkan::OnMemoryBudgetCrossed(uint32_t heapIndex, const GG::MemoryHeapBudget& heap, bool isOverThreshold)
+	{
+		if (!isOverThreshold)
+		{
+			std::cout << "[MemoryBudget] heap " << heapIndex << " back below " << m_MemoryBudgetThreshold * 100.f << "% of its budget, "
+				<< heap.Usage / BytesPerMB << "/" << heap.Budget / BytesPerMB << " MB\n";
+			return;
+		}
+
+		std::cerr << "WARNING: memory heap " << heapIndex << " is over " << m_MemoryBudgetThreshold * 100.f << "% of its budget, "
+			<< heap.Usage / BytesPerMB << "/" << heap.Budget / BytesPerMB << " MB\n";
+
+		// Textures are the only thing that can shrink at runtime, take what the heap is over the threshold out of their budget
+		// and let the next residency update evict down to it
+		if (!heap.IsDeviceLocal || !m_CurrentScene->IsTextureResidencyEnabled()) return;
+
+		const GG::TextureResidencyStats& residencyStats = m_CurrentScene->GetTextureResidencyStats();
+		const uint64_t thresholdBytes = static_cast<uint64_t>(static_cast<float>(heap.Budget) * m_MemoryBudgetThreshold);
+		const uint64_t excess = heap.Usage > thresholdBytes ? heap.Usage - thresholdBytes : 0;
+		const uint64_t textureBudget = std::max(residencyStats.ResidentBytes > excess ? residencyStats.ResidentBytes - excess : 0, m_MinTextureMemoryBudget);
+		if (textureBudget >= residencyStats.BudgetBytes) return;
+
+		m_CurrentScene->SetTextureMemoryBudget(textureBudget);
+		std::cout << "[MemoryBudget] texture budget lowered to " << textureBudget / BytesPerMB << " MB\n";
+	}
+
 	void GGVulkan::DrawFrame()
 	{
 		vkWaitForFences(m_Device->GetVulkanDevice(), 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
 
+		m_Device->GetDeletionQueue().BeginFrame();
+		m_Device->GetMemoryAllocator().UpdateBudget();
+
 		uint32_t imageIndex;
 		VkResult result = vkAcquireNextImageKHR(m_Device->GetVulkanDevice(), m_VkSwapChain->GetSwapChain(), 
 			UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
@@ -170,7 +366,17 @@
 			throw std::runtime_error("failed to acquire swap chain image!");
 		}
 
+		// Acquires finished uploads on the graphics queue ahead of this frame's submit, then submits what this frame recorded
+		GG::UploadQueue& uploadQueue = m_Device->GetUploadQueue();
+		uploadQueue.Update();
+		m_CurrentScene->UpdateTextureStreaming(m_pBuffer, uploadQueue, m_Device->GetVulkanDevice(), m_Device->GetVulkanPhysicalDevice(),
+			m_Device->GetDeletionQueue());
+		uploadQueue.Submit();
+		// The fence above means the GPU is done with this frame's descriptor set, so it can be rewritten in place
+		m_GBuffer.UpdateTextureDescriptors(m_CurrentScene, m_Device, m_pDescriptorManager, m_CurrentFrame);
+
 		m_pBuffer->UpdateUniformBuffer(m_CurrentFrame,m_VkSwapChain->GetSwapChainExtent(), m_CurrentScene);
+		UpdateFrameBufferDescriptors(m_CurrentFrame);
 
 		vkResetFences(m_Device->GetVulkanDevice(), 1, &m_InFlightFences[m_CurrentFrame]);
 
@@ -180,7 +386,7 @@
 			m_pLightingPipeline,m_BlitPass.GetPipeline()};
 
 		m_pCommandManager->RecordCommandBuffer(imageIndex,m_VkSwapChain, m_CurrentFrame, m_GBuffer , m_BlitPass,
-			pipelinesForCommandBuffer,m_CurrentScene,m_pDescriptorManager);
+			pipelinesForCommandBuffer,m_CurrentScene,m_pDescriptorManager, m_pBuffer->GetLightingFrameData(m_CurrentFrame));
 
 
 		VkSubmitInfo submitInfo{};
@@ -225,6 +431,13 @@
 			throw std::runtime_error("failed to present swap chain image!");
 		}
 
+		if (!m_IsFirstFrameReported)
+		{
+			std::cout << "[Startup] first frame presented after " << std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - m_RunStart).count()
+				<< " ms, " << m_CurrentScene->GetResidentTextureCount() << "/" << m_CurrentScene->GetTextureCount() << " textures resident\n";
+			m_IsFirstFrameReported = true;
+		}
+
 		m_CurrentFrame = (m_CurrentFrame + 1) % m_MaxFramesInFlight;
 	}
 
@@ -341,7 +554,7 @@
 		for (size_t i = 0; i < m_MaxFramesInFlight; i++)
 		{
 			auto& bufferInfo = descriptorSetsContext.BufferInfos[i];
-			bufferInfo.buffer = m_pBuffer->GetUniformBuffers()[i];
+			bufferInfo.buffer = m_pBuffer->GetFrameBuffer(static_cast<uint32_t>(i));
 			bufferInfo.offset = 0;
 			bufferInfo.range = sizeof(UniformBufferObject);
 
@@ -415,22 +628,22 @@
 
 		// [2] Prepare writes for each frame
 		for (size_t i = 0; i < m_MaxFramesInFlight; ++i) {
-			// Point Lights Ssbo (binding 3)
+			// Point Lights Ssbo (binding 3), the dynamic offset picks this frame's lights inside the frame allocator
 			VkDescriptorBufferInfo pointLightsBufferInfo = {
-				.buffer = m_pBuffer->GetPointLightBuffers()[i],
+				.buffer = m_pBuffer->GetFrameBuffer(static_cast<uint32_t>(i)),
 				.offset = 0,
-				.range = sizeof(PointLight) * m_CurrentScene->GetPointLights().size()
+				.range = m_pBuffer->GetFrameDynamicRange(static_cast<uint32_t>(i))
 			};
 
 			VkDescriptorBufferInfo dirLightsBufferInfo = {
-				.buffer = m_pBuffer->GetDirLightBuffers()[i],
+				.buffer = m_pBuffer->GetFrameBuffer(static_cast<uint32_t>(i)),
 				.offset = 0,
-				.range = sizeof(DirectionalLight) * m_CurrentScene->GetDirectionalLights().size()
+				.range = m_pBuffer->GetFrameDynamicRange(static_cast<uint32_t>(i))
 			};
 
 			// Camera UBO (binding 5)
 			VkDescriptorBufferInfo cameraBufferInfo = {            //todo change this to be just a invViewMatrix maybe
-				.buffer = m_pBuffer->GetUniformBuffers()[i],
+				.buffer = m_pBuffer->GetFrameBuffer(static_cast<uint32_t>(i)),
 				.offset = 0,
 				.range = sizeof(UniformBufferObject) 
 			};
@@ -528,6 +741,41 @@
 	}
 
 
+	void GGVulkan::UpdateFrameBufferDescriptors(uint32_t frameIndex)
+	{
+		const uint64_t version = m_pBuffer->GetFrameBufferVersion(frameIndex);
+		if (m_FrameBufferVersions[frameIndex] == version) return;
+
+		// Only this frame's sets point at its buffer, and its fence was waited on, so they can be rewritten in place
+		const VkBuffer frameBuffer = m_pBuffer->GetFrameBuffer(frameIndex);
+		const VkDescriptorBufferInfo cameraBufferInfo{ frameBuffer, 0, sizeof(UniformBufferObject) };
+		const VkDescriptorBufferInfo lightsBufferInfo{ frameBuffer, 0, m_pBuffer->GetFrameDynamicRange(frameIndex) };
+
+		const auto bufferWrite = [](VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorBufferInfo* pBufferInfo)
+		{
+			return VkWriteDescriptorSet{
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = set,
+				.dstBinding = binding,
+				.descriptorCount = 1,
+				.descriptorType = type,
+				.pBufferInfo = pBufferInfo
+			};
+		};
+
+		const VkDescriptorSet lightingSet = m_pDescriptorManager->GetDescriptorSets(2)[frameIndex];
+		const std::array writes{
+			bufferWrite(m_pDescriptorManager->GetDescriptorSets(0)[frameIndex], 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &cameraBufferInfo),
+			bufferWrite(m_pDescriptorManager->GetDescriptorSets(1)[frameIndex], 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &cameraBufferInfo),
+			bufferWrite(lightingSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, &lightsBufferInfo),
+			bufferWrite(lightingSet, 5, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, &cameraBufferInfo),
+			bufferWrite(lightingSet, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, &lightsBufferInfo)
+		};
+
+		vkUpdateDescriptorSets(m_Device->GetVulkanDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		m_FrameBufferVersions[frameIndex] = version;
+	}
+
 	void GGVulkan::CreateDescriptorPool4PrePass() const
 	{
 		VkDescriptorPoolSize poolSize;
@@ -667,6 +915,7 @@
 	void GGVulkan::CreateDepthPrePassPipeline() const
 	{
 		PipelineContext depthPrePassPipeline{};
+		depthPrePassPipeline.SetVertexFormat(m_CurrentScene->GetVertexFormat());
 
 		GG::Shader vertShader{ "shaders/depthPrePassShader.vert.spv" , m_Device->GetVulkanDevice() };
 
@@ -791,12 +1040,17 @@
 	{
 		const auto& device = m_Device->GetVulkanDevice();
 
+		// MainLoop waited for the device, whatever is retired can go before its owners are destroyed
+		m_Device->GetDeletionQueue().Flush();
+
 		m_VkSwapChain->CleanupSwapChain();
 
 		m_BlitPass.Cleanup(device);
 
 		m_GBuffer.CleanUp(device);
 
+		m_TransientImages.Destroy();
+
 		m_pBuffer->DestroyBuffer();
 
 		m_pDescriptorManager->Destroy(device);
@@ -3,6 +3,7 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include <chrono>
 #include <vector>
 #include <cstdint>
 
@@ -45,6 +46,12 @@ public:
 	void CreateSurface();
 
 	void MainLoop();
+	// Accumulates the frame time and prints every stats report once m_FrameTimeReportInterval has passed
+	void UpdateFrameStats();
+	void ReportDeviceMemory() const;
+	// Uploads m_StagingBenchmarkMeshCount small meshes with a fresh staging buffer per upload, then again through the staging pool
+	void RunStagingBenchmark();
+	void OnMemoryBudgetCrossed(uint32_t heapIndex, const GG::MemoryHeapBudget& heap, bool isOverThreshold);
 
 	void DrawFrame();
 
@@ -56,6 +63,8 @@ public:
 
 	void CreateDescriptorSets4PrePass() const;
 	void CreateDescriptorSetsLighting();
+	// Points the frame's camera and light descriptors at its frame allocator buffer again after that grew
+	void UpdateFrameBufferDescriptors(uint32_t frameIndex);
 
 	void CreateDescriptorPool4PrePass() const;
 	void CreateDescriptorPoolLighting() const;
@@ -72,6 +81,10 @@ public:
 
 	//-------------Non Tutorial Functions-------------------
 	void AddScene(Scene* sceneToAdd);
+	// Runs RunStagingBenchmark once the scene is uploaded
+	void SetStagingBenchmark(bool isEnabled) { m_IsStagingBenchmark = isEnabled; }
+	// Prints the periodic frame and memory stats, off by default so normal runs stay quiet
+	void SetStatsReport(bool isEnabled) { m_IsReportingStats = isEnabled; }
 
 private:
 	VkInstance m_Instance									= nullptr;
@@ -94,11 +107,14 @@ private:
 	GG::VkErrorHandler m_ErrorHandler							   {};
 	GG::GBuffer m_GBuffer										   {};
 	GG::BlitPass m_BlitPass										   {};
+	GG::TransientImagePool m_TransientImages					   {};
 	//////////////////////////
 	
 	std::vector<VkSemaphore> m_ImageAvailableSemaphores;
 	std::vector<VkSemaphore> m_RenderFinishedSemaphores;
 	std::vector<VkFence> m_InFlightFences;
+	// GG::Buffer::GetFrameBufferVersion each frame's descriptor sets were last written with
+	std::vector<uint64_t> m_FrameBufferVersions;
 
 	bool m_FramebufferResized								= false;
 
@@ -106,6 +122,30 @@ private:
 	const int m_MaxFramesInFlight							= 2;
 	uint32_t m_CurrentFrame									= 0;
 
+	// Time to first frame, measured from Run so it covers Vulkan setup, geometry upload and whatever textures are waited for
+	std::chrono::high_resolution_clock::time_point m_RunStart;
+	bool m_IsFirstFrameReported								= false;
+
+	// Average frame time, printed every m_FrameTimeReportInterval seconds with --report-stats
+	float m_FrameTimeAccumulator							= 0.f;
+	uint32_t m_FrameTimeSamples								= 0;
+	static constexpr float m_FrameTimeReportInterval		= 5.f;
+	bool m_IsReportingStats								= false;
+	bool m_IsFrameTimeSampleSkipped						= false;
+
+	// Fraction of a heap's budget at which streaming is told to back off, and the least the texture budget is lowered to
+	static constexpr float m_MemoryBudgetThreshold			= 0.9f;
+	static constexpr uint64_t m_MinTextureMemoryBudget		= 64ull * 1024 * 1024;
+
+	// Main thread time per frame spent adding meshes of an incremental scene load
+	static constexpr float m_IncrementalLoadSliceMs			= 2.f;
+
+	bool m_IsStagingBenchmark								= false;
+	static constexpr uint32_t m_StagingBenchmarkMeshCount		= 4096;
+	static constexpr uint32_t m_StagingBenchmarkMeshesPerFrame	= 64;
+	static constexpr uint32_t m_StagingBenchmarkVertexCount		= 256;
+	static constexpr uint32_t m_StagingBenchmarkIndexCount		= 1024;
+
 	const uint32_t m_Width									= 1200;
 	const uint32_t m_Height									= 800;
 
@@ -1,21 +1,58 @@
 #include "Model.h"
 
-#include "GGBuffer.h"
 #include "GGVkDevice.h"
 
-void Mesh::CreateBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager)
+void Mesh::CreateBuffers(GG::Device* pDevice, GG::GeometryPool& geometryPool)
 {
-	CreateVertexBuffer(pDevice, pBuffer, pCommandManager);
-	CreateIndexBuffer(pDevice, pBuffer, pCommandManager);
+	m_GeometryAllocation = geometryPool.Allocate(static_cast<uint32_t>(GetVertexData().size()), GetIndexCount());
+	if (!m_GeometryAllocation.IsValid()) return;
+
+	CreateVertexBuffer(pDevice, geometryPool);
+	CreateIndexBuffer(pDevice, geometryPool);
+	m_UploadTicket = pDevice->GetUploadQueue().GetOpenTicket();
+}
+
+void Mesh::RecordBufferUploads(GG::GeometryPool& geometryPool, const VkCommandBuffer commandBuffer, const VkBuffer stagingBuffer,
+	const VkDeviceSize vertexOffset, const VkDeviceSize indexOffset)
+{
+	m_GeometryAllocation = geometryPool.Allocate(static_cast<uint32_t>(GetVertexData().size()), GetIndexCount());
+	if (!m_GeometryAllocation.IsValid()) return;
+
+	VkBufferCopy vertexCopy{};
+	vertexCopy.srcOffset = vertexOffset;
+	vertexCopy.dstOffset = geometryPool.GetVertexByteOffset(m_GeometryAllocation);
+	vertexCopy.size = static_cast<VkDeviceSize>(m_GeometryAllocation.VertexCount) * geometryPool.GetVertexStride();
+	vkCmdCopyBuffer(commandBuffer, stagingBuffer, geometryPool.GetVertexBuffer(), 1, &vertexCopy);
+
+	VkBufferCopy indexCopy{};
+	indexCopy.srcOffset = indexOffset;
+	indexCopy.dstOffset = geometryPool.GetIndexByteOffset(m_GeometryAllocation);
+	indexCopy.size = GetIndexData().size_bytes();
+	vkCmdCopyBuffer(commandBuffer, stagingBuffer, geometryPool.GetIndexBuffer(), 1, &indexCopy);
+}
+
+void Mesh::ReleaseGeometry(GG::GeometryPool& geometryPool)
+{
+	geometryPool.Free(m_GeometryAllocation);
+	m_GeometryAllocation = {};
+}
+
+void Mesh::SetGeometryView(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+{
+	m_VertexView = vertices;
+	m_IndexView = indices;
 }
 
-void Mesh::Destroy(const VkDevice device) const
+std::span<const Vertex> Mesh::GetVertexData() const
 {
-	vkDestroyBuffer(device, m_IndexBuffer, nullptr);
-	vkFreeMemory(device, m_IndexBufferMemory, nullptr);
+	if (!m_VertexView.empty()) return m_VertexView;
+	return m_Vertices;
+}
 
-	vkDestroyBuffer(device, m_VertexBuffer, nullptr);
-	vkFreeMemory(device, m_VertexBufferMemory, nullptr);
+std::span<const uint32_t> Mesh::GetIndexData() const
+{
+	if (!m_IndexView.empty()) return m_IndexView;
+	return m_Indices;
 }
 
 void Mesh::SetModelMatrix(const glm::mat4& modelMatrix)
@@ -33,53 +70,38 @@ void Mesh::SetModelMatrix(const aiMatrix4x4& modelMatrix)
 	);;
 }
 
-void Mesh::CreateVertexBuffer(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager)
+void Mesh::CreateVertexBuffer(GG::Device* pDevice, const GG::GeometryPool& geometryPool)
 {
-	const auto& device = pDevice->GetVulkanDevice();
-
-	VkDeviceSize bufferSize = sizeof(m_Vertices[0]) * m_Vertices.size();
-
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-
-	pBuffer->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+	const auto vertices = GetVertexData();
+	VkDeviceSize bufferSize = static_cast<VkDeviceSize>(geometryPool.GetVertexStride()) * vertices.size();
 
-	void* data;
-	vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-	memcpy(data, m_Vertices.data(), (size_t)bufferSize);
-	vkUnmapMemory(device, stagingBufferMemory);
+	GG::UploadQueue& uploadQueue = pDevice->GetUploadQueue();
+	const GG::StagingBuffer staging = uploadQueue.AcquireStagingBuffer(bufferSize);
+	GG::EncodeVertices(geometryPool.GetVertexFormat(), vertices, staging.GetMapped());
 
+	VkBufferCopy copyRegion{};
+	copyRegion.dstOffset = geometryPool.GetVertexByteOffset(m_GeometryAllocation);
+	copyRegion.size = bufferSize;
+	vkCmdCopyBuffer(uploadQueue.GetCommandBuffer(), staging.Buffer, geometryPool.GetVertexBuffer(), 1, &copyRegion);
 
-	pBuffer->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_VertexBuffer, m_VertexBufferMemory);
-
-	pBuffer->CopyBuffer(stagingBuffer, m_VertexBuffer, bufferSize, pDevice->GetGraphicsQueue(), pCommandManager);
-
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
+	uploadQueue.ReleaseBuffer(geometryPool.GetVertexBuffer(), copyRegion.dstOffset, bufferSize, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
 }
 
-void Mesh::CreateIndexBuffer(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager)
+void Mesh::CreateIndexBuffer(GG::Device* pDevice, const GG::GeometryPool& geometryPool)
 {
-	const auto& device = pDevice->GetVulkanDevice();
-
-	VkDeviceSize bufferSize = sizeof(m_Indices[0]) * m_Indices.size();
-
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-	pBuffer->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-	void* data;
-	vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-	memcpy(data, m_Indices.data(), (size_t)bufferSize);
-	vkUnmapMemory(device, stagingBufferMemory);
+	const auto indices = GetIndexData();
+	VkDeviceSize bufferSize = sizeof(uint32_t) * indices.size();
 
-	pBuffer->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_IndexBuffer, m_IndexBufferMemory);
+	GG::UploadQueue& uploadQueue = pDevice->GetUploadQueue();
+	const GG::StagingBuffer staging = uploadQueue.AcquireStagingBuffer(bufferSize);
+	memcpy(staging.GetMapped(), indices.data(), (size_t)bufferSize);
 
-	pBuffer->CopyBuffer(stagingBuffer, m_IndexBuffer, bufferSize, pDevice->GetGraphicsQueue(), pCommandManager);
+	VkBufferCopy copyRegion{};
+	copyRegion.dstOffset = geometryPool.GetIndexByteOffset(m_GeometryAllocation);
+	copyRegion.size = bufferSize;
+	vkCmdCopyBuffer(uploadQueue.GetCommandBuffer(), staging.Buffer, geometryPool.GetIndexBuffer(), 1, &copyRegion);
 
-	vkDestroyBuffer(device, stagingBuffer, nullptr);
-	vkFreeMemory(device, stagingBufferMemory, nullptr);
+	uploadQueue.ReleaseBuffer(geometryPool.GetIndexBuffer(), copyRegion.dstOffset, bufferSize, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		VK_ACCESS_INDEX_READ_BIT);
 }
@@ -1,4 +1,7 @@
 #pragma once
+#include <bit>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan_core.h>
@@ -12,6 +15,10 @@
 #include <glm/gtx/hash.hpp>
 
 #include "assimp/matrix4x4.h"
+#include "GGGeometryPool.h"
+#include "GGMeshlet.h"
+#include "GGMeshSimplifier.h"
+#include "GGUploadQueue.h"
 
 
 class Scene;
@@ -79,14 +86,84 @@ struct Vertex
 
 	bool operator==(const Vertex& other) const
 	{
-		return pos == other.pos && color == other.color && texCoord == other.texCoord;
+		return pos == other.pos && color == other.color && texCoord == other.texCoord &&
+			normal == other.normal && tangent == other.tangent && bitangent == other.bitangent;
 	}
 };
 
+// Quantized GPU layout of Vertex, see GG::EncodeVertices. Color is dropped (ProcessMesh never reads vertex colors)
+// and the bitangent is rebuilt in the shader as cross(normal, tangent) * handedness.
+struct CompactVertex
+{
+	glm::vec3 pos;
+	uint16_t texCoord[2];   // Half floats
+	int16_t normal[2];      // Octahedral, snorm16
+	uint32_t tangent;       // Octahedral, 15 bits per component, handedness in the top bit
+
+	static VkVertexInputBindingDescription getBindingDescription()
+	{
+		VkVertexInputBindingDescription bindingDescription{};
+		bindingDescription.binding = 0;
+		bindingDescription.stride = sizeof(CompactVertex);
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return bindingDescription;
+	}
+
+	static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions() {
+		std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+
+		// Position
+		attributeDescriptions[0].binding = 0;
+		attributeDescriptions[0].location = 0;
+		attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+		attributeDescriptions[0].offset = offsetof(CompactVertex, pos);
+
+		// Texture coordinates
+		attributeDescriptions[1].binding = 0;
+		attributeDescriptions[1].location = 1;
+		attributeDescriptions[1].format = VK_FORMAT_R16G16_SFLOAT;
+		attributeDescriptions[1].offset = offsetof(CompactVertex, texCoord);
+
+		// Normal
+		attributeDescriptions[2].binding = 0;
+		attributeDescriptions[2].location = 2;
+		attributeDescriptions[2].format = VK_FORMAT_R16G16_SNORM;
+		attributeDescriptions[2].offset = offsetof(CompactVertex, normal);
+
+		// Tangent and handedness
+		attributeDescriptions[3].binding = 0;
+		attributeDescriptions[3].location = 3;
+		attributeDescriptions[3].format = VK_FORMAT_R32_UINT;
+		attributeDescriptions[3].offset = offsetof(CompactVertex, tangent);
+
+		return attributeDescriptions;
+	}
+};
+static_assert(sizeof(CompactVertex) == 24);
+
 namespace std {
+	// Covers every attribute operator== compares. -0 is folded into +0 since the two compare equal.
 	template<> struct hash<Vertex> {
 		size_t operator()(Vertex const& vertex) const {
-			return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^ (hash<glm::vec2>()(vertex.texCoord) << 1);
+			const float values[] = {
+				vertex.pos.x, vertex.pos.y, vertex.pos.z, vertex.color.r, vertex.color.g, vertex.color.b, vertex.texCoord.x, vertex.texCoord.y,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.tangent.x, vertex.tangent.y, vertex.tangent.z,
+				vertex.bitangent.x, vertex.bitangent.y, vertex.bitangent.z, 0.f };
+
+			// Two attributes per multiply keeps the dependency chain short
+			uint64_t result = 0xcbf29ce484222325ull;
+			for (size_t i = 0; i < std::size(values); i += 2)
+			{
+				const uint64_t pair = std::bit_cast<uint32_t>(values[i] + 0.f) | static_cast<uint64_t>(std::bit_cast<uint32_t>(values[i + 1] + 0.f)) << 32;
+				result = (result ^ pair) * 0x100000001b3ull;
+			}
+
+			// FNV mixes the high bits poorly, open addressing tables mask the low ones
+			result ^= result >> 33;
+			result *= 0xff51afd7ed558ccdull;
+			result ^= result >> 33;
+			return static_cast<size_t>(result);
 		}
 	};
 }
@@ -94,8 +171,6 @@ namespace std {
 namespace GG
 {
 	class Texture;
-	class CommandManager;
-	class Buffer;
 	class Device;
 }
 
@@ -113,17 +188,50 @@ public:
 	const PBRMaterialIndices& GetMaterialIndices() const { return m_MaterialIndices; }
 	void SetMaterialIndices(const PBRMaterialIndices& indices) { m_MaterialIndices = indices; }
 
-	void CreateVertexBuffer(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager);
-	void CreateIndexBuffer(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager);
+	void CreateVertexBuffer(GG::Device* pDevice, const GG::GeometryPool& geometryPool);
+	void CreateIndexBuffer(GG::Device* pDevice, const GG::GeometryPool& geometryPool);
 
-	void CreateBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager);
-	void Destroy(VkDevice device) const;
+	// Allocates this mesh's range in the scene geometry pool and records its upload into the device's upload queue,
+	// the mesh is drawable once GetUploadTicket is ready
+	void CreateBuffers(GG::Device* pDevice, GG::GeometryPool& geometryPool);
+	// Same as CreateBuffers, but only records copies out of a shared staging buffer, making them visible is up to the caller
+	void RecordBufferUploads(GG::GeometryPool& geometryPool, VkCommandBuffer commandBuffer, VkBuffer stagingBuffer,
+		VkDeviceSize vertexOffset, VkDeviceSize indexOffset);
+	void ReleaseGeometry(GG::GeometryPool& geometryPool);
 
 	std::vector<Vertex>& GetVertices() { return m_Vertices; }
 	std::vector<uint32_t>& GetIndices() { return m_Indices; }
 
-	VkBuffer GetVertexBuffer() const {return m_VertexBuffer;}
-	VkBuffer GetIndexBuffer() const { return m_IndexBuffer; }
+	// Geometry used for upload: either the owned vectors or a view into a memory mapped mesh cache
+	void SetGeometryView(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+	std::span<const Vertex> GetVertexData() const;
+	std::span<const uint32_t> GetIndexData() const;
+	uint32_t GetIndexCount() const { return static_cast<uint32_t>(GetIndexData().size()); }
+
+	const GG::GeometryAllocation& GetGeometryAllocation() const { return m_GeometryAllocation; }
+	void SetUploadTicket(GG::UploadTicket ticket) { m_UploadTicket = ticket; }
+	GG::UploadTicket GetUploadTicket() const { return m_UploadTicket; }
+
+	// Meshlets cover the index buffer in order, empty for meshes that are always drawn whole
+	void SetMeshlets(std::vector<GG::Meshlet> meshlets) { m_Meshlets = std::move(meshlets); }
+	const std::vector<GG::Meshlet>& GetMeshlets() const { return m_Meshlets; }
+	// LOD 0 first, every level is a range of the index buffer. Meshes without LODs report their whole index buffer as LOD 0
+	void SetLods(std::vector<GG::MeshLod> lods) { m_Lods = std::move(lods); }
+	const std::vector<GG::MeshLod>& GetLods() const { return m_Lods; }
+	uint32_t GetLodCount() const { return m_Lods.empty() ? 1 : static_cast<uint32_t>(m_Lods.size()); }
+	GG::MeshLod GetLod(uint32_t lod) const { return m_Lods.empty() ? GG::MeshLod{ 0, GetIndexCount(), 0.f } : m_Lods[lod]; }
+
+	// Model space center and radius, a radius of 0 means unknown
+	void SetBoundingSphere(const glm::vec4& sphere) { m_BoundingSphere = sphere; }
+	const glm::vec4& GetBoundingSphere() const { return m_BoundingSphere; }
+
+	// Texture coordinate units per model space unit, averaged over the surface. 0 means unknown
+	void SetUvDensity(float uvDensity) { m_UvDensity = uvDensity; }
+	float GetUvDensity() const { return m_UvDensity; }
+
+	// Index ranges to draw this frame after Scene's LOD selection and culling, relative to the mesh's first index
+	std::vector<GG::IndexRange>& GetVisibleRanges() { return m_VisibleRanges; }
+	const std::vector<GG::IndexRange>& GetVisibleRanges() const { return m_VisibleRanges; }
 
 	void SetParentScene(Scene* scene) { m_pParentScene = scene; }
 
@@ -139,7 +247,10 @@ private:
 	std::vector<Vertex> m_Vertices;
 	std::vector<uint32_t> m_Indices;
 
-	const std::string m_ModelPath;
+	std::span<const Vertex> m_VertexView;
+	std::span<const uint32_t> m_IndexView;
+
+	std::string m_ModelPath;
 //	std::string m_ModelTexture;
 //
 //	GG::Texture* m_Texture;
@@ -148,10 +259,12 @@ private:
 	int m_TextureIndex;
 	glm::mat4 m_ModelMatrix;
 
-	VkBuffer m_VertexBuffer				= VK_NULL_HANDLE;
-	VkDeviceMemory m_VertexBufferMemory = VK_NULL_HANDLE;
-
-	VkBuffer m_IndexBuffer				= VK_NULL_HANDLE;
-	VkDeviceMemory m_IndexBufferMemory	= VK_NULL_HANDLE;
+	GG::GeometryAllocation m_GeometryAllocation;
+	GG::UploadTicket m_UploadTicket = 0;
+	std::vector<GG::Meshlet> m_Meshlets;
+	std::vector<GG::IndexRange> m_VisibleRanges;
+	std::vector<GG::MeshLod> m_Lods;
+	glm::vec4 m_BoundingSphere{ 0.f };
+	float m_UvDensity = 0.f;
 
 };
@@ -1,15 +1,111 @@
 #include "Scene.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
 
 #include "GGBuffer.h"
+#include "GGDeletionQueue.h"
+#include "GGHalfFloat.h"
+#include "GGMeshOptimizer.h"
+#include "GGMeshlet.h"
+#include "GGMeshSimplifier.h"
+#include "GGMipmaps.h"
+#include "GGSwizzle.h"
+#include "GGUploadQueue.h"
+#include "GGVkDevice.h"
 #include "tiny_obj_loader.h"
+#include "assimp/DefaultIOSystem.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
+namespace
+{
+    // Part of the mesh cache key, changing these invalidates every cached model.
+    // aiProcess_JoinIdenticalVertices is added when Scene's own vertex deduplication is off.
+    constexpr uint32_t ImportFlags =
+        aiProcess_Triangulate |
+        aiProcess_OptimizeMeshes |
+        aiProcess_FlipUVs |
+        aiProcess_SortByPType |
+        aiProcess_CalcTangentSpace;
+
+    // Remembers every file besides the source Assimp read during an import, so the mesh cache can hash them too
+    class RecordingIOSystem : public Assimp::DefaultIOSystem
+    {
+    public:
+        explicit RecordingIOSystem(const std::string& sourcePath)
+            : m_SourcePath(std::filesystem::path(sourcePath).lexically_normal())
+        {
+        }
+
+        Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override
+        {
+            Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(pFile, pMode);
+            if (stream && pMode[0] == 'r' && std::filesystem::path(pFile).lexically_normal() != m_SourcePath &&
+                std::find(m_OpenedPaths.begin(), m_OpenedPaths.end(), pFile) == m_OpenedPaths.end())
+            {
+                m_OpenedPaths.emplace_back(pFile);
+            }
+            return stream;
+        }
+
+        const std::vector<std::string>& GetOpenedPaths() const { return m_OpenedPaths; }
+
+    private:
+        std::filesystem::path m_SourcePath;
+        std::vector<std::string> m_OpenedPaths;
+    };
+
+    float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // 0 for files that do not exist, like the keys of embedded textures
+    uint64_t GetFileSize(const std::string& path)
+    {
+        std::error_code error;
+        const uintmax_t size = std::filesystem::file_size(path, error);
+        return error ? 0 : static_cast<uint64_t>(size);
+    }
+
+    float GetMaxScale(const glm::mat4& modelMatrix)
+    {
+        return std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+    }
+
+    // Distance to the closest point of the bounding sphere, so screen space sizes are never underestimated
+    float GetSphereDistance(const glm::vec4& sphere, const glm::mat4& modelMatrix, float maxScale, const glm::vec3& cameraPosition)
+    {
+        const glm::vec3 worldCenter = glm::vec3(modelMatrix * glm::vec4(glm::vec3(sphere), 1.f));
+        return std::max(glm::length(worldCenter - cameraPosition) - sphere.w * maxScale, 0.1f);
+    }
+
+    // Square root of the UV area over the model space area of all triangles
+    float ComputeUvDensity(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+    {
+        double uvArea = 0.0;
+        double surfaceArea = 0.0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const Vertex& a = vertices[indices[i]];
+            const Vertex& b = vertices[indices[i + 1]];
+            const Vertex& c = vertices[indices[i + 2]];
+
+            const glm::vec2 uvEdge0 = b.texCoord - a.texCoord;
+            const glm::vec2 uvEdge1 = c.texCoord - a.texCoord;
+            uvArea += std::abs(uvEdge0.x * uvEdge1.y - uvEdge0.y * uvEdge1.x) * 0.5;
+            surfaceArea += glm::length(glm::cross(b.pos - a.pos, c.pos - a.pos)) * 0.5;
+        }
+
+        return surfaceArea > 0.0 ? static_cast<float>(std::sqrt(uvArea / surfaceArea)) : 0.f;
+    }
+}
 
 Scene::Scene()
 {
@@ -58,35 +154,452 @@ void Scene::Initialize(GLFWwindow* window)
 
 void Scene::AddFileToScene(const std::string& filePath)
 {
-	Assimp::Importer importer;
+    MergeImport(ImportFile(filePath));
+}
+
+Scene::ImportedFile Scene::ImportFile(const std::string& filePath) const
+{
+    const auto loadStart = std::chrono::high_resolution_clock::now();
+
+    ImportedFile imported;
+    imported.FilePath = filePath;
+    imported.Textures.resize(m_DefaultTextureCount);
+
+    GG::FileImportRecord& record = imported.Record;
+    record.FilePath = filePath;
+
+    // Deduplication changes the cooked vertices, the flags below keep both variants apart in the cache
+    const uint32_t importFlags = m_IsVertexDeduplication ? ImportFlags : ImportFlags | aiProcess_JoinIdenticalVertices;
 
+    auto meshCache = std::make_unique<GG::MeshCache>(filePath, importFlags);
+    if (meshCache->Load())
+    {
+        record.Phases.MeshCacheLoadMs = MillisecondsSince(loadStart);
+        const auto convertStart = std::chrono::high_resolution_clock::now();
+        AddCachedMeshes(*meshCache, imported);
+        record.Phases.ConvertMs = MillisecondsSince(convertStart);
+
+        imported.LoadMs = MillisecondsSince(loadStart);
+        std::cout << "[MeshCache] " << filePath << ": warm load " << imported.LoadMs << " ms from " << meshCache->GetCachePath()
+            << " (cold load was " << meshCache->GetColdLoadTime() << " ms, "
+            << meshCache->GetColdLoadTime() / std::max(imported.LoadMs, 0.001f) << "x faster)\n";
+
+        record.IsMeshCacheHit = true;
+        record.BytesRead = GetFileSize(meshCache->GetCachePath());
+        FinishImportRecord(imported, loadStart);
+
+        imported.MeshCache = std::move(meshCache);
+        return imported;
+    }
 
-    const aiScene* scene =
-        importer.ReadFile(filePath,
-            aiProcess_Triangulate |
-            aiProcess_OptimizeMeshes |
-            aiProcess_FlipUVs |
-            aiProcess_JoinIdenticalVertices |
-            aiProcess_SortByPType |
-            aiProcess_CalcTangentSpace
-        );
+	Assimp::Importer importer;
+    // Owned and deleted by the importer
+    RecordingIOSystem* ioSystem = new RecordingIOSystem(filePath);
+    importer.SetIOHandler(ioSystem);
+    record.BytesRead = GetFileSize(filePath);
 
+    // Read and post processed in two calls so the report can tell them apart, same result as passing the flags to ReadFile
+    const auto parseStart = std::chrono::high_resolution_clock::now();
+    const aiScene* scene = importer.ReadFile(filePath, 0);
+    record.Phases.ParseMs = MillisecondsSince(parseStart);
+
+    if (scene)
+    {
+        const auto postProcessStart = std::chrono::high_resolution_clock::now();
+        scene = importer.ApplyPostProcessing(importFlags);
+        record.Phases.PostProcessMs = MillisecondsSince(postProcessStart);
+    }
 
 	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
 	{
 		std::cerr << "ASSIMP ERROR: " << importer.GetErrorString() << "\n";
-		return;
+		return imported;
 	}
 
-	ProcessNode(scene->mRootNode,scene, filePath);
+    const auto convertStart = std::chrono::high_resolution_clock::now();
+	ProcessNode(scene->mRootNode, scene, filePath, imported);
+    // The mesh passes are timed on their own inside ProcessMesh
+    const GG::FileImportPhases& phases = record.Phases;
+    record.Phases.ConvertMs = MillisecondsSince(convertStart) - phases.DeduplicateMs - phases.OptimizeMs - phases.MeshletMs - phases.LodMs;
+
+    imported.LoadMs = MillisecondsSince(loadStart);
+    const auto cacheWriteStart = std::chrono::high_resolution_clock::now();
+    for (const std::string& dependencyPath : ioSystem->GetOpenedPaths())
+    {
+        record.BytesRead += GetFileSize(dependencyPath);
+    }
+    meshCache->SetDependencies(ioSystem->GetOpenedPaths());
+    WriteMeshCache(*meshCache, scene, imported, imported.LoadMs);
+    record.Phases.MeshCacheWriteMs = MillisecondsSince(cacheWriteStart);
+    std::cout << "[MeshCache] " << filePath << ": cold load " << imported.LoadMs << " ms (Assimp), cached to " << meshCache->GetCachePath() << "\n";
+
+    FinishImportRecord(imported, loadStart);
+    return imported;
+}
+
+void Scene::FinishImportRecord(ImportedFile& imported, std::chrono::high_resolution_clock::time_point loadStart)
+{
+    GG::FileImportRecord& record = imported.Record;
+    record.MeshCount = static_cast<uint32_t>(imported.Models.size());
+    for (const Mesh& mesh : imported.Models)
+    {
+        record.VertexCount += mesh.GetVertexData().size();
+        record.IndexCount += mesh.GetIndexCount();
+    }
+    record.GeometryBytes = record.VertexCount * sizeof(Vertex) + record.IndexCount * sizeof(uint32_t);
+    record.TextureCount = static_cast<uint32_t>(imported.Textures.size()) - m_DefaultTextureCount;
+    record.TotalMs = MillisecondsSince(loadStart);
+}
+
+void Scene::MergeImport(ImportedFile imported)
+{
+    m_ImportReport.AddFile(std::move(imported.Record));
+    const std::vector<uint32_t> sceneIndices = MergeImportTextures(imported);
+
+    for (Mesh& mesh : imported.Models)
+    {
+        RemapMaterialIndices(mesh, sceneIndices);
+        mesh.SetParentScene(this);
+
+        m_Models.push_back(std::move(mesh));
+        m_ModelPaths.emplace(imported.FilePath, m_Models.size());
+    }
+
+    if (imported.MeshCache)
+    {
+        m_MeshCaches.emplace_back(std::move(imported.MeshCache));
+    }
+}
+
+std::vector<uint32_t> Scene::MergeImportTextures(ImportedFile& imported)
+{
+    std::vector<std::string> textureKeys(imported.Textures.size());
+    for (const auto& [key, idx] : imported.TexturePaths)
+    {
+        if (idx < textureKeys.size()) textureKeys[idx] = key;
+    }
+
+    std::vector<uint32_t> sceneIndices(imported.Textures.size());
+    for (uint32_t i = 0; i < sceneIndices.size(); ++i)
+    {
+        if (i < m_DefaultTextureCount)
+        {
+            sceneIndices[i] = i;
+            continue;
+        }
+
+        const auto existing = m_TexturePaths.find(textureKeys[i]);
+        if (existing != m_TexturePaths.end())
+        {
+            // Same as a serial load setting the usage on the texture it found
+            if (imported.Textures[i]->GetUsage() != GG::TextureUsage::Color)
+            {
+                SetTextureUsage(m_Textures, existing->second, imported.Textures[i]->GetUsage());
+            }
+            sceneIndices[i] = existing->second;
+            continue;
+        }
+
+        // Once the descriptor array exists it can not grow, textures past its end are drawn with the matching default texture
+        if (m_TextureSlotCapacity > 0 && m_Textures.size() >= m_TextureSlotCapacity)
+        {
+            std::cerr << "WARNING: no texture slot left for " << textureKeys[i] << ", using a default texture\n";
+            sceneIndices[i] = GetPlaceholderTexture(imported.Textures[i]->GetUsage());
+            continue;
+        }
+
+        sceneIndices[i] = static_cast<uint32_t>(m_Textures.size());
+        m_TexturePaths.emplace(textureKeys[i], sceneIndices[i]);
+        m_Textures.push_back(std::move(imported.Textures[i]));
+    }
+    return sceneIndices;
+}
+
+void Scene::RemapMaterialIndices(Mesh& mesh, const std::vector<uint32_t>& sceneIndices)
+{
+    Mesh::PBRMaterialIndices materialIndices = mesh.GetMaterialIndices();
+    materialIndices.albedoTexIdx = sceneIndices[materialIndices.albedoTexIdx];
+    materialIndices.normalTexIdx = sceneIndices[materialIndices.normalTexIdx];
+    materialIndices.metallicRoughnessTexIdx = sceneIndices[materialIndices.metallicRoughnessTexIdx];
+    materialIndices.aoTexIdx = sceneIndices[materialIndices.aoTexIdx];
+    mesh.SetMaterialIndices(materialIndices);
+}
+
+void Scene::AddCachedMeshes(const GG::MeshCache& meshCache, ImportedFile& imported) const
+{
+    std::vector<uint32_t> textureIndices;
+    textureIndices.reserve(meshCache.GetTextures().size());
+
+    for (const auto& texture : meshCache.GetTextures())
+    {
+        if (texture.IsEmbedded)
+        {
+            textureIndices.emplace_back(GetOrLoadTextureFromMemory(texture.EmbeddedData.data(), texture.EmbeddedWidth, texture.EmbeddedHeight,
+                imported.Textures, imported.TexturePaths, texture.Key, texture.Format));
+        }
+        else
+        {
+            textureIndices.emplace_back(GetOrLoadTextureFromFile(texture.Key, imported.Textures, imported.TexturePaths, texture.Format));
+        }
+    }
+
+    auto toImportIndex = [&](uint32_t cachedIdx) -> uint32_t
+    {
+        if (cachedIdx < m_DefaultTextureCount) return cachedIdx;
+        if (cachedIdx - m_DefaultTextureCount < textureIndices.size()) return textureIndices[cachedIdx - m_DefaultTextureCount];
+        return 0;
+    };
+
+    for (const auto& cachedMesh : meshCache.GetMeshes())
+    {
+        Mesh newMesh{};
+        newMesh.SetGeometryView(cachedMesh.Vertices, cachedMesh.Indices);
+        newMesh.SetMeshlets({ cachedMesh.Meshlets.begin(), cachedMesh.Meshlets.end() });
+        newMesh.SetLods({ cachedMesh.Lods.begin(), cachedMesh.Lods.end() });
+        newMesh.SetBoundingSphere(cachedMesh.BoundingSphere);
+        newMesh.SetUvDensity(cachedMesh.UvDensity);
+
+        Mesh::PBRMaterialIndices materialIndices;
+        materialIndices.albedoTexIdx = toImportIndex(cachedMesh.MaterialIndices.albedoTexIdx);
+        materialIndices.normalTexIdx = toImportIndex(cachedMesh.MaterialIndices.normalTexIdx);
+        materialIndices.metallicRoughnessTexIdx = toImportIndex(cachedMesh.MaterialIndices.metallicRoughnessTexIdx);
+        materialIndices.aoTexIdx = toImportIndex(cachedMesh.MaterialIndices.aoTexIdx);
+        SetTextureUsage(imported.Textures, materialIndices.normalTexIdx, GG::TextureUsage::NormalMap);
+        SetTextureUsage(imported.Textures, materialIndices.metallicRoughnessTexIdx, GG::TextureUsage::MetallicRoughness);
+
+        newMesh.SetMaterialIndices(materialIndices);
+        newMesh.SetModelMatrix(cachedMesh.ModelMatrix);
+
+        imported.Models.push_back(std::move(newMesh));
+    }
+}
+
+void Scene::WriteMeshCache(GG::MeshCache& meshCache, const aiScene* scene, const ImportedFile& imported, float coldLoadMs) const
+{
+    std::vector<std::string> textureKeys(imported.Textures.size());
+    for (const auto& [key, idx] : imported.TexturePaths)
+    {
+        if (idx < textureKeys.size()) textureKeys[idx] = key;
+    }
+
+    std::vector<GG::CachedTexture> cachedTextures;
+    std::unordered_map<uint32_t, uint32_t> cachedTextureIndices;
+    bool isCacheable = true;
+
+    // Only textures a mesh uses end up in the cache's own texture table
+    auto toCachedIndex = [&](uint32_t importIdx) -> uint32_t
+    {
+        if (importIdx < m_DefaultTextureCount) return importIdx;
+
+        auto [it, inserted] = cachedTextureIndices.try_emplace(importIdx, static_cast<uint32_t>(cachedTextures.size()));
+        if (inserted)
+        {
+            GG::CachedTexture& texture = cachedTextures.emplace_back();
+            texture.Key = textureKeys[importIdx];
+            texture.Format = imported.Textures[importIdx]->GetSourceFormat();
+
+            if (texture.Key.empty())
+            {
+                isCacheable = false;
+            }
+            else if (texture.Key[0] == '*')
+            {
+                const aiTexture* aiTex = scene->mTextures[std::stoi(texture.Key.substr(1))];
+                const size_t dataSize = aiTex->mHeight == 0 ? aiTex->mWidth : static_cast<size_t>(aiTex->mWidth) * aiTex->mHeight * sizeof(aiTexel);
+
+                texture.IsEmbedded = true;
+                texture.EmbeddedWidth = aiTex->mWidth;
+                texture.EmbeddedHeight = aiTex->mHeight;
+                texture.EmbeddedData = { reinterpret_cast<const uint8_t*>(aiTex->pcData), dataSize };
+            }
+        }
+        return m_DefaultTextureCount + it->second;
+    };
+
+    std::vector<GG::CachedMesh> cachedMeshes;
+    cachedMeshes.reserve(imported.Models.size());
+
+    for (const Mesh& mesh : imported.Models)
+    {
+        const Mesh::PBRMaterialIndices& materialIndices = mesh.GetMaterialIndices();
+
+        GG::CachedMesh& cachedMesh = cachedMeshes.emplace_back();
+        cachedMesh.Vertices = mesh.GetVertexData();
+        cachedMesh.Indices = mesh.GetIndexData();
+        cachedMesh.Meshlets = mesh.GetMeshlets();
+        cachedMesh.Lods = mesh.GetLods();
+        cachedMesh.BoundingSphere = mesh.GetBoundingSphere();
+        cachedMesh.UvDensity = mesh.GetUvDensity();
+        cachedMesh.MaterialIndices.albedoTexIdx = toCachedIndex(materialIndices.albedoTexIdx);
+        cachedMesh.MaterialIndices.normalTexIdx = toCachedIndex(materialIndices.normalTexIdx);
+        cachedMesh.MaterialIndices.metallicRoughnessTexIdx = toCachedIndex(materialIndices.metallicRoughnessTexIdx);
+        cachedMesh.MaterialIndices.aoTexIdx = toCachedIndex(materialIndices.aoTexIdx);
+        cachedMesh.ModelMatrix = mesh.GetModelMatrix();
+    }
+
+    if (!isCacheable)
+    {
+        std::cerr << "WARNING: Mesh cache skipped, texture without a key in " << meshCache.GetCachePath() << "\n";
+        return;
+    }
+
+    meshCache.Write(cachedMeshes, cachedTextures, coldLoadMs);
 }
 
 void Scene::AddFilesToScene(const std::initializer_list<const std::string>& filePath)
 {
-	for (auto& pFile : filePath)
+    const auto importStart = std::chrono::high_resolution_clock::now();
+
+    // One Assimp importer per job, ImportFile only reads the scene's import settings
+    std::vector<std::future<ImportedFile>> imports;
+    imports.reserve(filePath.size());
+	for (const std::string& file : filePath)
 	{
-		AddFileToScene(pFile);
+        imports.emplace_back(m_ThreadPool.Enqueue([this, file] { return ImportFile(file); }));
 	}
+
+    float fileSumMs = 0.f;
+    float largestFileMs = 0.f;
+    try
+    {
+        // Merged in argument order, so every mesh and texture index matches adding the files one by one
+        for (auto& import : imports)
+        {
+            ImportedFile imported = import.get();
+            fileSumMs += imported.LoadMs;
+            largestFileMs = std::max(largestFileMs, imported.LoadMs);
+            MergeImport(std::move(imported));
+        }
+    }
+    catch (...)
+    {
+        for (auto& import : imports)
+        {
+            if (import.valid()) import.wait();
+        }
+        throw;
+    }
+
+    std::cout << "[SceneImport] " << imports.size() << " files on " << m_ThreadPool.GetThreadCount() << " worker threads in "
+        << MillisecondsSince(importStart) << " ms (" << fileSumMs << " ms summed over the files, largest file " << largestFileMs << " ms)\n";
+}
+
+void Scene::AddFilesToSceneIncremental(const std::initializer_list<const std::string>& filePaths, LoadProgressCallback progressCallback)
+{
+    if (m_PendingLoads.empty())
+    {
+        m_LoadProgress = {};
+        m_IncrementalLoadStart = std::chrono::high_resolution_clock::now();
+        m_IncrementalLoadFrames = 0;
+        m_LongestLoadSliceMs = 0.f;
+    }
+    if (progressCallback)
+    {
+        m_LoadProgressCallback = std::move(progressCallback);
+    }
+
+    for (const std::string& file : filePaths)
+    {
+        PendingLoad& load = m_PendingLoads.emplace_back();
+        load.Import = m_ThreadPool.Enqueue([this, file] { return ImportFile(file); });
+        ++m_LoadProgress.FileCount;
+    }
+}
+
+void Scene::UpdateIncrementalLoad(GG::Device* pDevice, float timeSliceMs)
+{
+    if (m_PendingLoads.empty()) return;
+
+    const auto sliceStart = std::chrono::high_resolution_clock::now();
+    ++m_IncrementalLoadFrames;
+    bool isChanged = false;
+
+    // Files are added strictly in the order they were queued, so indices match a serial load of the same files
+    while (!m_PendingLoads.empty())
+    {
+        PendingLoad& load = m_PendingLoads.front();
+        if (!load.IsMerged)
+        {
+            if (load.Import.wait_for(std::chrono::seconds(0)) != std::future_status::ready) break;
+
+            load.Imported = load.Import.get();
+            m_ImportReport.AddFile(std::move(load.Imported.Record));
+            const uint32_t firstNewTexture = GetTextureCount();
+            load.TextureIndices = MergeImportTextures(load.Imported);
+            if (load.Imported.MeshCache)
+            {
+                m_MeshCaches.emplace_back(std::move(load.Imported.MeshCache));
+            }
+
+            // New textures go through the streaming path, their slots show a default texture until the upload
+            for (uint32_t i = firstNewTexture; i < GetTextureCount(); ++i)
+            {
+                StartTextureDecode(i);
+            }
+            if (firstNewTexture != GetTextureCount())
+            {
+                ++m_TextureResidencyVersion;
+            }
+
+            load.IsMerged = true;
+            ++m_LoadProgress.ImportedFileCount;
+            m_LoadProgress.MeshCount += static_cast<uint32_t>(load.Imported.Models.size());
+            isChanged = true;
+        }
+
+        // Every frame merges a file or adds at least one mesh, so a slice shorter than one upload still makes progress
+        while (load.NextMesh < load.Imported.Models.size() && (!isChanged || MillisecondsSince(sliceStart) < timeSliceMs))
+        {
+            Mesh& mesh = load.Imported.Models[load.NextMesh++];
+            RemapMaterialIndices(mesh, load.TextureIndices);
+            if (AddMesh(std::move(mesh), pDevice))
+            {
+                m_ModelPaths.emplace(load.Imported.FilePath, m_Models.size());
+                ++m_LoadProgress.AddedMeshCount;
+            }
+            else
+            {
+                std::cerr << "WARNING: geometry pool full, mesh " << load.NextMesh - 1 << " of " << load.Imported.FilePath << " is skipped ("
+                    << m_GeometryPool.GetVertexAllocator().GetLargestFreeRange() << " vertices, "
+                    << m_GeometryPool.GetIndexAllocator().GetLargestFreeRange() << " indices free in one range)\n";
+            }
+            isChanged = true;
+        }
+
+        if (load.NextMesh < load.Imported.Models.size()) break;
+
+        m_PendingLoads.pop_front();
+        if (MillisecondsSince(sliceStart) >= timeSliceMs) break;
+    }
+
+    m_LongestLoadSliceMs = std::max(m_LongestLoadSliceMs, MillisecondsSince(sliceStart));
+    if (!isChanged) return;
+
+    // Every file counts half for its import and half for its mesh uploads
+    float completedFiles = static_cast<float>(m_LoadProgress.FileCount - m_PendingLoads.size());
+    for (const PendingLoad& load : m_PendingLoads)
+    {
+        if (!load.IsMerged) continue;
+        completedFiles += 0.5f + 0.5f * static_cast<float>(load.NextMesh) / static_cast<float>(load.Imported.Models.size());
+    }
+
+    m_LoadProgress.Fraction = completedFiles / static_cast<float>(m_LoadProgress.FileCount);
+    m_LoadProgress.ElapsedMs = MillisecondsSince(m_IncrementalLoadStart);
+    m_LoadProgress.EtaMs = m_LoadProgress.ElapsedMs * (1.f - m_LoadProgress.Fraction) / m_LoadProgress.Fraction;
+    m_LoadProgress.IsDone = m_PendingLoads.empty();
+
+    if (m_LoadProgressCallback)
+    {
+        m_LoadProgressCallback(m_LoadProgress);
+    }
+
+    if (m_LoadProgress.IsDone)
+    {
+        std::cout << "[IncrementalLoad] " << m_LoadProgress.FileCount << " files, " << m_LoadProgress.AddedMeshCount << " meshes added over "
+            << m_IncrementalLoadFrames << " frames in " << m_LoadProgress.ElapsedMs << " ms, longest slice " << m_LongestLoadSliceMs << " ms\n";
+        m_LoadProgressCallback = {};
+        WriteImportReport();
+    }
 }
 
 void Scene::AddLight(PointLight lightToAdd)
@@ -114,22 +627,125 @@ void Scene::BindTextureToMesh(const std::string& modelFilePath, const std::strin
 	}
 }
 
-void Scene::ProcessNode(const aiNode* node, const aiScene* scene, const std::string& modelDirectory)
+void Scene::ProcessNode(const aiNode* node, const aiScene* scene, const std::string& modelDirectory, ImportedFile& imported) const
 {
 	for (uint32_t i = 0; i < node->mNumMeshes; i++)
 	{
 		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		m_Models.push_back(ProcessMesh(mesh, scene, modelDirectory));
-        m_ModelPaths.emplace(modelDirectory, m_Models.size());
+		imported.Models.push_back(ProcessMesh(mesh, scene, modelDirectory, imported));
 	}
 
 	for (uint32_t i = 0; i < node->mNumChildren; i++)
 	{
-		ProcessNode(node->mChildren[i], scene, modelDirectory);
+		ProcessNode(node->mChildren[i], scene, modelDirectory, imported);
 	}
 }
 
-Mesh Scene::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& modelDirectory)
+void Scene::DeduplicateVertices(Mesh& mesh, const std::string& meshName)
+{
+    const auto dedupStart = std::chrono::high_resolution_clock::now();
+    const GG::VertexDedupStats stats = GG::MeshOptimizer::DeduplicateVertices(mesh.GetVertices(), mesh.GetIndices());
+    const float dedupMs = MillisecondsSince(dedupStart);
+
+    std::cout << "[VertexDedup] " << (meshName.empty() ? "<unnamed>" : meshName) << ": " << stats.SourceVertexCount << " -> " << stats.VertexCount
+        << " vertices (" << 100.f * (stats.SourceVertexCount - stats.VertexCount) / std::max(stats.SourceVertexCount, 1u) << "% fewer, "
+        << dedupMs << " ms)\n";
+}
+
+void Scene::OptimizeMesh(Mesh& mesh, const std::string& meshName)
+{
+    std::vector<Vertex>& vertices = mesh.GetVertices();
+    std::vector<uint32_t>& indices = mesh.GetIndices();
+    if (indices.size() < 3) return;
+
+    const auto optimizeStart = std::chrono::high_resolution_clock::now();
+    const uint32_t sourceVertexCount = static_cast<uint32_t>(vertices.size());
+    const GG::VertexCacheStats before = GG::MeshOptimizer::AnalyzeVertexCache(indices, sourceVertexCount);
+
+    GG::MeshOptimizer::OptimizeVertexCache(indices, sourceVertexCount);
+    GG::MeshOptimizer::OptimizeOverdraw(indices, vertices);
+    const uint32_t vertexCount = GG::MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+    const GG::VertexCacheStats after = GG::MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+    std::cout << "[MeshOptimizer] " << (meshName.empty() ? "<unnamed>" : meshName) << ": " << indices.size() / 3 << " triangles, "
+        << vertexCount << " vertices, ACMR " << before.Acmr << " -> " << after.Acmr << ", ATVR " << before.Atvr << " -> " << after.Atvr
+        << " (" << MillisecondsSince(optimizeStart) << " ms)\n";
+}
+
+void Scene::BuildMeshlets(Mesh& mesh, const std::string& meshName)
+{
+    const auto buildStart = std::chrono::high_resolution_clock::now();
+    mesh.SetMeshlets(GG::BuildMeshlets(mesh.GetIndices(), mesh.GetVertices()));
+    const float buildMs = MillisecondsSince(buildStart);
+
+    const size_t triangleCount = mesh.GetIndices().size() / 3;
+    std::cout << "[Meshlets] " << (meshName.empty() ? "<unnamed>" : meshName) << ": " << mesh.GetMeshlets().size() << " meshlets from "
+        << triangleCount << " triangles in " << buildMs << " ms (" << triangleCount / std::max(buildMs, 0.001f) / 1000.f << " Mtri/s)\n";
+}
+
+void Scene::BuildLods(Mesh& mesh, const std::string& meshName)
+{
+    std::vector<Vertex>& vertices = mesh.GetVertices();
+    std::vector<uint32_t>& indices = mesh.GetIndices();
+    if (indices.empty()) return;
+
+    glm::vec3 aabbMin{ vertices[indices[0]].pos };
+    glm::vec3 aabbMax{ aabbMin };
+    for (uint32_t index : indices)
+    {
+        aabbMin = glm::min(aabbMin, vertices[index].pos);
+        aabbMax = glm::max(aabbMax, vertices[index].pos);
+    }
+    const glm::vec3 center = (aabbMin + aabbMax) * 0.5f;
+    float radius = 0.f;
+    for (uint32_t index : indices)
+    {
+        radius = std::max(radius, glm::length(vertices[index].pos - center));
+    }
+    mesh.SetBoundingSphere(glm::vec4(center, radius));
+
+    const uint32_t lod0IndexCount = static_cast<uint32_t>(indices.size());
+    if (lod0IndexCount / 3 < m_MinLodTriangles) return;
+
+    const auto simplifyStart = std::chrono::high_resolution_clock::now();
+
+    std::vector<GG::MeshLod> lods{ { 0, lod0IndexCount, 0.f } };
+    std::vector<uint32_t> previous(indices.begin(), indices.end());
+
+    while (lods.size() < m_MaxLodCount && previous.size() / 3 >= m_MinLodTriangles)
+    {
+        const uint32_t targetIndexCount = static_cast<uint32_t>(previous.size() / 3 * m_LodTriangleRatio) * 3;
+
+        float error = 0.f;
+        std::vector<uint32_t> simplified = GG::MeshSimplifier::Simplify(previous, vertices, targetIndexCount, radius * m_MaxLodRelativeError, &error);
+        if (simplified.empty() || simplified.size() > previous.size() * m_MinLodReduction) break;
+
+        GG::MeshOptimizer::OptimizeVertexCache(simplified, static_cast<uint32_t>(vertices.size()));
+
+        // Each level is simplified from the previous one, so the errors add up
+        lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), lods.back().Error + error });
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        previous = std::move(simplified);
+    }
+
+    if (lods.size() == 1) return;
+
+    std::cout << "[MeshLod] " << (meshName.empty() ? "<unnamed>" : meshName) << ":";
+    for (size_t i = 0; i < lods.size(); ++i)
+    {
+        std::cout << (i == 0 ? " " : " -> ") << lods[i].IndexCount / 3;
+    }
+    std::cout << " triangles, errors";
+    for (size_t i = 1; i < lods.size(); ++i)
+    {
+        std::cout << " " << lods[i].Error;
+    }
+    std::cout << " (radius " << radius << ", " << MillisecondsSince(simplifyStart) << " ms)\n";
+
+    mesh.SetLods(std::move(lods));
+}
+
+Mesh Scene::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& modelDirectory, ImportedFile& imported) const
 {
     Mesh newMesh{};
     Mesh::PBRMaterialIndices materialIndices;
@@ -206,6 +822,31 @@ Mesh Scene::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& m
         }
     }
 
+    GG::FileImportPhases& phases = imported.Record.Phases;
+    auto phaseStart = std::chrono::high_resolution_clock::now();
+    const auto endPhase = [&phaseStart](float& phaseMs)
+    {
+        phaseMs += MillisecondsSince(phaseStart);
+        phaseStart = std::chrono::high_resolution_clock::now();
+    };
+
+    if (m_IsVertexDeduplication)
+    {
+        DeduplicateVertices(newMesh, mesh->mName.C_Str());
+        endPhase(phases.DeduplicateMs);
+    }
+
+    if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+    {
+        OptimizeMesh(newMesh, mesh->mName.C_Str());
+        newMesh.SetUvDensity(ComputeUvDensity(newMesh.GetVertices(), newMesh.GetIndices()));
+        endPhase(phases.OptimizeMs);
+        BuildMeshlets(newMesh, mesh->mName.C_Str());
+        endPhase(phases.MeshletMs);
+        BuildLods(newMesh, mesh->mName.C_Str());
+        endPhase(phases.LodMs);
+    }
+
     // Materials (PBR Textures)
     aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
     std::string modelBaseDir = std::filesystem::path(modelDirectory).parent_path().string();
@@ -215,11 +856,11 @@ Mesh Scene::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& m
     aiString path;
     if (material->GetTexture(aiTextureType_BASE_COLOR, 0, &path) == AI_SUCCESS)
     {
-        materialIndices.albedoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
+        materialIndices.albedoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
     }
     else if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
     {
-        materialIndices.albedoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
+        materialIndices.albedoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
     }
     else {
         materialIndices.albedoTexIdx = 0; 
@@ -228,55 +869,56 @@ Mesh Scene::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& m
    // Normal Map
    if (material->GetTexture(aiTextureType_NORMAL_CAMERA, 0, &path) == AI_SUCCESS)
    {
-       materialIndices.normalTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
+       materialIndices.normalTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
    }
    else if (material->GetTexture(aiTextureType_NORMALS, 0, &path) == AI_SUCCESS) 
    {
-       materialIndices.normalTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
+       materialIndices.normalTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
    }
    else 
    {
        materialIndices.normalTexIdx = 1;
    }
+   SetTextureUsage(imported.Textures, materialIndices.normalTexIdx, GG::TextureUsage::NormalMap);
 
    // Metalness Roughness Map
    if (material->GetTexture(aiTextureType_METALNESS, 0, &path) == AI_SUCCESS)
    {
-       materialIndices.metallicRoughnessTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
+       materialIndices.metallicRoughnessTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
    }
    else if (material->GetTexture(aiTextureType_DIFFUSE_ROUGHNESS, 0, &path) == AI_SUCCESS) 
    {
-       materialIndices.metallicRoughnessTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
+       materialIndices.metallicRoughnessTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_UNORM);
    }
    else 
    {
        materialIndices.metallicRoughnessTexIdx = 2;
    }
+   SetTextureUsage(imported.Textures, materialIndices.metallicRoughnessTexIdx, GG::TextureUsage::MetallicRoughness);
 
    // Ambient Occlusion Map
    //if (material->GetTexture(aiTextureType_AMBIENT_OCCLUSION, 0, &path) == AI_SUCCESS)
    //{
-   //    materialIndices.aoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
+   //    materialIndices.aoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
    //}
    //else if (material->GetTexture(aiTextureType_LIGHTMAP, 0, &path) == AI_SUCCESS) 
    //{
-   //    materialIndices.aoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, m_Textures, m_TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
+   //    materialIndices.aoTexIdx = GetOrLoadTexture(path.C_Str(), scene, modelBaseDir, imported.Textures, imported.TexturePaths, VK_FORMAT_R8G8B8A8_SRGB);
    //}
    //else 
    //{
    //    materialIndices.aoTexIdx = 3; 
    //}
+   //SetTextureUsage(imported.Textures, materialIndices.aoTexIdx, GG::TextureUsage::Occlusion);
 
     newMesh.SetMaterialIndices(materialIndices);
     newMesh.SetModelMatrix(scene->mRootNode->mTransformation);
 
-    newMesh.SetParentScene(this);
-
     return newMesh;
 }
 
 uint32_t Scene::GetOrLoadTexture(const std::string& textureFileName, const aiScene* scene,const std::string& modelDirectory, 
-    std::vector<std::unique_ptr<GG::Texture>>& textures,std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat)
+    std::vector<std::unique_ptr<GG::Texture>>& textures,std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat) const
 {
     std::string texId = textureFileName;
 
@@ -290,26 +932,39 @@ uint32_t Scene::GetOrLoadTexture(const std::string& textureFileName, const aiSce
     {
         std::filesystem::path modelPath = modelDirectory;
         std::filesystem::path resolvePath = modelPath / textureFileName;
-        std::string fullTexturePath = resolvePath.string();
 
-        if (texturePaths.count(fullTexturePath)) 
+        return GetOrLoadTextureFromFile(resolvePath.string(), textures, texturePaths, imgFormat);
+    }
+}
+
+void Scene::SetTextureUsage(std::vector<std::unique_ptr<GG::Texture>>& textures, uint32_t textureIndex, GG::TextureUsage usage)
+{
+    // The default textures are shared between slots and always stay uncompressed
+    if (textureIndex < m_DefaultTextureCount || textureIndex >= textures.size()) return;
+
+    textures[textureIndex]->SetUsage(usage);
+}
+
+uint32_t Scene::GetOrLoadTextureFromFile(const std::string& fullTexturePath, std::vector<std::unique_ptr<GG::Texture>>& textures,
+    std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat) const
+{
+    if (texturePaths.count(fullTexturePath)) 
+    {
+        return texturePaths[fullTexturePath];
+    }
+    else 
+    {
+        if (std::filesystem::exists(fullTexturePath)) 
         {
-            return texturePaths[fullTexturePath];
+            textures.emplace_back(std::make_unique<GG::Texture>(fullTexturePath,imgFormat));
+            uint32_t newIndex = static_cast<uint32_t>(textures.size() - 1);
+            texturePaths.emplace(fullTexturePath, newIndex);
+            return newIndex;
         }
         else 
         {
-            if (std::filesystem::exists(fullTexturePath)) 
-            {
-                textures.emplace_back(std::make_unique<GG::Texture>(fullTexturePath,imgFormat));
-                uint32_t newIndex = static_cast<uint32_t>(textures.size() - 1);
-                texturePaths.emplace(fullTexturePath, newIndex);
-                return newIndex;
-            }
-            else 
-            {
-                std::cerr << "WARNING: Texture file not found: " << fullTexturePath << "\n";
-                return 0; 
-            }
+            std::cerr << "WARNING: Texture file not found: " << fullTexturePath << "\n";
+            return 0; 
         }
     }
 }
@@ -318,7 +973,16 @@ uint32_t Scene::GetOrLoadTexture(const std::string& textureFileName, const aiSce
 uint32_t Scene::GetOrLoadTextureFromMemory(const aiTexture* aiTex,
     std::vector<std::unique_ptr<GG::Texture>>& textures,
     std::unordered_map<std::string, uint32_t>& texturePaths,
-    const std::string& fallbackKey, VkFormat imgFormat)
+    const std::string& fallbackKey, VkFormat imgFormat) const
+{
+    return GetOrLoadTextureFromMemory(reinterpret_cast<const uint8_t*>(aiTex->pcData), aiTex->mWidth, aiTex->mHeight,
+        textures, texturePaths, fallbackKey, imgFormat);
+}
+
+uint32_t Scene::GetOrLoadTextureFromMemory(const uint8_t* data, uint32_t width, uint32_t height,
+    std::vector<std::unique_ptr<GG::Texture>>& textures,
+    std::unordered_map<std::string, uint32_t>& texturePaths,
+    const std::string& fallbackKey, VkFormat imgFormat) const
 {
     if (texturePaths.count(fallbackKey)) {
         return texturePaths[fallbackKey];
@@ -327,11 +991,11 @@ uint32_t Scene::GetOrLoadTextureFromMemory(const aiTexture* aiTex,
     int32_t texW, texH, texChannels;
     std::unique_ptr<stbi_uc[]> pixels;
 
-    if (aiTex->mHeight == 0) {
+    if (height == 0) {
         // Compressed texture data
         stbi_uc* loadedPixels = stbi_load_from_memory(
-            reinterpret_cast<stbi_uc*>(aiTex->pcData),
-            aiTex->mWidth,
+            data,
+            static_cast<int>(width),
             &texW, &texH, &texChannels, STBI_rgb_alpha);
 
         if (loadedPixels) {
@@ -339,24 +1003,14 @@ uint32_t Scene::GetOrLoadTextureFromMemory(const aiTexture* aiTex,
         }
     }
     else {
-        // Uncompressed texture data
-        size_t bufferSize = aiTex->mWidth * aiTex->mHeight * 4;
-        pixels = std::make_unique<stbi_uc[]>(bufferSize);
-
-        if (pixels) {
-            for (uint32_t y = 0; y < aiTex->mHeight; y++) {
-                for (uint32_t x = 0; x < aiTex->mWidth; x++) {
-                    const aiTexel* texel = &aiTex->pcData[y * aiTex->mWidth + x];
-                    uint32_t idx = (y * aiTex->mWidth + x) * 4;
-                    pixels[idx] = texel->r;
-                    pixels[idx + 1] = texel->g;
-                    pixels[idx + 2] = texel->b;
-                    pixels[idx + 3] = texel->a;
-                }
-            }
-        }
-        texW = aiTex->mWidth;
-        texH = aiTex->mHeight;
+        // Uncompressed texture data, aiTexel is stored as BGRA
+        static_assert(sizeof(aiTexel) == 4);
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        pixels = std::make_unique_for_overwrite<stbi_uc[]>(pixelCount * 4);
+        GG::SwizzleBgraToRgba(data, pixels.get(), pixelCount);
+
+        texW = width;
+        texH = height;
     }
 
     if (pixels) {
@@ -380,23 +1034,545 @@ uint32_t Scene::GetOrLoadTextureFromMemory(const aiTexture* aiTex,
 void Scene::Update()
 {
     m_Camera.Update();
+    UpdateVisibility();
+}
+
+uint32_t Scene::SelectLod(const Mesh& mesh, const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, float pixelsPerUnit) const
+{
+    const glm::vec4& sphere = mesh.GetBoundingSphere();
+    if (mesh.GetLodCount() == 1 || sphere.w <= 0.f) return 0;
+
+    const float maxScale = GetMaxScale(modelMatrix);
+    const float distance = GetSphereDistance(sphere, modelMatrix, maxScale, cameraPosition);
+
+    uint32_t selectedLod = 0;
+    for (uint32_t lod = 1; lod < mesh.GetLodCount(); ++lod)
+    {
+        const float pixelError = mesh.GetLod(lod).Error * maxScale * pixelsPerUnit / distance;
+        if (pixelError > m_LodErrorThreshold) break;
+        selectedLod = lod;
+    }
+
+    return selectedLod;
+}
+
+void Scene::UpdateVisibility()
+{
+    m_VisibilityStats = {};
+
+    const glm::mat4 projection = m_Camera.GetProjectionMatrix();
+    const glm::mat4 viewProjection = projection * m_Camera.GetViewMatrix();
+    const glm::vec3 cameraPosition = m_Camera.GetPosition();
+    // projection[1][1] is 1 / tan(fovY / 2)
+    const float pixelsPerUnit = static_cast<float>(m_ViewportHeight) * 0.5f * std::abs(projection[1][1]);
+
+    for (auto& mesh : m_Models)
+    {
+        std::vector<GG::IndexRange>& visibleRanges = mesh.GetVisibleRanges();
+        visibleRanges.clear();
+
+        const glm::mat4 modelMatrix = mesh.GetModelMatrix();
+        const uint32_t lod = m_IsLodSelection ? SelectLod(mesh, modelMatrix, cameraPosition, pixelsPerUnit) : 0;
+        const GG::MeshLod meshLod = mesh.GetLod(lod);
+        const std::vector<GG::Meshlet>& meshlets = mesh.GetMeshlets();
+
+        m_VisibilityStats.TotalMeshlets += static_cast<uint32_t>(meshlets.size());
+        m_VisibilityStats.TotalTriangles += mesh.GetLod(0).IndexCount / 3;
+        m_VisibilityStats.ReducedLodMeshes += lod > 0 ? 1 : 0;
+
+        if (!m_IsClusterCulling)
+        {
+            visibleRanges.push_back({ meshLod.FirstIndex, meshLod.IndexCount });
+        }
+        else
+        {
+            const GG::FrustumPlanes planes = GG::ExtractFrustumPlanes(viewProjection * modelMatrix);
+            const glm::vec4& sphere = mesh.GetBoundingSphere();
+
+            if (lod == 0 && !meshlets.empty())
+            {
+                const glm::vec3 modelCameraPosition = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(cameraPosition, 1.f));
+
+                // Normal cones stay valid under rotation and uniform scale only
+                const float scaleX = glm::length(glm::vec3(modelMatrix[0]));
+                const float scaleY = glm::length(glm::vec3(modelMatrix[1]));
+                const float scaleZ = glm::length(glm::vec3(modelMatrix[2]));
+                const bool isConeCullingEnabled = std::abs(scaleX - scaleY) <= 1e-3f * scaleX && std::abs(scaleX - scaleZ) <= 1e-3f * scaleX;
+
+                m_VisibilityStats.VisibleMeshlets += GG::CullMeshlets(meshlets, planes, modelCameraPosition, isConeCullingEnabled, visibleRanges);
+            }
+            else if (sphere.w <= 0.f || GG::IsSphereVisible(planes, glm::vec3(sphere), sphere.w))
+            {
+                visibleRanges.push_back({ meshLod.FirstIndex, meshLod.IndexCount });
+            }
+        }
+
+        m_VisibilityStats.DrawCount += static_cast<uint32_t>(visibleRanges.size());
+        for (const GG::IndexRange& range : visibleRanges)
+        {
+            m_VisibilityStats.VisibleTriangles += range.IndexCount / 3;
+        }
+    }
+}
+
+void Scene::CreateMeshBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer)
+{
+    const auto uploadStart = std::chrono::high_resolution_clock::now();
+
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    for (const auto& model : m_Models)
+    {
+        vertexCount += model.GetVertexData().size();
+        indexCount += model.GetIndexCount();
+    }
+
+    // Vulkan does not allow zero sized buffers, keep some room even for an empty scene
+    const auto withHeadroom = [](uint64_t count) { return static_cast<uint32_t>(std::max<uint64_t>(count + static_cast<uint64_t>(count * m_GeometryPoolHeadroom), 1024)); };
+    // Meshes of an incremental load still importing arrive after the pool is created
+    const bool isLoadPending = IsIncrementalLoadPending();
+    m_GeometryPool.Create(pBuffer, m_VertexFormat, withHeadroom(vertexCount) + (isLoadPending ? m_IncrementalVertexReserve : 0),
+        withHeadroom(indexCount) + (isLoadPending ? m_IncrementalIndexReserve : 0));
+
+    GG::UploadQueue& uploadQueue = pDevice->GetUploadQueue();
+    if (m_IsBatchedMeshUpload)
+    {
+        UploadMeshesBatched(pDevice);
+    }
+    else
+    {
+        for (auto& model : m_Models)
+        {
+            model.CreateBuffers(pDevice, m_GeometryPool);
+            uploadQueue.Submit();
+        }
+    }
+
+    // Startup waits, so the first frame draws every mesh and the report times the whole upload
+    uploadQueue.Wait(uploadQueue.Submit());
+    m_ReadyUploadTicket = uploadQueue.GetReadyTicket();
+
+    const float uploadMs = MillisecondsSince(uploadStart);
+    std::cout << "[MeshUpload] " << m_Models.size() << " meshes uploaded in " << uploadMs << " ms ("
+        << (m_IsBatchedMeshUpload ? "1 staging buffer, 1 submit" : std::to_string(m_Models.size() * 2) + " staging buffers, " + std::to_string(m_Models.size()) + " submits")
+        << ")\n";
+    std::cout << "[GeometryPool] " << m_GeometryPool.GetVertexAllocator().GetUsed() << "/" << m_GeometryPool.GetVertexAllocator().GetCapacity() << " vertices, "
+        << m_GeometryPool.GetIndexAllocator().GetUsed() << "/" << m_GeometryPool.GetIndexAllocator().GetCapacity() << " indices in 2 buffers\n";
+
+    const float vertexMB = static_cast<float>(vertexCount * m_GeometryPool.GetVertexStride()) / (1024.f * 1024.f);
+    const float fullVertexMB = static_cast<float>(vertexCount * sizeof(Vertex)) / (1024.f * 1024.f);
+    std::cout << "[VertexFormat] " << GG::GetVertexFormatName(m_VertexFormat) << ": " << m_GeometryPool.GetVertexStride() << " bytes/vertex, "
+        << vertexMB << " MB vertex data (Full format: " << sizeof(Vertex) << " bytes/vertex, " << fullVertexMB << " MB)\n";
+
+    GG::MeshUploadRecord meshUpload;
+    meshUpload.VertexFormat = GG::GetVertexFormatName(m_VertexFormat);
+    meshUpload.IsBatched = m_IsBatchedMeshUpload;
+    meshUpload.MeshCount = static_cast<uint32_t>(m_Models.size());
+    meshUpload.VertexBytes = vertexCount * m_GeometryPool.GetVertexStride();
+    meshUpload.IndexBytes = indexCount * sizeof(uint32_t);
+    meshUpload.PoolBytes = static_cast<uint64_t>(m_GeometryPool.GetVertexAllocator().GetCapacity()) * m_GeometryPool.GetVertexStride()
+        + static_cast<uint64_t>(m_GeometryPool.GetIndexAllocator().GetCapacity()) * sizeof(uint32_t);
+    meshUpload.UploadMs = uploadMs;
+    m_ImportReport.SetMeshUpload(std::move(meshUpload));
+    WriteImportReport();
 }
 
-void Scene::CreateMeshBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager)
+bool Scene::AddMesh(Mesh mesh, GG::Device* pDevice)
 {
-    for (auto& model : m_Models)
+    mesh.SetParentScene(this);
+    mesh.CreateBuffers(pDevice, m_GeometryPool);
+
+    // An empty mesh never gets a range, only a mesh with geometry can find the pool full
+    if (mesh.GetIndexCount() > 0 && !mesh.GetVertexData().empty() && !mesh.GetGeometryAllocation().IsValid()) return false;
+
+    m_Models.push_back(std::move(mesh));
+    return true;
+}
+
+void Scene::RemoveMesh(size_t meshIndex, GG::DeletionQueue& deletionQueue)
+{
+    if (meshIndex >= m_Models.size()) return;
+
+    // Frames in flight may still read the range, the pool must not hand it out again before they finished
+    deletionQueue.Retire([this, allocation = m_Models[meshIndex].GetGeometryAllocation()] { m_GeometryPool.Free(allocation); });
+    m_Models.erase(m_Models.begin() + static_cast<std::ptrdiff_t>(meshIndex));
+
+    // m_ModelPaths holds one past the index of a file's first mesh, drop the removed mesh's entry and shift the ones behind it
+    const int removedPosition = static_cast<int>(meshIndex) + 1;
+    std::erase_if(m_ModelPaths, [removedPosition](const auto& entry) { return entry.second == removedPosition; });
+    for (auto& [path, position] : m_ModelPaths)
+    {
+        if (position > removedPosition) --position;
+    }
+}
+
+void Scene::UploadMeshesBatched(GG::Device* pDevice)
+{
+    if (m_Models.empty()) return;
+
+    // Pack every mesh's vertices and indices back to back, offsets kept 16 byte aligned
+    auto alignUp = [](VkDeviceSize value) { return (value + 15) & ~VkDeviceSize(15); };
+
+    std::vector<VkDeviceSize> vertexOffsets(m_Models.size());
+    std::vector<VkDeviceSize> indexOffsets(m_Models.size());
+    VkDeviceSize arenaSize = 0;
+
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        vertexOffsets[i] = arenaSize;
+        arenaSize = alignUp(arenaSize + m_Models[i].GetVertexData().size() * m_GeometryPool.GetVertexStride());
+        indexOffsets[i] = arenaSize;
+        arenaSize = alignUp(arenaSize + m_Models[i].GetIndexData().size_bytes());
+    }
+
+    // Usually above the largest staging pool class, then the arena is a buffer of its own that goes away with the upload
+    GG::UploadQueue& uploadQueue = pDevice->GetUploadQueue();
+    const GG::StagingBuffer staging = uploadQueue.AcquireStagingBuffer(arenaSize);
+
+    uint8_t* data = static_cast<uint8_t*>(staging.GetMapped());
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        const auto vertices = m_Models[i].GetVertexData();
+        const auto indices = m_Models[i].GetIndexData();
+        GG::EncodeVertices(m_VertexFormat, vertices, data + vertexOffsets[i]);
+        memcpy(data + indexOffsets[i], indices.data(), indices.size_bytes());
+    }
+
+    VkCommandBuffer commandBuffer = uploadQueue.GetCommandBuffer();
+
+    for (size_t i = 0; i < m_Models.size(); ++i)
     {
-        model.CreateBuffers(pDevice, pBuffer, pCommandManager);
+        m_Models[i].RecordBufferUploads(m_GeometryPool, commandBuffer, staging.Buffer, vertexOffsets[i], indexOffsets[i]);
     }
+
+    // The pool was just created, the whole of both buffers changes hands
+    uploadQueue.ReleaseBuffer(m_GeometryPool.GetVertexBuffer(), 0, VK_WHOLE_SIZE, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    uploadQueue.ReleaseBuffer(m_GeometryPool.GetIndexBuffer(), 0, VK_WHOLE_SIZE, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+
+    const GG::UploadTicket ticket = uploadQueue.GetOpenTicket();
+    for (Mesh& mesh : m_Models)
+    {
+        mesh.SetUploadTicket(ticket);
+    }
+
+    std::cout << "[MeshUpload] Staging arena " << arenaSize / (1024.f * 1024.f) << " MB\n";
 }
 
-void Scene::CreateImages(GG::Buffer* buffer, const GG::CommandManager* commandManager, VkQueue graphicsQueue,
-	VkDevice device, VkPhysicalDevice physicalDevice) const
+void Scene::CreateImages(GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice)
 {
+    using Clock = std::chrono::high_resolution_clock;
+
     for (auto& texture : m_Textures)
-	{
-        texture->CreateImage(buffer, commandManager, graphicsQueue, device, physicalDevice);
-	}
+    {
+        texture->SetBlockCompression(m_IsTextureCompression);
+    }
+
+    const size_t textureCount = m_Textures.size();
+    m_TextureLoadStart = Clock::now();
+    m_TextureDecodeJobs.clear();
+    m_TextureDecodeJobs.resize(textureCount);
+    m_TextureDecodeEnds.assign(textureCount, m_TextureLoadStart);
+    m_IsTextureResident.assign(textureCount, false);
+    m_TextureRecords.assign(textureCount, {});
+    m_ResidentTextureCount = 0;
+    m_TextureSlotCapacity = static_cast<uint32_t>(textureCount) + m_IncrementalTextureReserve;
+
+    // While streaming only the default textures are waited for, everything else samples them until its own upload
+    const size_t upfrontCount = m_IsTextureStreaming ? std::min<size_t>(m_DefaultTextureCount, textureCount) : textureCount;
+    const bool isDecodeOnPool = m_IsParallelTextureDecode || m_IsTextureStreaming;
+
+    if (isDecodeOnPool)
+    {
+        for (size_t i = 0; i < textureCount; ++i)
+        {
+            GG::Texture* pTexture = m_Textures[i].get();
+            Clock::time_point* pDecodeEnd = &m_TextureDecodeEnds[i];
+
+            m_TextureDecodeJobs[i] = m_ThreadPool.Enqueue([pTexture, pDecodeEnd]
+            {
+                pTexture->Decode();
+                *pDecodeEnd = Clock::now();
+            });
+        }
+    }
+
+    // Vulkan work stays on this thread, texture i uploads while the ones after it are still decoding
+    for (uint32_t i = 0; i < upfrontCount; ++i)
+    {
+        if (isDecodeOnPool)
+        {
+            m_TextureDecodeJobs[i].get();
+        }
+        else
+        {
+            m_Textures[i]->Decode();
+            m_TextureDecodeEnds[i] = Clock::now();
+        }
+
+        UploadTexture(i, buffer, uploadQueue, device, physicalDevice);
+        m_IsTextureResident[i] = true;
+        ++m_ResidentTextureCount;
+    }
+    // Uploads batch up while the later textures decode, the first frame binds them so they have to be ready
+    uploadQueue.Wait(uploadQueue.Submit());
+    ++m_TextureResidencyVersion;
+
+    if (upfrontCount == textureCount)
+    {
+        ReportTextureDecode();
+        return;
+    }
+
+    std::cout << "[TextureStreaming] " << textureCount - upfrontCount << " textures decoding in the background, default textures bound after "
+        << MillisecondsSince(m_TextureLoadStart) << " ms\n";
+}
+
+void Scene::StartTextureDecode(uint32_t textureIndex)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    GG::Texture* pTexture = m_Textures[textureIndex].get();
+    pTexture->SetBlockCompression(m_IsTextureCompression);
+
+    // A deque keeps the decode end of the jobs already running in place while it grows
+    Clock::time_point* pDecodeEnd = &m_TextureDecodeEnds.emplace_back(Clock::now());
+    m_IsTextureResident.push_back(false);
+    m_TextureRecords.emplace_back();
+    m_TextureDecodeJobs.push_back(m_ThreadPool.Enqueue([pTexture, pDecodeEnd]
+    {
+        pTexture->Decode();
+        *pDecodeEnd = Clock::now();
+    }));
+}
+
+void Scene::UpdateTextureStreaming(GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice,
+    GG::DeletionQueue& deletionQueue)
+{
+    m_ReadyUploadTicket = uploadQueue.GetReadyTicket();
+
+    // Uploads recorded in earlier frames are bound once their batch is ready
+    bool isChanged = false;
+    bool isNewlyResident = false;
+    for (auto it = m_PendingTextureUploads.begin(); it != m_PendingTextureUploads.end();)
+    {
+        if (!uploadQueue.IsReady(it->Ticket))
+        {
+            ++it;
+            continue;
+        }
+
+        if (it->IsReplacing)
+        {
+            deletionQueue.RetireImage(it->PreviousImage);
+        }
+        else
+        {
+            m_IsTextureResident[it->TextureIndex] = true;
+            ++m_ResidentTextureCount;
+            isNewlyResident = true;
+        }
+        for (const GG::Image& image : it->DiscardedImages)
+        {
+            deletionQueue.RetireImage(image);
+        }
+        it = m_PendingTextureUploads.erase(it);
+        isChanged = true;
+    }
+
+    if (isNewlyResident && m_ResidentTextureCount == m_Textures.size())
+    {
+        std::cout << "[TextureStreaming] all " << m_ResidentTextureCount << " textures resident after " << MillisecondsSince(m_TextureLoadStart) << " ms\n";
+        ReportTextureDecode();
+    }
+
+    if (m_ResidentTextureCount < m_IsTextureResident.size())
+    {
+        uint32_t uploadCount = 0;
+        for (uint32_t i = 0; i < m_Textures.size() && uploadCount < m_MaxTextureUploadsPerFrame; ++i)
+        {
+            // The decode job is no longer valid once its upload is recorded
+            if (m_IsTextureResident[i] || !m_TextureDecodeJobs[i].valid()
+                || m_TextureDecodeJobs[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+
+            m_TextureDecodeJobs[i].get();
+            UploadTexture(i, buffer, uploadQueue, device, physicalDevice);
+            m_PendingTextureUploads.push_back({ i, uploadQueue.GetOpenTicket() });
+            ++uploadCount;
+        }
+    }
+
+    if (IsTextureResidencyEnabled())
+    {
+        RequestTextureMips();
+        for (const GG::TextureResidencyChange& change : m_TextureResidency.Update(m_MaxTextureUploadsPerFrame))
+        {
+            GG::Texture& texture = *m_Textures[change.TextureIndex];
+            auto pending = std::find_if(m_PendingTextureUploads.begin(), m_PendingTextureUploads.end(),
+                [&change](const PendingTextureUpload& upload) { return upload.TextureIndex == change.TextureIndex; });
+            if (pending == m_PendingTextureUploads.end())
+            {
+                m_PendingTextureUploads.push_back({ change.TextureIndex, 0, true, texture.GetGGImage(), texture.GetImageView() });
+                pending = std::prev(m_PendingTextureUploads.end());
+            }
+            else
+            {
+                pending->DiscardedImages.push_back(texture.GetGGImage());
+            }
+
+            texture.CreateImage(buffer, uploadQueue, device, physicalDevice, change.FirstMip);
+            pending->Ticket = uploadQueue.GetOpenTicket();
+        }
+    }
+
+    if (isChanged)
+    {
+        ++m_TextureResidencyVersion;
+    }
+}
+
+void Scene::RequestTextureMips()
+{
+    const glm::mat4 projection = m_Camera.GetProjectionMatrix();
+    const glm::vec3 cameraPosition = m_Camera.GetPosition();
+    const float pixelsPerUnit = static_cast<float>(m_ViewportHeight) * 0.5f * std::abs(projection[1][1]);
+
+    for (const auto& mesh : m_Models)
+    {
+        if (mesh.GetVisibleRanges().empty()) continue;
+
+        const glm::mat4 modelMatrix = mesh.GetModelMatrix();
+        const glm::vec4& sphere = mesh.GetBoundingSphere();
+        const float maxScale = GetMaxScale(modelMatrix);
+        const float distance = sphere.w > 0.f ? GetSphereDistance(sphere, modelMatrix, maxScale, cameraPosition) : 0.1f;
+
+        // UV units one screen pixel covers at the closest point of the mesh, meshes without UV density get every mip
+        const float uvPerPixel = mesh.GetUvDensity() * distance / (maxScale * pixelsPerUnit);
+
+        const Mesh::PBRMaterialIndices& materialIndices = mesh.GetMaterialIndices();
+        for (uint32_t textureIndex : { materialIndices.albedoTexIdx, materialIndices.normalTexIdx, materialIndices.metallicRoughnessTexIdx, materialIndices.aoTexIdx })
+        {
+            if (!m_TextureResidency.IsManaged(textureIndex)) continue;
+
+            const GG::Texture& texture = *m_Textures[textureIndex];
+            const float texelsPerPixel = uvPerPixel * static_cast<float>(std::max(texture.GetWidth(), texture.GetHeight()));
+            const uint32_t mip = texelsPerPixel > 1.f ? static_cast<uint32_t>(std::log2(texelsPerPixel)) : 0;
+            m_TextureResidency.RequestMip(textureIndex, mip);
+        }
+    }
+}
+
+void Scene::UploadTexture(uint32_t textureIndex, GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice)
+{
+    GG::Texture& texture = *m_Textures[textureIndex];
+    const std::vector<uint64_t> levelSizes = texture.GetLevelSizes();
+    uint32_t firstMip = 0;
+
+    // The default textures are shared placeholders and always stay whole
+    if (IsTextureResidencyEnabled() && textureIndex >= m_DefaultTextureCount)
+    {
+        texture.SetLevelRetention(true);
+        firstMip = m_TextureResidency.AddTexture(textureIndex, levelSizes);
+    }
+
+    const auto uploadStart = std::chrono::high_resolution_clock::now();
+    texture.CreateImage(buffer, uploadQueue, device, physicalDevice, firstMip);
+
+    GG::TextureRecord& record = m_TextureRecords[textureIndex];
+    record.UploadMs = MillisecondsSince(uploadStart);
+    record.Width = texture.GetWidth();
+    record.Height = texture.GetHeight();
+    record.MipLevels = static_cast<uint32_t>(levelSizes.size());
+    record.FirstMip = firstMip;
+    for (size_t level = 0; level < levelSizes.size(); ++level)
+    {
+        record.DecodedBytes += levelSizes[level];
+        if (level >= firstMip) record.UploadedBytes += levelSizes[level];
+    }
+}
+
+uint32_t Scene::GetPlaceholderTexture(uint32_t textureIndex) const
+{
+    return GetPlaceholderTexture(m_Textures[textureIndex]->GetUsage());
+}
+
+uint32_t Scene::GetPlaceholderTexture(GG::TextureUsage usage)
+{
+    switch (usage)
+    {
+    case GG::TextureUsage::NormalMap:
+        return 1;
+    case GG::TextureUsage::MetallicRoughness:
+        return 2;
+    case GG::TextureUsage::Occlusion:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+void Scene::ReportTextureDecode()
+{
+    float decodeSumMs = 0.f;
+    uint32_t decodedCount = 0;
+    std::chrono::high_resolution_clock::time_point lastDecodeEnd = m_TextureLoadStart;
+
+    for (size_t i = 0; i < m_Textures.size(); ++i)
+    {
+        if (!m_Textures[i]->IsUsingPath()) continue;
+
+        std::cout << "[TextureDecode] " << m_Textures[i]->GetTexturePath() << ": " << m_Textures[i]->GetDecodeTime() << " ms ("
+            << GG::GetCompressedFormatName(m_Textures[i]->GetCompressedFormat()) << (m_Textures[i]->IsCacheHit() ? ", from cache" : "") << ")\n";
+        decodeSumMs += m_Textures[i]->GetDecodeTime();
+        lastDecodeEnd = std::max(lastDecodeEnd, m_TextureDecodeEnds[i]);
+        ++decodedCount;
+    }
+
+    const float decodeWallMs = std::chrono::duration<float, std::milli>(lastDecodeEnd - m_TextureLoadStart).count();
+    const float totalMs = MillisecondsSince(m_TextureLoadStart);
+    const bool isDecodeOnPool = m_IsParallelTextureDecode || m_IsTextureStreaming;
+
+    std::cout << "[TextureDecode] " << decodedCount << " textures, "
+        << (isDecodeOnPool ? std::to_string(m_ThreadPool.GetThreadCount()) + " worker threads" : std::string("serial"))
+        << ": decode " << decodeSumMs << " ms summed, " << decodeWallMs << " ms wall clock ("
+        << decodeSumMs / std::max(decodeWallMs, 0.001f) << "x vs serial decode), " << totalMs << " ms including upload, "
+        << GG::GetMipFilterInstructionSet() << " mip filters, " << GG::GetHalfFloatInstructionSet() << " half float conversion\n";
+
+    std::vector<std::string> textureKeys(m_Textures.size());
+    for (const auto& [key, idx] : m_TexturePaths)
+    {
+        if (idx < textureKeys.size()) textureKeys[idx] = key;
+    }
+
+    GG::TextureLoadRecord textureLoad;
+    textureLoad.ThreadCount = isDecodeOnPool ? m_ThreadPool.GetThreadCount() : 0;
+    textureLoad.DecodeSumMs = decodeSumMs;
+    textureLoad.DecodeWallMs = decodeWallMs;
+    textureLoad.TotalMs = totalMs;
+    textureLoad.Textures.reserve(m_Textures.size());
+    for (size_t i = 0; i < m_Textures.size(); ++i)
+    {
+        const GG::Texture& texture = *m_Textures[i];
+        GG::TextureRecord& record = textureLoad.Textures.emplace_back(m_TextureRecords[i]);
+        record.Key = textureKeys[i];
+        record.Format = GG::GetCompressedFormatName(texture.GetCompressedFormat());
+        record.IsCacheHit = texture.IsCacheHit();
+        record.SourceBytes = texture.IsUsingPath() ? GetFileSize(texture.GetTexturePath()) : 0;
+        record.DecodeMs = texture.GetDecodeTime();
+        record.MipGenerationMs = texture.GetMipGenerationTime();
+        record.CompressMs = texture.GetCompressTime();
+    }
+    m_ImportReport.SetTextureLoad(std::move(textureLoad));
+    WriteImportReport();
+}
+
+void Scene::WriteImportReport() const
+{
+    if (m_ImportReportPath.empty()) return;
+
+    if (!m_ImportReport.Write(m_ImportReportPath))
+    {
+        std::cerr << "WARNING: failed to write the import report to " << m_ImportReportPath << "\n";
+    }
 }
 
 std::vector<VkImageView> Scene::GetImageViews() const
@@ -404,22 +1580,76 @@ std::vector<VkImageView> Scene::GetImageViews() const
     std::vector<VkImageView> imageViews;
 	imageViews.reserve(m_Textures.size());
 
-    for (const auto& texture : m_Textures)
+    for (uint32_t i = 0; i < m_Textures.size(); ++i)
     {
-	    imageViews.emplace_back(texture->GetImageView());
+        const bool isResident = i < m_IsTextureResident.size() && m_IsTextureResident[i];
+	    imageViews.emplace_back(m_Textures[isResident ? i : GetPlaceholderTexture(i)]->GetImageView());
 	}
 
+    // A residency change keeps showing the image it replaces until the new one is ready
+    for (const PendingTextureUpload& upload : m_PendingTextureUploads)
+    {
+        if (upload.IsReplacing) imageViews[upload.TextureIndex] = upload.PreviousView;
+    }
+
     return imageViews;
 }
 
 void Scene::Destroy(const VkDevice& device) const
 {
-	for (auto& model : m_Models)
-	{
-		model.Destroy(device);
-	}
-	for (const auto& texture : m_Textures)
+    m_GeometryPool.Destroy();
+
+    // Textures still decoding have no image yet, ones still uploading have one but are not resident
+	for (size_t i = 0; i < m_IsTextureResident.size(); ++i)
 	{
-        texture->DestroyTexture(device);
+        if (m_IsTextureResident[i]) m_Textures[i]->DestroyTexture(device);
 	}
+    for (const PendingTextureUpload& upload : m_PendingTextureUploads)
+    {
+        if (upload.IsReplacing) upload.PreviousImage.DestroyImg(device);
+        else m_Textures[upload.TextureIndex]->DestroyTexture(device);
+
+        for (const GG::Image& image : upload.DiscardedImages)
+        {
+            image.DestroyImg(device);
+        }
+    }
+}
+
+void Scene::BuildTextureCaches()
+{
+    const auto buildStart = std::chrono::high_resolution_clock::now();
+
+    // In memory textures have nothing to cache
+    std::vector<GG::Texture*> textures;
+    std::vector<std::future<void>> jobs;
+    for (auto& texture : m_Textures)
+    {
+        if (!texture->IsUsingPath()) continue;
+
+        GG::Texture* pTexture = texture.get();
+        pTexture->SetBlockCompression(m_IsTextureCompression);
+        textures.push_back(pTexture);
+
+        jobs.emplace_back(m_ThreadPool.Enqueue([pTexture]
+        {
+            pTexture->Decode();
+            pTexture->ReleaseDecodedPixels();
+        }));
+    }
+
+    uint32_t builtCount = 0;
+    uint32_t cachedCount = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        jobs[i].get();
+
+        const GG::Texture& texture = *textures[i];
+        ++(texture.IsCacheHit() ? cachedCount : builtCount);
+        std::cout << "[TextureCache] " << texture.GetTexturePath() << ": " << GG::GetCompressedFormatName(texture.GetCompressedFormat())
+            << (texture.IsCacheHit() ? " up to date" : " built") << " in " << texture.GetDecodeTime() << " ms\n";
+    }
+
+    std::cout << "[TextureCache] " << builtCount << " built, " << cachedCount << " up to date, " << m_ThreadPool.GetThreadCount()
+        << " worker threads, " << GG::GetMipFilterInstructionSet() << " mip filters, " << MillisecondsSince(buildStart) << " ms\n";
 }
@@ -1,17 +1,26 @@
 #pragma once
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
 
 #include "GGCamera.h"
+#include "GGImportReport.h"
+#include "GGMeshCache.h"
 #include "GGTexture.h"
+#include "GGTextureResidency.h"
+#include "GGThreadPool.h"
 #include "Model.h"
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
 
 namespace GG
 {
-	class CommandManager;
+	class UploadQueue;
 	class Buffer;
 	class Device;
+	class DeletionQueue;
 }
 
 struct alignas(16) DirectionalLight {
@@ -53,33 +62,133 @@ public:
 
 	void Initialize(GLFWwindow* window);
 	void AddFileToScene(const std::string& filePath);
+	// Imports the files concurrently on the thread pool, the scene ends up the same as adding them one by one in order
 	void AddFilesToScene(const std::initializer_list<const std::string>& filePath);
+
+	struct LoadProgress
+	{
+		uint32_t FileCount = 0;
+		uint32_t ImportedFileCount = 0;   // Imported on the thread pool and merged into the scene
+		uint32_t MeshCount = 0;           // Of the imported files
+		uint32_t AddedMeshCount = 0;      // Uploaded and drawable
+		float Fraction = 0.f;             // Import and mesh uploads count half of every file each
+		float ElapsedMs = 0.f;
+		float EtaMs = 0.f;                // Extrapolated from the elapsed time and Fraction
+		bool IsDone = false;
+	};
+	using LoadProgressCallback = std::function<void(const LoadProgress&)>;
+
+	// Imports the files on the thread pool while frames keep rendering, UpdateIncrementalLoad adds them in the given order.
+	// The callback replaces the one of a load still running and is called from UpdateIncrementalLoad whenever progress was made
+	void AddFilesToSceneIncremental(const std::initializer_list<const std::string>& filePaths, LoadProgressCallback progressCallback = {});
+	// Called once per frame after the renderer set the scene up. Adds finished imports' meshes for about timeSliceMs
+	// and starts their texture decodes, the textures then stream in like the rest
+	void UpdateIncrementalLoad(GG::Device* pDevice, float timeSliceMs);
+	bool IsIncrementalLoadPending() const { return !m_PendingLoads.empty(); }
+	// Geometry pool room added when CreateMeshBuffers runs with a load pending, and texture slots the descriptor array keeps free.
+	// A load started after CreateMeshBuffers only gets the pool's headroom. Meshes that do not fit are skipped with a warning
+	// and textures past the slots use a default texture
+	void SetIncrementalLoadReserve(uint32_t vertexCount, uint32_t indexCount, uint32_t textureCount)
+	{
+		m_IncrementalVertexReserve = vertexCount;
+		m_IncrementalIndexReserve = indexCount;
+		m_IncrementalTextureReserve = textureCount;
+	}
 	void AddLight(PointLight lightToAdd);
 	void AddLight(DirectionalLight lightToAdd);
 	void BindTextureToMesh(const std::string& modelFilePath, const std::string& textureFilePath, VkFormat imgFormat);
-	void ProcessNode(const aiNode* node, const aiScene* scene, const std::string& modelDirectory);
-	Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& modelDirectory);
 
 	void Update();
 
-	void CreateMeshBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer, const GG::CommandManager* pCommandManager);
-	void CreateImages(GG::Buffer* buffer, const GG::CommandManager* commandManager, VkQueue graphicsQueue, VkDevice device, VkPhysicalDevice physicalDevice) const;
+	// Both wait for their uploads, everything they create is usable by the first frame
+	void CreateMeshBuffers(GG::Device* pDevice, const GG::Buffer* pBuffer);
+	void CreateImages(GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice);
+	// Off decodes every texture on the main thread, used as the baseline for the decode speedup report
+	void SetParallelTextureDecode(bool isParallel) { m_IsParallelTextureDecode = isParallel; }
+	// Off uploads every mesh with its own staging buffers and submits, as before the batched upload
+	void SetBatchedMeshUpload(bool isBatched) { m_IsBatchedMeshUpload = isBatched; }
+	// Off uploads every texture as 8 bit RGBA, also turned off when the device lacks textureCompressionBC
+	void SetTextureCompression(bool isEnabled) { m_IsTextureCompression = isEnabled; }
+	// Off leaves vertex welding to Assimp's JoinIdenticalVertices, read by every following AddFileToScene call
+	void SetVertexDeduplication(bool isEnabled) { m_IsVertexDeduplication = isEnabled; }
+	// Off decodes and uploads every texture in CreateImages. On only the default textures are loaded there, the rest decode
+	// on the thread pool and their slots show the matching default texture until UpdateTextureStreaming uploaded them
+	void SetTextureStreaming(bool isEnabled) { m_IsTextureStreaming = isEnabled; }
+	// Records uploads of up to m_MaxTextureUploadsPerFrame textures whose background decode finished, called once per frame after
+	// the upload queue's Update. A texture is only bound once its upload is ready, until then its slot keeps showing the
+	// placeholder or the image a residency change replaces, which then goes to the deletion queue
+	void UpdateTextureStreaming(GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice,
+		GG::DeletionQueue& deletionQueue);
+	// Meshes with a later upload ticket are not drawn yet, updated by UpdateTextureStreaming
+	GG::UploadTicket GetReadyUploadTicket() const { return m_ReadyUploadTicket; }
+	// Changes whenever GetImageViews would return something else, descriptor sets written with an older value are stale
+	uint64_t GetTextureResidencyVersion() const { return m_TextureResidencyVersion; }
+	uint32_t GetResidentTextureCount() const { return m_ResidentTextureCount; }
+	// 0 keeps every mip of every texture resident. Otherwise scene textures start at their 64x64 tail and finer mips stream in
+	// as the meshes using them need them, least recently needed textures are evicted to stay within this many bytes
+	void SetTextureMemoryBudget(uint64_t budgetBytes) { m_TextureMemoryBudget = budgetBytes; m_TextureResidency.SetBudget(budgetBytes); }
+	bool IsTextureResidencyEnabled() const { return m_TextureMemoryBudget > 0; }
+	const GG::TextureResidencyStats& GetTextureResidencyStats() const { return m_TextureResidency.GetStats(); }
+	// Transcodes every path based texture into its cache file without touching Vulkan, for GPU-less build machines
+	void BuildTextureCaches();
+	// GPU vertex layout, has to be set before the pipelines and mesh buffers are created
+	void SetVertexFormat(GG::VertexFormat format) { m_VertexFormat = format; }
+	GG::VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+	// JSON file with the per phase timings and sizes of every import, mesh upload and texture load. Rewritten whenever a part
+	// finishes: after CreateMeshBuffers, once every texture is resident and once an incremental load is done. Empty turns it off
+	void SetImportReportPath(const std::string& path) { m_ImportReportPath = path; }
+	// Off draws every mesh whole, as before the meshlet culling
+	void SetClusterCulling(bool isEnabled) { m_IsClusterCulling = isEnabled; }
+	bool IsClusterCullingEnabled() const { return m_IsClusterCulling; }
+	// Off draws every mesh at LOD 0
+	void SetLodSelection(bool isEnabled) { m_IsLodSelection = isEnabled; }
+	// Largest on screen error in pixels a LOD may have to be picked over the next finer one
+	void SetLodErrorThreshold(float pixels) { m_LodErrorThreshold = pixels; }
+	// Height of the render target the camera projects to, used to turn LOD errors into pixels
+	void SetViewportHeight(uint32_t height) { m_ViewportHeight = height; }
+
+	struct VisibilityStats
+	{
+		uint32_t TotalMeshlets = 0;
+		uint32_t VisibleMeshlets = 0;
+		uint64_t TotalTriangles = 0;     // At LOD 0
+		uint64_t VisibleTriangles = 0;   // At the selected LODs
+		uint32_t DrawCount = 0;
+		uint32_t ReducedLodMeshes = 0;
+	};
+	const VisibilityStats& GetVisibilityStats() const { return m_VisibilityStats; }
 
 	std::vector<Mesh>& GetMeshes(){return m_Models;}
+	const GG::GeometryPool& GetGeometryPool() const { return m_GeometryPool; }
+
+	// Runtime add/remove through the geometry pool, a removed mesh's range is only reused once the frames in flight drew it
+	// Returns false and drops the mesh when the pool has no room for it
+	bool AddMesh(Mesh mesh, GG::Device* pDevice);
+	// Meshes behind the removed one move down an index, BindTextureToMesh no longer finds a file whose first mesh was removed
+	void RemoveMesh(size_t meshIndex, GG::DeletionQueue& deletionQueue);
 	std::vector<PointLight>& GetPointLights() { return m_PointLights; }
 	std::vector<DirectionalLight>& GetDirectionalLights() { return m_DirectionalLights; }
 
 	const std::vector<std::unique_ptr<GG::Texture>>& GetTextures() const { return m_Textures; }
 
 	uint32_t GetOrLoadTexture(const std::string& texturePath,const aiScene* scene,const std::string& modelDirectory,
-		std::vector<std::unique_ptr<GG::Texture>>& textures,std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat);
+		std::vector<std::unique_ptr<GG::Texture>>& textures,std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat) const;
+
+	uint32_t GetOrLoadTextureFromFile(const std::string& fullTexturePath, std::vector<std::unique_ptr<GG::Texture>>& textures,
+		std::unordered_map<std::string, uint32_t>& texturePaths, VkFormat imgFormat) const;
 
 	uint32_t GetOrLoadTextureFromMemory(const aiTexture* aiTex,std::vector<std::unique_ptr<GG::Texture>>& textures,
-		std::unordered_map<std::string, uint32_t>& texturePaths,const std::string& fallbackKey, VkFormat imgFormat);
+		std::unordered_map<std::string, uint32_t>& texturePaths,const std::string& fallbackKey, VkFormat imgFormat) const;
+
+	// width/height follow aiTexture: height 0 means data holds width bytes of a compressed image, otherwise width * height aiTexels
+	uint32_t GetOrLoadTextureFromMemory(const uint8_t* data, uint32_t width, uint32_t height, std::vector<std::unique_ptr<GG::Texture>>& textures,
+		std::unordered_map<std::string, uint32_t>& texturePaths, const std::string& fallbackKey, VkFormat imgFormat) const;
 
 	std::vector<VkImageView> GetImageViews() const;
 
 	uint32_t GetTextureCount() const { return static_cast<uint32_t>(m_Textures.size()); }
+	// Size of the texture descriptor array, fixed once CreateImages ran
+	uint32_t GetTextureSlotCapacity() const { return std::max(m_TextureSlotCapacity, GetTextureCount()); }
 
 	GG::Camera& GetCamera() { return m_Camera; }
 
@@ -87,6 +196,68 @@ public:
 	glm::mat4 GetSceneMatrix() const { return m_SceneMatrix; }
 
 private:
+	// One file's meshes and textures, built without touching the scene so files can import on worker threads.
+	// Texture indices below m_DefaultTextureCount are the scene's default textures, those slots of Textures stay empty.
+	struct ImportedFile
+	{
+		std::string FilePath;
+		std::vector<Mesh> Models;
+		std::vector<std::unique_ptr<GG::Texture>> Textures;
+		std::unordered_map<std::string, uint32_t> TexturePaths;
+		std::unique_ptr<GG::MeshCache> MeshCache;   // Set after a warm load, the meshes point into its mapping
+		float LoadMs = 0.f;
+		GG::FileImportRecord Record;
+	};
+
+	ImportedFile ImportFile(const std::string& filePath) const;
+	// Counts what the import produced into its record
+	static void FinishImportRecord(ImportedFile& imported, std::chrono::high_resolution_clock::time_point loadStart);
+	void WriteImportReport() const;
+	// Appends an import the way a serial load would have, textures the scene already has are shared
+	void MergeImport(ImportedFile imported);
+	// Moves the import's new textures into the scene, returns the scene texture index of every import texture index
+	std::vector<uint32_t> MergeImportTextures(ImportedFile& imported);
+	static void RemapMaterialIndices(Mesh& mesh, const std::vector<uint32_t>& sceneIndices);
+	void ProcessNode(const aiNode* node, const aiScene* scene, const std::string& modelDirectory, ImportedFile& imported) const;
+	Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& modelDirectory, ImportedFile& imported) const;
+
+	static void SetTextureUsage(std::vector<std::unique_ptr<GG::Texture>>& textures, uint32_t textureIndex, GG::TextureUsage usage);
+	// Default slot a texture's descriptor points at while it is not resident
+	uint32_t GetPlaceholderTexture(uint32_t textureIndex) const;
+	static uint32_t GetPlaceholderTexture(GG::TextureUsage usage);
+	// Decodes a texture added after CreateImages on the thread pool, UpdateTextureStreaming uploads it
+	void StartTextureDecode(uint32_t textureIndex);
+	void UploadTexture(uint32_t textureIndex, GG::Buffer* buffer, GG::UploadQueue& uploadQueue, VkDevice device, VkPhysicalDevice physicalDevice);
+	// Prints the decode summary and updates the texture part of the import report
+	void ReportTextureDecode();
+	// Asks the residency manager for the mip every visible mesh needs, from its distance and UV density
+	void RequestTextureMips();
+	void UploadMeshesBatched(GG::Device* pDevice);
+	void AddCachedMeshes(const GG::MeshCache& meshCache, ImportedFile& imported) const;
+	void WriteMeshCache(GG::MeshCache& meshCache, const aiScene* scene, const ImportedFile& imported, float coldLoadMs) const;
+	// Merges vertices that match in every attribute, so normal and tangent seams stay split
+	static void DeduplicateVertices(Mesh& mesh, const std::string& meshName);
+	// Vertex cache, overdraw and vertex fetch reordering of a freshly imported triangle mesh
+	static void OptimizeMesh(Mesh& mesh, const std::string& meshName);
+	static void BuildMeshlets(Mesh& mesh, const std::string& meshName);
+	// Appends simplified index buffers behind LOD 0, needs the meshlets built first since they only cover LOD 0
+	static void BuildLods(Mesh& mesh, const std::string& meshName);
+	// Picks every mesh's LOD and fills its index ranges for this frame, culling LOD 0 per meshlet and coarser LODs per mesh
+	void UpdateVisibility();
+	uint32_t SelectLod(const Mesh& mesh, const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, float pixelsPerUnit) const;
+
+	static constexpr uint32_t m_MaxLodCount = 4;
+	// Meshes below this many triangles are not worth a LOD chain
+	static constexpr uint32_t m_MinLodTriangles = 256;
+	// A level aims for this fraction of the previous level's triangles, chains stop once a level fails to get below m_MinLodReduction
+	static constexpr float m_LodTriangleRatio = 0.5f;
+	static constexpr float m_MinLodReduction = 0.85f;
+	// Largest collapse error per level, relative to the mesh bounding radius
+	static constexpr float m_MaxLodRelativeError = 0.05f;
+
+	// Texture slots 0-3 are the fallback albedo, normal, metallic roughness and AO maps created in the constructor
+	static constexpr uint32_t m_DefaultTextureCount = 4;
+
 	std::unordered_map<std::string, int> m_ModelPaths;
 	GG::Camera m_Camera;
 	std::vector<Mesh> m_Models;
@@ -95,4 +266,75 @@ private:
 	std::vector<std::unique_ptr<GG::Texture>> m_Textures;
 	glm::mat4 m_SceneMatrix { glm::rotate(glm::mat4(1.0f), glm::radians(0.f), glm::vec3(0.0f, 0.0f, 1.0f)) };
 	std::unordered_map<std::string, uint32_t> m_TexturePaths;
+	std::vector<std::unique_ptr<GG::MeshCache>> m_MeshCaches;
+
+	GG::GeometryPool m_GeometryPool;
+	// Extra pool capacity on top of the loaded meshes, for meshes added at runtime
+	static constexpr float m_GeometryPoolHeadroom = 0.25f;
+
+	// Workers write into these, so they are declared before the pool and outlive it
+	std::vector<std::future<void>> m_TextureDecodeJobs;
+	std::deque<std::chrono::high_resolution_clock::time_point> m_TextureDecodeEnds;
+	std::vector<bool> m_IsTextureResident;
+	// Upload side of the import report, the decode side is read from the textures
+	std::vector<GG::TextureRecord> m_TextureRecords;
+	uint32_t m_ResidentTextureCount = 0;
+	uint64_t m_TextureResidencyVersion = 0;
+	std::chrono::high_resolution_clock::time_point m_TextureLoadStart;
+	// Bounds the staging memory and decode to upload latency one frame adds, the copies themselves no longer stall the frame
+	static constexpr uint32_t m_MaxTextureUploadsPerFrame = 4;
+
+	// A recorded texture upload whose batch is not ready yet
+	struct PendingTextureUpload
+	{
+		uint32_t TextureIndex;
+		GG::UploadTicket Ticket;
+		// Set for a residency change, the slot shows the previous image until the new one is ready
+		bool IsReplacing = false;
+		GG::Image PreviousImage;
+		VkImageView PreviousView = VK_NULL_HANDLE;
+		// Images of earlier changes that were never bound, their transfers may still run until Ticket is ready
+		std::vector<GG::Image> DiscardedImages;
+	};
+	std::vector<PendingTextureUpload> m_PendingTextureUploads;
+	GG::UploadTicket m_ReadyUploadTicket = 0;
+
+	uint64_t m_TextureMemoryBudget = 256ull * 1024 * 1024;
+	GG::TextureResidency m_TextureResidency{ m_TextureMemoryBudget };
+
+	// One queued file of an incremental load, its meshes are added a few per frame once the import finished
+	struct PendingLoad
+	{
+		std::future<ImportedFile> Import;
+		ImportedFile Imported;
+		std::vector<uint32_t> TextureIndices;   // Import texture index to scene texture index
+		size_t NextMesh = 0;
+		bool IsMerged = false;
+	};
+	std::deque<PendingLoad> m_PendingLoads;
+	LoadProgressCallback m_LoadProgressCallback;
+	LoadProgress m_LoadProgress;
+	std::chrono::high_resolution_clock::time_point m_IncrementalLoadStart;
+	uint32_t m_IncrementalLoadFrames = 0;
+	float m_LongestLoadSliceMs = 0.f;
+	uint32_t m_IncrementalVertexReserve = 2 * 1024 * 1024;
+	uint32_t m_IncrementalIndexReserve = 6 * 1024 * 1024;
+	uint32_t m_IncrementalTextureReserve = 256;
+	uint32_t m_TextureSlotCapacity = 0;
+
+	GG::ImportReport m_ImportReport;
+	std::string m_ImportReportPath = "import_report.json";
+
+	GG::ThreadPool m_ThreadPool;
+	bool m_IsParallelTextureDecode = true;
+	bool m_IsTextureStreaming = true;
+	bool m_IsBatchedMeshUpload = true;
+	bool m_IsTextureCompression = true;
+	bool m_IsVertexDeduplication = true;
+	GG::VertexFormat m_VertexFormat = GG::VertexFormat::Compact;
+	bool m_IsClusterCulling = true;
+	bool m_IsLodSelection = true;
+	float m_LodErrorThreshold = 1.f;
+	uint32_t m_ViewportHeight = 800;
+	VisibilityStats m_VisibilityStats;
 };
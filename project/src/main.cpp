@@ -1,10 +1,11 @@
 #define STB_IMAGE_IMPLEMENTATION
+#include <cstring>
 #include <iostream>
 #include "GGVulkan.h"
 #include "Scene.h"
 #include "Time.h"
 
-int main()
+int main(int argc, char** argv)
 {
 	GGVulkan app;
 
@@ -23,6 +24,31 @@ int main()
 		//newScene->BindTextureToMesh("resources/models/viking_room.obj", "resources/textures/viking_room.png", VK_FORMAT_B8G8R8A8_SRGB);
 		//newScene->AddFileToScene("resources/models/tralalero_tralala.glb");
 		//newScene->AddFileToScene("resources/models/porsche.glb");
+		// Streams the model in after the first frame instead of blocking startup on it
+		//newScene->AddFilesToSceneIncremental({ "resources/models/porsche.glb" }, [](const Scene::LoadProgress& progress)
+		//	{ std::cout << "[Loading] " << progress.Fraction * 100.f << "%, " << progress.EtaMs << " ms left\n"; });
+		// Transcodes the scene textures into their .ggtex caches and exits, needs no GPU
+		if (argc > 1 && std::strcmp(argv[1], "--build-texture-cache") == 0)
+		{
+			newScene->BuildTextureCaches();
+			delete newScene;
+			return EXIT_SUCCESS;
+		}
+
+		for (int i = 1; i < argc; ++i)
+		{
+			// Times thousands of small mesh uploads with and without the staging pool before the first frame
+			if (std::strcmp(argv[i], "--benchmark-staging") == 0)
+			{
+				app.SetStagingBenchmark(true);
+			}
+			// Prints frame time, visibility, texture residency and device memory stats every few seconds
+			else if (std::strcmp(argv[i], "--report-stats") == 0)
+			{
+				app.SetStatsReport(true);
+			}
+		}
+
 		app.AddScene(newScene);
 
 		app.Run();
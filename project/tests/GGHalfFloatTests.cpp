@@ -0,0 +1,165 @@
+#include "GGTest.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "GGHalfFloat.h"
+
+namespace
+{
+	float FromBits(uint32_t bits)
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// The batch conversion has to match the scalar one bit for bit, count values starting at source
+	void CheckBatchMatchesScalar(const float* source, size_t count)
+	{
+		std::vector<uint16_t> halves(count);
+		GG::FloatToHalf(source, halves.data(), count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (halves[i] == GG::FloatToHalf(source[i])) continue;
+
+			uint32_t bits;
+			memcpy(&bits, &source[i], sizeof(bits));
+			GGTest::ReportFailure(__FILE__, __LINE__, "batch differs from scalar for float bits " + std::to_string(bits));
+		}
+	}
+}
+
+GG_TEST(HalfFloatScalarValues, Unit)
+{
+	GG_CHECK(GG::FloatToHalf(0.f) == 0x0000);
+	GG_CHECK(GG::FloatToHalf(-0.f) == 0x8000);
+	GG_CHECK(GG::FloatToHalf(1.f) == 0x3C00);
+	GG_CHECK(GG::FloatToHalf(-2.f) == 0xC000);
+	GG_CHECK(GG::FloatToHalf(0.1f) == 0x2E66);
+	GG_CHECK(GG::FloatToHalf(65504.f) == 0x7BFF);
+
+	// 65520 is halfway between the largest half and the next power of two, it rounds up to infinity
+	GG_CHECK(GG::FloatToHalf(65519.f) == 0x7BFF);
+	GG_CHECK(GG::FloatToHalf(65520.f) == 0x7C00);
+	GG_CHECK(GG::FloatToHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+	GG_CHECK(GG::FloatToHalf(-std::numeric_limits<float>::infinity()) == 0xFC00);
+	GG_CHECK(GG::FloatToHalf(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+	GG_CHECK(GG::FloatToHalf(FromBits(0xFF800001)) == 0xFE00);
+
+	// Round to nearest even: 1 + 2^-11 is a tie and stays at 1, 1 + 3 * 2^-11 rounds up to the even 1 + 2^-9
+	GG_CHECK(GG::FloatToHalf(1.f + 1.f / 2048.f) == 0x3C00);
+	GG_CHECK(GG::FloatToHalf(1.f + 3.f / 2048.f) == 0x3C02);
+
+	// Smallest normal and denormals, 2^-25 is a tie between zero and the smallest denormal and rounds to zero
+	GG_CHECK(GG::FloatToHalf(std::ldexp(1.f, -14)) == 0x0400);
+	GG_CHECK(GG::FloatToHalf(std::ldexp(1.f, -24)) == 0x0001);
+	GG_CHECK(GG::FloatToHalf(std::ldexp(1.f, -25)) == 0x0000);
+	GG_CHECK(GG::FloatToHalf(std::ldexp(1.5f, -25)) == 0x0001);
+	GG_CHECK(GG::FloatToHalf(std::ldexp(3.f, -25)) == 0x0002);
+	GG_CHECK(GG::FloatToHalf(-std::ldexp(1023.f, -24)) == 0x83FF);
+}
+
+GG_TEST(HalfFloatBatchMatchesScalar, Unit)
+{
+	std::cout << "  half float batch path: " << GG::GetHalfFloatInstructionSet() << "\n";
+
+	// Every boundary of the scalar conversion and a few values on each side of it
+	std::vector<float> values;
+	for (const uint32_t boundary : { 0x00000000u, 0x33000000u, 0x38800000u, 0x3F800000u, 0x477FE000u, 0x477FF000u, 0x7F800000u, 0x7FC00000u })
+	{
+		for (uint32_t offset = 0; offset < 16; ++offset)
+		{
+			values.push_back(FromBits(boundary + offset));
+			values.push_back(FromBits((boundary - offset) | 0x80000000u));
+		}
+	}
+
+	std::mt19937 random(42);
+	for (uint32_t i = 0; i < 4096; ++i)
+	{
+		values.push_back(FromBits(static_cast<uint32_t>(random())));
+	}
+
+	CheckBatchMatchesScalar(values.data(), values.size());
+
+	// Every length and start alignment, so the vector loop and the scalar tail both get every split
+	for (size_t start = 0; start < 8; ++start)
+	{
+		for (size_t count = 0; count <= 40; ++count)
+		{
+			CheckBatchMatchesScalar(values.data() + start, count);
+		}
+	}
+}
+
+GG_TEST(HalfFloatAllBitPatterns, Exhaustive)
+{
+	// All 2^32 float bit patterns through the batch path, in chunks that stay in cache
+	constexpr uint32_t ChunkSize = 1 << 16;
+	std::vector<float> values(ChunkSize);
+	std::vector<uint16_t> halves(ChunkSize);
+	uint64_t mismatchCount = 0;
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint64_t first = 0; first < (1ull << 32); first += ChunkSize)
+	{
+		for (uint32_t i = 0; i < ChunkSize; ++i)
+		{
+			values[i] = FromBits(static_cast<uint32_t>(first + i));
+		}
+
+		GG::FloatToHalf(values.data(), halves.data(), ChunkSize);
+		for (uint32_t i = 0; i < ChunkSize; ++i)
+		{
+			if (halves[i] == GG::FloatToHalf(values[i])) continue;
+
+			++mismatchCount;
+			GGTest::ReportFailure(__FILE__, __LINE__, "batch differs from scalar for float bits " + std::to_string(first + i));
+		}
+	}
+
+	std::cout << "  " << GG::GetHalfFloatInstructionSet() << " path checked against the scalar conversion for 2^32 values in "
+		<< GGTest::MillisecondsSince(start) / 1000.f << " s, " << mismatchCount << " mismatches\n";
+}
+
+GG_TEST(HalfFloatBenchmark, Benchmark)
+{
+	// HDR texel values, a 2048 x 2048 RGBA level
+	constexpr size_t ValueCount = 2048 * 2048 * 4;
+	std::vector<float> values(ValueCount);
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> texel(0.f, 16.f);
+	for (float& value : values)
+	{
+		value = texel(random);
+	}
+
+	std::vector<uint16_t> scalarHalves(ValueCount);
+	std::vector<uint16_t> batchHalves(ValueCount);
+	constexpr uint32_t Runs = 8;
+
+	const auto scalarStart = std::chrono::high_resolution_clock::now();
+	for (uint32_t run = 0; run < Runs; ++run)
+	{
+		for (size_t i = 0; i < ValueCount; ++i)
+		{
+			scalarHalves[i] = GG::FloatToHalf(values[i]);
+		}
+	}
+	const float scalarMs = GGTest::MillisecondsSince(scalarStart) / Runs;
+
+	const auto batchStart = std::chrono::high_resolution_clock::now();
+	for (uint32_t run = 0; run < Runs; ++run)
+	{
+		GG::FloatToHalf(values.data(), batchHalves.data(), ValueCount);
+	}
+	const float batchMs = GGTest::MillisecondsSince(batchStart) / Runs;
+
+	GG_CHECK(scalarHalves == batchHalves);
+	std::cout << "[HalfFloatBenchmark] " << ValueCount << " values, scalar loop " << scalarMs << " ms, "
+		<< GG::GetHalfFloatInstructionSet() << " batch " << batchMs << " ms (" << scalarMs / batchMs << "x)\n";
+}
@@ -0,0 +1,248 @@
+#include "GGTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+#include "GGMeshlet.h"
+#include "Model.h"
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<Vertex> Vertices;
+		std::vector<uint32_t> Indices;
+	};
+
+	// (cellsX + 1) * (cellsY + 1) vertices on z = height(x, y), triangles wound counter clockwise seen from +z
+	template <typename HeightFunction>
+	TestMesh MakeGrid(uint32_t cellsX, uint32_t cellsY, HeightFunction height)
+	{
+		TestMesh mesh;
+		mesh.Vertices.reserve(static_cast<size_t>(cellsX + 1) * (cellsY + 1));
+		for (uint32_t y = 0; y <= cellsY; ++y)
+		{
+			for (uint32_t x = 0; x <= cellsX; ++x)
+			{
+				Vertex vertex{};
+				vertex.pos = glm::vec3(static_cast<float>(x), static_cast<float>(y), height(static_cast<float>(x), static_cast<float>(y)));
+				mesh.Vertices.push_back(vertex);
+			}
+		}
+
+		mesh.Indices.reserve(static_cast<size_t>(cellsX) * cellsY * 6);
+		for (uint32_t y = 0; y < cellsY; ++y)
+		{
+			for (uint32_t x = 0; x < cellsX; ++x)
+			{
+				const uint32_t corner = y * (cellsX + 1) + x;
+				mesh.Indices.insert(mesh.Indices.end(), { corner, corner + 1, corner + cellsX + 2, corner, corner + cellsX + 2, corner + cellsX + 1 });
+			}
+		}
+		return mesh;
+	}
+
+	TestMesh MakeFlatGrid(uint32_t cellsX, uint32_t cellsY)
+	{
+		return MakeGrid(cellsX, cellsY, [](float, float) { return 0.f; });
+	}
+
+	// Every plane is (0, 0, 0, 1), so nothing is outside the frustum and only the cone test culls
+	GG::FrustumPlanes MakeOpenFrustum()
+	{
+		GG::FrustumPlanes planes;
+		planes.fill(glm::vec4(0.f, 0.f, 0.f, 1.f));
+		return planes;
+	}
+
+	glm::vec3 FaceNormal(const TestMesh& mesh, uint32_t firstIndex)
+	{
+		const glm::vec3& p0 = mesh.Vertices[mesh.Indices[firstIndex]].pos;
+		const glm::vec3& p1 = mesh.Vertices[mesh.Indices[firstIndex + 1]].pos;
+		const glm::vec3& p2 = mesh.Vertices[mesh.Indices[firstIndex + 2]].pos;
+		return glm::cross(p1 - p0, p2 - p0);
+	}
+
+	void CheckMeshletsCoverMesh(const TestMesh& mesh, const std::vector<GG::Meshlet>& meshlets)
+	{
+		uint32_t nextIndex = 0;
+		for (const GG::Meshlet& meshlet : meshlets)
+		{
+			GG_CHECK(meshlet.FirstIndex == nextIndex);
+			GG_CHECK(meshlet.TriangleCount > 0 && meshlet.TriangleCount <= GG::MeshletMaxTriangles);
+			GG_CHECK(meshlet.VertexCount <= GG::MeshletMaxVertices);
+			nextIndex += meshlet.TriangleCount * 3;
+
+			std::unordered_set<uint32_t> uniqueVertices;
+			for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.TriangleCount * 3; ++i)
+			{
+				uniqueVertices.insert(mesh.Indices[i]);
+
+				const glm::vec3& position = mesh.Vertices[mesh.Indices[i]].pos;
+				GG_CHECK(glm::all(glm::greaterThanEqual(position, meshlet.AabbMin)) && glm::all(glm::lessThanEqual(position, meshlet.AabbMax)));
+				GG_CHECK(glm::length(position - meshlet.Center) <= meshlet.Radius * 1.0001f + 1e-5f);
+			}
+			GG_CHECK(meshlet.VertexCount == uniqueVertices.size());
+		}
+		GG_CHECK(nextIndex == mesh.Indices.size());
+	}
+}
+
+GG_TEST(MeshletEmptyInput, Unit)
+{
+	const std::vector<Vertex> vertices(3);
+	GG_CHECK(GG::BuildMeshlets({}, vertices).empty());
+	GG_CHECK(GG::BuildMeshlets(std::vector<uint32_t>{ 0, 1, 2 }, {}).empty());
+}
+
+GG_TEST(MeshletLimitsAndBounds, Unit)
+{
+	const TestMesh mesh = MakeGrid(40, 30, [](float x, float y) { return std::sin(x * 0.3f) * std::cos(y * 0.2f) * 4.f; });
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+
+	GG_CHECK(meshlets.size() > 1);
+	CheckMeshletsCoverMesh(mesh, meshlets);
+
+	// Smaller limits than the defaults are respected too
+	const std::vector<GG::Meshlet> smallMeshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices, 16, 20);
+	for (const GG::Meshlet& meshlet : smallMeshlets)
+	{
+		GG_CHECK(meshlet.VertexCount <= 16 && meshlet.TriangleCount <= 20);
+	}
+}
+
+GG_TEST(MeshletRepeatedCornersCountOnce, Unit)
+{
+	// Degenerate triangles reference a vertex more than once, it still counts as one unique vertex
+	TestMesh mesh = MakeFlatGrid(2, 1);
+	mesh.Indices.insert(mesh.Indices.end(), { 0, 0, 1, 2, 2, 2 });
+
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	GG_CHECK(meshlets.size() == 1);
+	CheckMeshletsCoverMesh(mesh, meshlets);
+}
+
+GG_TEST(MeshletFlatConeCulling, Unit)
+{
+	const TestMesh mesh = MakeFlatGrid(4, 4);
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	GG_CHECK(meshlets.size() == 1);
+
+	const GG::Meshlet& meshlet = meshlets[0];
+	GG_CHECK(std::abs(meshlet.ConeAxis.z - 1.f) < 1e-5f);
+	GG_CHECK(meshlet.ConeCutoff < 1e-3f);
+
+	const GG::FrustumPlanes planes = MakeOpenFrustum();
+	GG_CHECK(GG::IsMeshletVisible(meshlet, planes, glm::vec3(2.f, 2.f, 10.f), true));
+	GG_CHECK(!GG::IsMeshletVisible(meshlet, planes, glm::vec3(2.f, 2.f, -10.f), true));
+	GG_CHECK(GG::IsMeshletVisible(meshlet, planes, glm::vec3(2.f, 2.f, -10.f), false));
+}
+
+GG_TEST(MeshletWideConeIsNeverCulled, Unit)
+{
+	// A closed box has normals in every direction, its cone test has to stay disabled
+	TestMesh mesh;
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		Vertex vertex{};
+		vertex.pos = glm::vec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+		mesh.Vertices.push_back(vertex);
+	}
+	mesh.Indices = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	GG_CHECK(meshlets.size() == 1);
+	GG_CHECK(meshlets[0].ConeAxis == glm::vec3(0.f));
+
+	const GG::FrustumPlanes planes = MakeOpenFrustum();
+	for (const glm::vec3 camera : { glm::vec3(5.f, 0.5f, 0.5f), glm::vec3(-5.f, 0.5f, 0.5f), glm::vec3(0.5f, 0.5f, -5.f) })
+	{
+		GG_CHECK(GG::IsMeshletVisible(meshlets[0], planes, camera, true));
+	}
+}
+
+GG_TEST(MeshletConeNeverCullsFrontFaces, Unit)
+{
+	const TestMesh mesh = MakeGrid(64, 64, [](float x, float y) { return std::sin(x * 0.5f) * std::cos(y * 0.4f) * 2.f; });
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	const GG::FrustumPlanes planes = MakeOpenFrustum();
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> coordinate(-100.f, 164.f);
+	uint32_t culledCount = 0;
+	for (uint32_t cameraIndex = 0; cameraIndex < 200; ++cameraIndex)
+	{
+		const glm::vec3 camera(coordinate(random), coordinate(random), coordinate(random) * 0.5f);
+		for (const GG::Meshlet& meshlet : meshlets)
+		{
+			if (GG::IsMeshletVisible(meshlet, planes, camera, true)) continue;
+
+			++culledCount;
+			for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.TriangleCount * 3; i += 3)
+			{
+				const glm::vec3& p0 = mesh.Vertices[mesh.Indices[i]].pos;
+				GG_CHECK(glm::dot(FaceNormal(mesh, i), camera - p0) <= 0.f);
+			}
+		}
+	}
+	GG_CHECK(culledCount > 0);
+}
+
+GG_TEST(MeshletFrustumPlanes, Unit)
+{
+	// The identity keeps clip space, the frustum is the box [-1, 1] x [-1, 1] x [0, 1]
+	const GG::FrustumPlanes planes = GG::ExtractFrustumPlanes(glm::mat4(1.f));
+	GG_CHECK(GG::IsSphereVisible(planes, glm::vec3(0.f, 0.f, 0.5f), 0.1f));
+	GG_CHECK(GG::IsSphereVisible(planes, glm::vec3(1.05f, 0.f, 0.5f), 0.1f));
+	GG_CHECK(!GG::IsSphereVisible(planes, glm::vec3(1.5f, 0.f, 0.5f), 0.1f));
+	GG_CHECK(!GG::IsSphereVisible(planes, glm::vec3(0.f, 0.f, -0.5f), 0.1f));
+	GG_CHECK(!GG::IsSphereVisible(planes, glm::vec3(0.f, 0.f, 1.5f), 0.1f));
+}
+
+GG_TEST(MeshletCullMergesNeighbours, Unit)
+{
+	const TestMesh mesh = MakeFlatGrid(32, 32);
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	const GG::FrustumPlanes planes = MakeOpenFrustum();
+
+	std::vector<GG::IndexRange> ranges;
+	GG_CHECK(GG::CullMeshlets(meshlets, planes, glm::vec3(16.f, 16.f, 10.f), true, ranges) == meshlets.size());
+	GG_CHECK(ranges.size() == 1);
+	GG_CHECK(ranges[0].FirstIndex == 0 && ranges[0].IndexCount == mesh.Indices.size());
+
+	ranges.clear();
+	GG_CHECK(GG::CullMeshlets(meshlets, planes, glm::vec3(16.f, 16.f, -100.f), true, ranges) == 0);
+	GG_CHECK(ranges.empty());
+}
+
+GG_TEST(MeshletBenchmark, Benchmark)
+{
+	// 1000 x 1000 cells, two million triangles
+	const TestMesh mesh = MakeGrid(1000, 1000, [](float x, float y) { return std::sin(x * 0.05f) * std::cos(y * 0.05f) * 20.f; });
+	const uint32_t triangleCount = static_cast<uint32_t>(mesh.Indices.size() / 3);
+
+	const auto buildStart = std::chrono::high_resolution_clock::now();
+	const std::vector<GG::Meshlet> meshlets = GG::BuildMeshlets(mesh.Indices, mesh.Vertices);
+	const float buildMs = GGTest::MillisecondsSince(buildStart);
+	CheckMeshletsCoverMesh(mesh, meshlets);
+
+	const GG::FrustumPlanes planes = GG::ExtractFrustumPlanes(glm::mat4(
+		glm::vec4(0.002f, 0.f, 0.f, 0.f), glm::vec4(0.f, 0.002f, 0.f, 0.f), glm::vec4(0.f, 0.f, 0.01f, 0.f), glm::vec4(-1.f, -1.f, 0.5f, 1.f)));
+	constexpr uint32_t CullRuns = 100;
+	std::vector<GG::IndexRange> ranges;
+	uint32_t visibleCount = 0;
+	const auto cullStart = std::chrono::high_resolution_clock::now();
+	for (uint32_t run = 0; run < CullRuns; ++run)
+	{
+		ranges.clear();
+		visibleCount = GG::CullMeshlets(meshlets, planes, glm::vec3(500.f, 500.f, 300.f + static_cast<float>(run)), true, ranges);
+	}
+	const float cullMs = GGTest::MillisecondsSince(cullStart) / CullRuns;
+
+	std::cout << "[MeshletBenchmark] " << triangleCount << " triangles into " << meshlets.size() << " meshlets in " << buildMs << " ms ("
+		<< static_cast<float>(triangleCount) / (buildMs * 1000.f) << " Mtri/s), cull " << cullMs << " ms with " << visibleCount << " visible in "
+		<< ranges.size() << " ranges\n";
+}
@@ -0,0 +1,97 @@
+#include "GGTest.h"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#include "GGSwizzle.h"
+
+namespace
+{
+	// What GetOrLoadTextureFromMemory did before the swizzle, one byte at a time
+	void SwizzleByteLoop(const uint8_t* bgra, uint8_t* rgba, size_t pixelCount)
+	{
+		for (size_t i = 0; i < pixelCount; ++i)
+		{
+			rgba[i * 4 + 0] = bgra[i * 4 + 2];
+			rgba[i * 4 + 1] = bgra[i * 4 + 1];
+			rgba[i * 4 + 2] = bgra[i * 4 + 0];
+			rgba[i * 4 + 3] = bgra[i * 4 + 3];
+		}
+	}
+
+	std::vector<uint8_t> MakeRandomPixels(size_t pixelCount, uint32_t seed)
+	{
+		std::vector<uint8_t> pixels(pixelCount * 4);
+		std::mt19937 random(seed);
+		for (uint8_t& byte : pixels)
+		{
+			byte = static_cast<uint8_t>(random());
+		}
+		return pixels;
+	}
+}
+
+GG_TEST(SwizzleMatchesByteLoop, Unit)
+{
+	std::cout << "  swizzle path: " << GG::GetSwizzleInstructionSet() << "\n";
+
+	// Every pixel count up to a few vector widths at every byte offset, so the vector loop and the tail both get every split
+	const std::vector<uint8_t> source = MakeRandomPixels(80, 3);
+	for (size_t offset = 0; offset < 16; ++offset)
+	{
+		for (size_t pixelCount = 0; pixelCount <= 67; ++pixelCount)
+		{
+			// One guard pixel past the end must stay untouched
+			std::vector<uint8_t> expected(pixelCount * 4 + 4 + offset, 0xCD);
+			std::vector<uint8_t> actual(expected);
+			SwizzleByteLoop(source.data() + offset, expected.data() + offset, pixelCount);
+			GG::SwizzleBgraToRgba(source.data() + offset, actual.data() + offset, pixelCount);
+			GG_CHECK(actual == expected);
+		}
+	}
+}
+
+GG_TEST(SwizzleInPlace, Unit)
+{
+	for (const size_t pixelCount : { size_t(1), size_t(15), size_t(16), size_t(17), size_t(1000) })
+	{
+		const std::vector<uint8_t> source = MakeRandomPixels(pixelCount, 5);
+		std::vector<uint8_t> expected(source.size());
+		SwizzleByteLoop(source.data(), expected.data(), pixelCount);
+
+		std::vector<uint8_t> pixels(source);
+		GG::SwizzleBgraToRgba(pixels.data(), pixels.data(), pixelCount);
+		GG_CHECK(pixels == expected);
+	}
+}
+
+GG_TEST(SwizzleBenchmark, Benchmark)
+{
+	// A cache resident 256 x 256 texture many times, then an 8192 x 8192 one that is bound by memory bandwidth
+	for (const auto& [size, runs] : { std::pair<size_t, uint32_t>(256, 2000), std::pair<size_t, uint32_t>(8192, 4) })
+	{
+		const size_t pixelCount = size * size;
+		const std::vector<uint8_t> source = MakeRandomPixels(pixelCount, 9);
+		std::vector<uint8_t> loopPixels(source.size(), 0);
+		std::vector<uint8_t> swizzlePixels(source.size(), 0);
+
+		const auto loopStart = std::chrono::high_resolution_clock::now();
+		for (uint32_t run = 0; run < runs; ++run)
+		{
+			SwizzleByteLoop(source.data(), loopPixels.data(), pixelCount);
+		}
+		const float loopMs = GGTest::MillisecondsSince(loopStart);
+
+		const auto swizzleStart = std::chrono::high_resolution_clock::now();
+		for (uint32_t run = 0; run < runs; ++run)
+		{
+			GG::SwizzleBgraToRgba(source.data(), swizzlePixels.data(), pixelCount);
+		}
+		const float swizzleMs = GGTest::MillisecondsSince(swizzleStart);
+
+		GG_CHECK(loopPixels == swizzlePixels);
+		std::cout << "[SwizzleBenchmark] " << size << "x" << size << " x " << runs << " runs, byte loop " << loopMs << " ms, "
+			<< GG::GetSwizzleInstructionSet() << " swizzle " << swizzleMs << " ms (" << loopMs / swizzleMs << "x)\n";
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal self registering test runner for the parts of the engine that run without a device.
+// Unit tests run by default, exhaustive checks and benchmarks are selected on the command line
+namespace GGTest
+{
+	enum class TestKind
+	{
+		Unit,
+		Exhaustive,
+		Benchmark
+	};
+
+	struct TestCase
+	{
+		const char* Name;
+		TestKind Kind;
+		void (*Run)();
+	};
+
+	std::vector<TestCase>& GetTests();
+	void ReportFailure(const char* file, int line, const std::string& message);
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestKind kind, void (*run)()) { GetTests().push_back({ name, kind, run }); }
+	};
+
+	inline float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+}
+
+#define GG_TEST(name, kind) \
+	static void name(); \
+	static const GGTest::Registrar name##Registrar(#name, GGTest::TestKind::kind, name); \
+	static void name()
+
+#define GG_CHECK(condition) \
+	do { if (!(condition)) GGTest::ReportFailure(__FILE__, __LINE__, #condition); } while (0)
@@ -0,0 +1,57 @@
+#include "GGTest.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	uint32_t g_FailureCount = 0;
+	constexpr uint32_t MaxReportedFailures = 32;
+}
+
+std::vector<GGTest::TestCase>& GGTest::GetTests()
+{
+	static std::vector<TestCase> tests;
+	return tests;
+}
+
+void GGTest::ReportFailure(const char* file, int line, const std::string& message)
+{
+	// An exhaustive check can fail billions of times, the first few say enough
+	if (g_FailureCount++ < MaxReportedFailures)
+	{
+		std::cerr << file << "(" << line << "): check failed: " << message << "\n";
+	}
+}
+
+// GGCoreTests [unit|exhaustive|benchmark] [test name]
+int main(int argc, char** argv)
+{
+	GGTest::TestKind kind = GGTest::TestKind::Unit;
+	if (argc > 1 && strcmp(argv[1], "exhaustive") == 0) kind = GGTest::TestKind::Exhaustive;
+	else if (argc > 1 && strcmp(argv[1], "benchmark") == 0) kind = GGTest::TestKind::Benchmark;
+	else if (argc > 1 && strcmp(argv[1], "unit") != 0)
+	{
+		std::cerr << "usage: " << argv[0] << " [unit|exhaustive|benchmark] [test name]\n";
+		return 2;
+	}
+	const char* filter = argc > 2 ? argv[2] : nullptr;
+
+	uint32_t runCount = 0;
+	uint32_t failedCount = 0;
+	for (const GGTest::TestCase& test : GGTest::GetTests())
+	{
+		if (test.Kind != kind || (filter && strcmp(filter, test.Name) != 0)) continue;
+
+		const uint32_t failuresBefore = g_FailureCount;
+		test.Run();
+		++runCount;
+
+		const bool isPassed = g_FailureCount == failuresBefore;
+		failedCount += isPassed ? 0 : 1;
+		std::cout << (isPassed ? "[  OK  ] " : "[ FAIL ] ") << test.Name << "\n";
+	}
+
+	std::cout << runCount - failedCount << " of " << runCount << " tests passed\n";
+	return failedCount == 0 && runCount > 0 ? 0 : 1;
+}